@@ -0,0 +1,515 @@
+#include "Read.h"
+#include "Search.h"
+#include "Statistics.h"
+#include "QueryEngine.h"
+#include "FlightDelta.h"
+#include "Haversine.h"
+#include "Json.h"
+#include "Instrumentation.h"
+#include "MemoryReport.h"
+#include "TimetableGenerator.h"
+#include "ContractionHierarchy.h"
+#include "HopLabels.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <new>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <unordered_set>
+#include <sys/resource.h>
+
+/*
+ * Repeatable benchmarks of every phase: CSV load, graph build, searches, statistics, delta ingestion and Haversine.
+ *
+ * Usage: flight_bench [--dataset DIR] [--iterations N] [--pairs N] [--output FILE] [--filter TEXT]
+ *        flight_bench [--dataset DIR] --leak-check CYCLES
+ */
+
+// Every allocation made through operator new is counted, so each benchmark can report its allocations.
+// With the instrumentation compiled in, it already replaces operator new and counts them.
+#ifdef FLIGHT_INSTRUMENTATION
+static long allocationCount() {
+    return (long) Instrumentation::total(Instrumentation::Counter::Allocations);
+}
+
+static long allocationBytes() {
+    return (long) Instrumentation::total(Instrumentation::Counter::AllocatedBytes);
+}
+#else
+static std::atomic<long> totalAllocations(0);
+static std::atomic<long> totalAllocatedBytes(0);
+
+void* operator new(std::size_t size) {
+    totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    totalAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+static long allocationCount() {
+    return totalAllocations.load();
+}
+
+static long allocationBytes() {
+    return totalAllocatedBytes.load();
+}
+#endif
+
+/**
+ * @brief Gets the peak resident set size of the process.
+ * @return Peak RSS in kilobytes.
+ */
+static long peakRssKb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+struct BenchOptions {
+    std::string dataset = "../dataset/";
+    std::string output = "bench_results.json";
+    std::string filter;
+    int iterations = 15;
+    int pairs = 200;
+    int leakCycles = 0;  // with --leak-check, only load/unload cycles run
+};
+
+class Bench {
+public:
+    explicit Bench(const BenchOptions& options) : options(options) {}
+
+    /**
+     * @brief Times a benchmark: setup() runs untimed before every iteration, fn() is timed.
+     * @param name Benchmark name.
+     * @param iterations Number of timed iterations.
+     * @param setup Untimed preparation for each iteration.
+     * @param fn The code to time.
+     */
+    void run(const std::string& name, int iterations, const std::function<void()>& setup, const std::function<void()>& fn) {
+        if (!options.filter.empty() && name.find(options.filter) == std::string::npos) return;
+
+        std::vector<double> samples;
+        long allocations = 0, bytes = 0;
+        for (int i = 0; i < iterations; i++) {
+            setup();
+            long countBefore = allocationCount(), bytesBefore = allocationBytes();
+            auto start = std::chrono::steady_clock::now();
+            fn();
+            auto end = std::chrono::steady_clock::now();
+            allocations += allocationCount() - countBefore;
+            bytes += allocationBytes() - bytesBefore;
+            samples.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+        }
+        std::sort(samples.begin(), samples.end());
+        double median = samples[samples.size() / 2];
+        double p99 = samples[std::min(samples.size() - 1, (size_t) (samples.size() * 0.99))];
+
+        std::cout << name << ": median " << median << " us, p99 " << p99 << " us, "
+                  << allocations / iterations << " allocations/iteration" << std::endl;
+        results.pushRaw(JsonObject()
+                                .add("name", name)
+                                .add("iterations", iterations)
+                                .add("median_us", median)
+                                .add("p99_us", p99)
+                                .add("min_us", samples.front())
+                                .add("max_us", samples.back())
+                                .add("allocations_per_iteration", allocations / iterations)
+                                .add("allocated_bytes_per_iteration", bytes / iterations)
+                                .add("peak_rss_kb", peakRssKb())
+                                .str());
+    }
+
+    void run(const std::string& name, int iterations, const std::function<void()>& fn) {
+        run(name, iterations, []() {}, fn);
+    }
+
+    void setMemoryReport(const MemoryReport& report) {
+        memory = report.toJson();
+    }
+
+    /**
+     * @brief Writes every result to the output file.
+     */
+    void write() const {
+        std::ofstream out(options.output);
+        out << JsonObject()
+                .add("dataset", options.dataset)
+                .add("iterations", options.iterations)
+                .add("pairs", options.pairs)
+                .add("peak_rss_kb", peakRssKb())
+                .addRaw("benchmarks", results.str())
+                .addRaw("memory", memory)
+                .addRaw("instrumentation", Instrumentation::toJson())
+                .str() << std::endl;
+        std::cout << "Results written to " << options.output << std::endl;
+    }
+
+private:
+    BenchOptions options;
+    JsonArray results;
+    std::string memory = "null";  // bytes per component of the loaded dataset
+};
+
+static BenchOptions parseOptions(int argc, char* argv[]) {
+    BenchOptions options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i], value = argv[i + 1];
+        if (flag == "--dataset") options.dataset = value.back() == '/' ? value : value + "/";
+        else if (flag == "--output") options.output = value;
+        else if (flag == "--filter") options.filter = value;
+        else if (flag == "--iterations") options.iterations = std::max(1, std::atoi(value.c_str()));
+        else if (flag == "--pairs") options.pairs = std::max(1, std::atoi(value.c_str()));
+        else if (flag == "--leak-check") options.leakCycles = std::max(1, std::atoi(value.c_str()));
+        else std::cerr << "Unknown option " << flag << std::endl;
+    }
+    return options;
+}
+
+/**
+ * @brief Checks that a graph gives back all of its memory over repeated load/unload cycles.
+ *
+ * Every cycle loads the airports and flights into the same graph. Odd cycles then remove the airports one by
+ * one, which returns every block to the arena, so every GraphMemory account must read 0 before clear();
+ * even cycles clear() straight away. After clear() the arena must hold no chunks and no bytes. Peak RSS,
+ * measured after the first cycle, must stay within 5% (at least 2 MB) of that until the last one.
+ * @param options Dataset directory and number of cycles.
+ * @return 0 if every check held, 1 otherwise.
+ * @note Build with -DFLIGHT_SANITIZE=ON to also have AddressSanitizer report the leaks outside the arena; it holds
+ *       on to freed memory for a while to catch uses after free, so the RSS check is skipped then.
+ */
+static int checkLeaks(const BenchOptions& options) {
+    static const char* accountNames[] = {"vertices", "edges", "incoming", "flights", "airline counts"};
+    Read reader;
+    Graph<Airport> graph;
+    long baselineKb = 0;
+    int failures = 0;
+    for (int cycle = 1; cycle <= options.leakCycles; cycle++) {
+        reader.readAirports(graph, options.dataset + "airports.csv");
+        reader.readFlights(graph, options.dataset + "flights.csv");
+        if (graph.getNumVertex() == 0) {
+            std::cerr << "No airports found in " << options.dataset << std::endl;
+            return 1;
+        }
+        if (cycle % 2 == 1) {
+            std::vector<Airport> airports;
+            for (const auto* vertex : graph.getVertexSet()) airports.push_back(vertex->getInfo());
+            for (const auto& airport : airports) graph.removeVertex(airport);
+            for (int account = 0; account < (int) GraphMemory::Count; account++) {
+                size_t bytes = graph.getArena().getBytesInUse(account);
+                if (bytes != 0) {
+                    std::cerr << "Cycle " << cycle << ": " << bytes << " bytes of " << accountNames[account]
+                              << " still in use after removing every airport" << std::endl;
+                    failures++;
+                }
+            }
+            if (graph.getNumFlights() != 0) {
+                std::cerr << "Cycle " << cycle << ": " << graph.getNumFlights() << " flights left after removing every airport" << std::endl;
+                failures++;
+            }
+        }
+        graph.clear();
+        if (graph.getArena().getBytesInUse() != 0 || graph.getArena().getNumChunks() != 0) {
+            std::cerr << "Cycle " << cycle << ": the arena still holds " << graph.getArena().getBytesInUse() << " bytes in "
+                      << graph.getArena().getNumChunks() << " chunks after clear()" << std::endl;
+            failures++;
+        }
+        if (cycle == 1) baselineKb = peakRssKb();
+    }
+    long finalKb = peakRssKb();
+    std::cout << options.leakCycles << " load/unload cycles: peak RSS " << baselineKb << " KB after the first, "
+              << finalKb << " KB after the last" << std::endl;
+#ifndef FLIGHT_SANITIZE
+    long allowedKb = std::max(2048L, baselineKb / 20);
+    if (finalKb - baselineKb > allowedKb) {
+        std::cerr << "Peak RSS grew by " << finalKb - baselineKb << " KB (allowed " << allowedKb << " KB)" << std::endl;
+        failures++;
+    }
+#endif
+    std::cout << (failures == 0 ? "No leaks found" : "Leak check failed") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options = parseOptions(argc, argv);
+    if (options.leakCycles > 0) return checkLeaks(options);
+    Bench bench(options);
+    Read reader;
+    const std::string airportsFile = options.dataset + "airports.csv";
+    const std::string airlinesFile = options.dataset + "airlines.csv";
+    const std::string flightsFile = options.dataset + "flights.csv";
+    int iterations = options.iterations;
+
+    // CSV load, per file
+    std::unique_ptr<Graph<Airport>> scratch;
+    bench.run("load/airports", iterations, [&]() { scratch.reset(new Graph<Airport>()); },
+              [&]() { reader.readAirports(*scratch, airportsFile); });
+    bench.run("load/airlines", iterations, [&]() {
+        std::unordered_set<Airline> airlines;
+        reader.readAirlines(airlines, airlinesFile);
+    });
+    bench.run("load/flights", iterations, [&]() {
+        scratch.reset(new Graph<Airport>());
+        reader.readAirports(*scratch, airportsFile);
+    }, [&]() { reader.readFlights(*scratch, flightsFile); });
+    scratch.reset();
+    // A whole graph loaded and destroyed: with the graph's arena freed at once, peak RSS stays flat across iterations
+    bench.run("load/load_unload", iterations, [&]() {
+        Graph<Airport> cycle;
+        reader.readAirports(cycle, airportsFile);
+        reader.readFlights(cycle, flightsFile);
+    });
+
+    Graph<Airport> graph;
+    std::unordered_set<Airline> airlines;
+    reader.readAirports(graph, airportsFile);
+    reader.readAirlines(airlines, airlinesFile);
+    reader.readFlights(graph, flightsFile);
+    // Pairs, keystrokes and deltas are drawn from the airports and flights, so both must be there
+    if (graph.getNumVertex() == 0 || graph.getNumFlights() == 0) {
+        std::cerr << "No airports or no flights found in " << options.dataset << std::endl;
+        return 1;
+    }
+
+    // Graph build from rows already in memory, without the CSV parsing
+    std::vector<Airport> airportRows;
+    std::vector<Flight> flightRows;
+    for (const auto* vertex : graph.getVertexSet()) {
+        airportRows.push_back(vertex->getInfo());
+        for (const auto& edge : vertex->getAdj()) {
+            flightRows.insert(flightRows.end(), edge.getFlights().begin(), edge.getFlights().end());
+        }
+    }
+    bench.run("build/graph", iterations, [&]() { scratch.reset(new Graph<Airport>()); }, [&]() {
+        for (const auto& airport : airportRows) scratch->addVertex(airport);
+        for (const auto& flight : flightRows) scratch->addFlight(Airport(flight.getSource()), Airport(flight.getTarget()), flight);
+    });
+    bench.run("build/condensation", iterations, [&]() { Condensation condensation(graph); });
+    scratch.reset();
+
+    // Searches on random origin-destination pairs, the same for every run
+    std::mt19937 random(12345);
+    std::vector<std::pair<std::string, std::string>> pairs;
+    for (int i = 0; i < options.pairs; i++) {
+        pairs.push_back({airportRows[random() % airportRows.size()].getCode(),
+                         airportRows[random() % airportRows.size()].getCode()});
+    }
+    // Every index is built once per dataset; Search and Statistics are views over them
+    bench.run("engine/construct", iterations, [&]() { QueryEngine fresh(graph, airlines); });
+    QueryEngine engine(graph, airlines);
+    bench.run("engine/memory_report", iterations, [&]() { engine.memoryReport(); });
+    Search search(engine);
+    bench.run("search/construct", iterations, [&]() { Search fresh(engine); });
+
+    // Fewest stops: labelling, then the labels' distance queries against a plain BFS on the same pairs.
+    // The engine's own labels are built before search/best_flight, which then only measures queries
+    const DenseGraph& dense = engine.getDenseGraph();
+    std::vector<int> pairIds;
+    for (const auto& pair : pairs) {
+        pairIds.push_back(graph.findVertex(Airport(pair.first))->getId());
+        pairIds.push_back(graph.findVertex(Airport(pair.second))->getId());
+    }
+    bench.run("hop_labels/build", std::min(iterations, 3), [&]() { HopLabels fresh(dense); });
+    const HopLabels& labels = engine.getHopLabels();
+    bench.setMemoryReport(engine.memoryReport());
+    bench.run("hop_labels/distance", iterations, [&]() {
+        for (size_t i = 0; i < pairIds.size(); i += 2) labels.distance(pairIds[i], pairIds[i + 1]);
+    });
+    bench.run("hop_labels/bfs_baseline", iterations, [&]() {
+        std::vector<int> depth(dense.getNumVertices());
+        std::vector<int> queue;
+        for (size_t i = 0; i < pairIds.size(); i += 2) {
+            std::fill(depth.begin(), depth.end(), -1);
+            queue.assign(1, pairIds[i]);
+            depth[pairIds[i]] = 0;
+            for (size_t head = 0; head < queue.size() && depth[pairIds[i + 1]] < 0; head++) {
+                int v = queue[head];
+                for (int e = dense.offsets[v]; e < dense.offsets[v + 1]; e++) {
+                    if (depth[dense.targets[e]] < 0) {
+                        depth[dense.targets[e]] = depth[v] + 1;
+                        queue.push_back(dense.targets[e]);
+                    }
+                }
+            }
+        }
+    });
+    bench.run("search/best_flight", iterations, [&]() {
+        for (const auto& pair : pairs) search.findBestFlight(pair.first, pair.second);
+    });
+    bench.run("search/filtered", iterations, [&]() {
+        for (const auto& pair : pairs) search.findBestFlight(pair.first, pair.second, {}, true);
+    });
+    // Type-ahead: airport names typed one character at a time, every other one with a typo in the third character
+    std::vector<std::string> keystrokes;
+    for (int i = 0; i < options.pairs; i++) {
+        std::string name = airportRows[random() % airportRows.size()].getName();
+        if (i % 2 == 1 && name.size() > 3) name[2] = name[2] == 'x' ? 'y' : 'x';
+        for (size_t length = 1; length <= std::min<size_t>(name.size(), 12); length++) keystrokes.push_back(name.substr(0, length));
+    }
+    bench.run("search/suggest_keystrokes", iterations, [&]() {
+        for (const auto& text : keystrokes) search.suggest(text, 10);
+    });
+
+    // Kilometre-optimal routes: contraction, then the hierarchy's queries against a plain Dijkstra on the same pairs
+    // Contraction takes minutes from 10x on, so it runs once and the result is kept for the queries
+    std::unique_ptr<ContractionHierarchy> hierarchy;
+    bench.run("hierarchy/contract", 1, [&]() { hierarchy.reset(new ContractionHierarchy(dense)); });
+    bench.run("hierarchy/query", iterations, [&]() {
+        for (size_t i = 0; i < pairIds.size(); i += 2) hierarchy->shortestRoute({pairIds[i]}, {pairIds[i + 1]});
+    });
+    bench.run("hierarchy/dijkstra_baseline", iterations, [&]() {
+        std::vector<double> dist(dense.getNumVertices());
+        std::priority_queue<std::pair<double, int>, std::vector<std::pair<double, int>>, std::greater<std::pair<double, int>>> queue;
+        for (size_t i = 0; i < pairIds.size(); i += 2) {
+            std::fill(dist.begin(), dist.end(), std::numeric_limits<double>::infinity());
+            dist[pairIds[i]] = 0;
+            queue.push({0, pairIds[i]});
+            while (!queue.empty()) {
+                auto top = queue.top();
+                queue.pop();
+                if (top.second == pairIds[i + 1]) break;
+                if (top.first > dist[top.second]) continue;
+                const Airport& from = dense.vertices[top.second]->getInfo();
+                for (int e = dense.offsets[top.second]; e < dense.offsets[top.second + 1]; e++) {
+                    int to = dense.targets[e];
+                    double candidate = top.first + ContractionHierarchy::routeLength(from, dense.vertices[to]->getInfo());
+                    if (candidate < dist[to]) {
+                        dist[to] = candidate;
+                        queue.push({candidate, to});
+                    }
+                }
+            }
+            queue = decltype(queue)();
+        }
+    });
+
+    // Timetable queries on two generated days of departures, leaving at 08:00 on the first
+    TimetableGenerator generator(2, 42);
+    bench.run("timetable/generate", std::min(iterations, 3), [&]() {
+        Timetable fresh(graph);
+        generator.generate(graph, fresh);
+    });
+    generator.generate(graph, engine.getTimetable());
+    bench.run("timetable/earliest_arrival", iterations, [&]() {
+        for (const auto& pair : pairs) search.findEarliestArrival(pair.first, pair.second, 8 * 60);
+    });
+    // A day of departures per pair is a much longer scan, so a tenth of the pairs
+    std::vector<std::pair<std::string, std::string>> profilePairs(pairs.begin(), pairs.begin() + (pairs.size() + 9) / 10);
+    bench.run("timetable/profile", iterations, [&]() {
+        for (const auto& pair : profilePairs) search.findJourneys(pair.first, pair.second, 0, 24 * 60 - 1);
+    });
+
+    // Statistics
+    // Per-airport queries use the busiest airport, so they are meaningful on generated datasets too
+    const Vertex<Airport>* busiest = graph.getVertexSet().front();
+    for (const auto* vertex : graph.getVertexSet()) {
+        if (vertex->getOutFlights() > busiest->getOutFlights()) busiest = vertex;
+    }
+    const std::string airport = busiest->getInfo().getCode(), city = busiest->getInfo().getCity();
+    const std::string country = busiest->getInfo().getCountry();
+    int maxStops = 3;
+    bench.run("statistics/construct", iterations, [&]() { Statistics fresh(engine); });
+    Statistics statistics(engine);
+    bench.run("statistics/total_airports", iterations, [&]() { statistics.getTotalNumberOfAirports(); });
+    bench.run("statistics/total_flights", iterations, [&]() { statistics.getTotalNumberOfFlights(); });
+    bench.run("statistics/flights_from_airport", iterations, [&]() { statistics.getNumberOfFlightsFromAirport(airport); });
+    bench.run("statistics/unique_airlines_from_airport", iterations, [&]() { statistics.getNumberOfUniqueAirlinesFromAirport(airport); });
+    bench.run("statistics/flights_per_city_airline", iterations, [&]() { statistics.getNumberOfFlightsPerCityAirline(); });
+    bench.run("statistics/flights_per_city", iterations, [&]() { statistics.getNumberOfFlightsPerCity(); });
+    bench.run("statistics/flights_per_airline", iterations, [&]() { statistics.getNumberOfFlightsPerAirline(); });
+    bench.run("statistics/flights_per_country_airline", iterations, [&]() { statistics.getNumberOfFlightsPerCountryAirline(); });
+    bench.run("statistics/flights_per_distance", iterations, [&]() { statistics.getNumberOfFlightsPerDistance(500); });
+    bench.run("statistics/countries_by_airport", iterations, [&]() { statistics.getNumberOfDiffCountriesByAirport(airport); });
+    bench.run("statistics/countries_by_city", iterations, [&]() { statistics.getNumberOfDiffCountriesByCity(city); });
+    bench.run("statistics/countries_from_country", iterations, [&]() { statistics.getCountriesReachableFromCountry(country); });
+    bench.run("statistics/reachable_airports", iterations, [&]() { statistics.getReachableAirports(airport, maxStops); });
+    bench.run("statistics/reachable_cities", iterations, [&]() { statistics.getReachableCities(airport, maxStops); });
+    bench.run("statistics/reachable_countries", iterations, [&]() { statistics.getReachableCountries(airport, maxStops); });
+    bench.run("statistics/airports_reaching", iterations, [&]() { statistics.getAirportsReaching(airport, maxStops); });
+    bench.run("statistics/longest_path", std::min(iterations, 3), [&]() { statistics.findLongestPath(); });
+    bench.run("statistics/top_k_by_flights", iterations, [&]() { statistics.getTopKAirportsByFlights(10); });
+    bench.run("statistics/top_k_by_reach", std::min(iterations, 3), [&]() { statistics.getTopKAirports(RankingMetric::ReachWithinStops, 10, 2); });
+    bench.run("statistics/essential_airports", iterations, [&]() { statistics.findEssentialAirports(); });
+    bench.run("statistics/component_sizes", iterations, [&]() { statistics.getComponentSizes(); });
+    bench.run("statistics/compute_all", iterations, [&]() { statistics.computeAll(1); });
+    bench.run("statistics/reach_sketches", std::min(iterations, 3), [&]() { statistics.estimateReach(maxStops); });
+    bench.run("statistics/betweenness_sampled", std::min(iterations, 3), [&]() { statistics.getTopKAirportsByBetweenness(10, 100); });
+    bench.run("statistics/pagerank", iterations, [&]() { statistics.getTopKAirportsByPageRank(10); });
+    bench.run("statistics/related_destinations", iterations, [&]() { statistics.getRelatedDestinations(airport, 10); });
+
+    // Delta ingestion: 1% of the flights changed (half removed, half new ones between random airports),
+    // applied to the graph and every index, against reloading and reindexing the whole dataset.
+    // Every change takes effect: the removals are distinct flights and the additions are absent from the graph,
+    // so the inverse delta puts the graph back exactly as it was
+    std::vector<FlightChange> delta, inverse;
+    size_t deltaSize = std::max<size_t>(2, flightRows.size() / 100);
+    std::unordered_set<Flight> present(flightRows.begin(), flightRows.end()), removed, added;
+    for (size_t i = 0, attempts = 0; i < deltaSize && attempts < 100 * deltaSize; attempts++) {
+        const Flight& existing = flightRows[random() % flightRows.size()];
+        if (i % 2 == 0) {
+            if (!removed.insert(existing).second) continue;
+            delta.push_back({true, existing});
+        } else {
+            Flight flight(airportRows[random() % airportRows.size()].getCode(),
+                          airportRows[random() % airportRows.size()].getCode(), existing.getAirline());
+            if (flight.getSource() == flight.getTarget() || present.count(flight) || !added.insert(flight).second) continue;
+            delta.push_back({false, flight});
+        }
+        i++;
+    }
+    for (auto it = delta.rbegin(); it != delta.rend(); it++) inverse.push_back({!it->removal, it->flight});
+    bool deltaApplied = false;
+    bench.run("delta/apply_1pct", iterations, [&]() {
+        if (deltaApplied) FlightDelta::apply(graph, inverse, &engine);
+    }, [&]() {
+        FlightDelta::apply(graph, delta, &engine);
+        deltaApplied = true;
+    });
+    if (deltaApplied) FlightDelta::apply(graph, inverse, &engine);
+    bench.run("delta/full_reload", std::min(iterations, 5), [&]() {
+        Graph<Airport> reloaded;
+        std::unordered_set<Airline> reloadedAirlines;
+        reader.readAirports(reloaded, airportsFile);
+        reader.readAirlines(reloadedAirlines, airlinesFile);
+        reader.readFlights(reloaded, flightsFile);
+        QueryEngine reloadedEngine(reloaded, reloadedAirlines);
+    });
+
+    // Haversine
+    std::vector<double> coordinates;
+    for (const auto& row : airportRows) {
+        coordinates.push_back(row.getLatitude());
+        coordinates.push_back(row.getLongitude());
+    }
+    volatile double sink = 0;
+    bench.run("haversine/1M", iterations, [&]() {
+        double total = 0;
+        size_t n = coordinates.size() / 2;
+        for (size_t i = 0; i < 1000000; i++) {
+            size_t a = i % n, b = (i * 7919) % n;
+            total += Haversine::haversineDistance(coordinates[2 * a], coordinates[2 * a + 1], coordinates[2 * b], coordinates[2 * b + 1]);
+        }
+        sink = total;
+    });
+
+    bench.write();
+    return 0;
+}
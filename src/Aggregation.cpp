@@ -0,0 +1,99 @@
+#include "Aggregation.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+// Largest number of groups accumulated in a dense array for a two-key group-by
+constexpr size_t MAX_DENSE_GROUPS = 1 << 24;
+
+/**
+ * @brief Counts the rows of each group of a key column.
+ * @param key Key column.
+ * @param cardinality Number of distinct keys.
+ * @return A vector indexed by key with the number of rows in each group.
+ * @note Time complexity: O(N + K) where N is the number of rows and K the cardinality.
+ */
+std::vector<long> Aggregation::countBy(const std::vector<int>& key, size_t cardinality) {
+    std::vector<long> counts(cardinality, 0);
+    for (int k : key) {
+        counts[k]++;
+    }
+    return counts;
+}
+
+/**
+ * @brief Sums a value column over the groups of a key column.
+ * @param key Key column.
+ * @param cardinality Number of distinct keys.
+ * @param values Value column, with the same number of rows as the key.
+ * @return A vector indexed by key with the sum of the values in each group.
+ * @note Time complexity: O(N + K) where N is the number of rows and K the cardinality.
+ */
+std::vector<double> Aggregation::sumBy(const std::vector<int>& key, size_t cardinality, const std::vector<double>& values) {
+    std::vector<double> sums(cardinality, 0.0);
+    for (size_t i = 0; i < key.size(); i++) {
+        sums[key[i]] += values[i];
+    }
+    return sums;
+}
+
+/**
+ * @brief Counts the rows of each group of a pair of key columns.
+ *
+ * Uses a dense array over every combination of keys when it is small enough,
+ * and sorts the combined keys otherwise.
+ *
+ * @param first First key column.
+ * @param firstCardinality Number of distinct first keys.
+ * @param second Second key column.
+ * @param secondCardinality Number of distinct second keys.
+ * @return The non-empty groups, ordered by first and then second key.
+ * @note Time complexity: O(N + K1 * K2) with a dense array, O(N log N) otherwise.
+ */
+std::vector<Aggregation::PairCount> Aggregation::countBy(const std::vector<int>& first, size_t firstCardinality,
+                                                         const std::vector<int>& second, size_t secondCardinality) {
+    std::vector<PairCount> groups;
+
+    if (firstCardinality * secondCardinality <= MAX_DENSE_GROUPS) {
+        std::vector<long> counts(firstCardinality * secondCardinality, 0);
+        for (size_t i = 0; i < first.size(); i++) {
+            counts[first[i] * secondCardinality + second[i]]++;
+        }
+        for (size_t k = 0; k < counts.size(); k++) {
+            if (counts[k]) {
+                groups.push_back({(int) (k / secondCardinality), (int) (k % secondCardinality), counts[k]});
+            }
+        }
+        return groups;
+    }
+
+    std::vector<uint64_t> keys(first.size());
+    for (size_t i = 0; i < first.size(); i++) {
+        keys[i] = ((uint64_t) first[i] << 32) | (uint32_t) second[i];
+    }
+    std::sort(keys.begin(), keys.end());
+    for (size_t i = 0; i < keys.size();) {
+        size_t j = i;
+        while (j < keys.size() && keys[j] == keys[i]) j++;
+        groups.push_back({(int) (keys[i] >> 32), (int) (keys[i] & 0xffffffffu), (long) (j - i)});
+        i = j;
+    }
+    return groups;
+}
+
+/**
+ * @brief Turns a value column into a key column of fixed-width buckets.
+ * @param values Value column (non-negative).
+ * @param width Bucket width.
+ * @return A key column where bucket b holds the values in [b * width, (b + 1) * width); values too large for an
+ *         int go to the last bucket it can hold, and negative ones (or NaN) to bucket 0.
+ * @note Time complexity: O(N) where N is the number of rows.
+ */
+std::vector<int> Aggregation::bucketize(const std::vector<double>& values, double width) {
+    std::vector<int> buckets(values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        double bucket = values[i] / width;
+        buckets[i] = bucket >= 1 ? (int) std::min(bucket, (double) std::numeric_limits<int>::max()) : 0;
+    }
+    return buckets;
+}
@@ -0,0 +1,28 @@
+#ifndef AGGREGATION_H
+#define AGGREGATION_H
+
+#include <vector>
+#include <cstddef>
+
+/**
+ * @brief Group-by/count/sum over the integer key columns of a columnar table.
+ *
+ * Keys are dense ids in [0, cardinality), so groups are accumulated in plain arrays
+ * indexed by key instead of maps.
+ */
+class Aggregation {
+public:
+    struct PairCount {
+        int first;
+        int second;
+        long count;
+    };
+
+    static std::vector<long> countBy(const std::vector<int>& key, size_t cardinality);
+    static std::vector<double> sumBy(const std::vector<int>& key, size_t cardinality, const std::vector<double>& values);
+    static std::vector<PairCount> countBy(const std::vector<int>& first, size_t firstCardinality,
+                                          const std::vector<int>& second, size_t secondCardinality);
+    static std::vector<int> bucketize(const std::vector<double>& values, double width);
+};
+
+#endif // AGGREGATION_H
@@ -1,4 +1,5 @@
 #include "Airline.h"
+#include "MemoryReport.h"
 
 // Constructor
 Airline::Airline(const std::string &code, const std::string &name, const std::string &callsign, const std::string &country)
@@ -37,3 +38,9 @@ void Airline::setCallsign(const std::string &callsign) {
 void Airline::setCountry(const std::string &country) {
     m_country = country;
 }
+
+// Heap bytes of the strings, none for those that fit in their inline buffers
+size_t Airline::getHeapBytes() const {
+    return MemoryReport::bytesOf(m_code) + MemoryReport::bytesOf(m_name) + MemoryReport::bytesOf(m_callsign)
+           + MemoryReport::bytesOf(m_country);
+}
@@ -21,6 +21,8 @@ public:
     void setCallsign(const std::string &callsign);
     void setCountry(const std::string &country);
 
+    size_t getHeapBytes() const;
+
     bool operator<(const Airline& other) const {
         return m_code < other.m_code;  // Compare based on airline code
     }
@@ -1,28 +1,65 @@
 #include "Airport.h"
+#include "StringPool.h"
 
 // Constructor for search purposes
-Airport::Airport(const std::string& code) : m_code(code) {}
+Airport::Airport(const std::string& code) : m_code(packCode(code)) {}
 
 // Constructor
 Airport::Airport(const std::string &code, const std::string &name, const std::string &city,
                  const std::string &country, double latitude, double longitude)
-        : m_code(code), m_name(name), m_city(city), m_country(country),
+        : m_code(packCode(code)), m_name(StringPool::global().intern(name)),
+          m_city(StringPool::global().intern(city)), m_country(StringPool::global().intern(country)),
           m_latitude(latitude), m_longitude(longitude) {}
 
+/**
+ * @brief Packs a code into an integer, one character per byte from the highest, so that integer
+ *        order is the alphabetical order of the codes.
+ * @param code The code.
+ * @return The packed code, or InvalidCode if it is longer than MaxCodeLength.
+ * @note Time complexity: O(1)
+ */
+uint64_t Airport::packCode(const std::string& code) {
+    if (code.size() > MaxCodeLength) return InvalidCode;
+    uint64_t packed = 0;
+    for (size_t i = 0; i < MaxCodeLength; i++) {
+        packed = (packed << 8) | (i < code.size() ? (unsigned char) code[i] : 0);
+    }
+    return packed;
+}
+
 // Getters
 std::string Airport::getCode() const {
+    std::string code;
+    if (m_code == InvalidCode) return code;
+    for (int shift = 8 * (MaxCodeLength - 1); shift >= 0; shift -= 8) {
+        char c = (char) (m_code >> shift);
+        if (c == 0) break;
+        code += c;
+    }
+    return code;
+}
+
+uint64_t Airport::getCodeKey() const {
     return m_code;
 }
 
-std::string Airport::getName() const {
-    return m_name;
+const std::string& Airport::getName() const {
+    return StringPool::global().get(m_name);
+}
+
+const std::string& Airport::getCity() const {
+    return StringPool::global().get(m_city);
+}
+
+const std::string& Airport::getCountry() const {
+    return StringPool::global().get(m_country);
 }
 
-std::string Airport::getCity() const {
+uint32_t Airport::getCityId() const {
     return m_city;
 }
 
-std::string Airport::getCountry() const {
+uint32_t Airport::getCountryId() const {
     return m_country;
 }
 
@@ -36,19 +73,19 @@ double Airport::getLongitude() const {
 
 // Setters
 void Airport::setCode(const std::string &code) {
-    m_code = code;
+    m_code = packCode(code);
 }
 
 void Airport::setName(const std::string &name) {
-    m_name = name;
+    m_name = StringPool::global().intern(name);
 }
 
 void Airport::setCity(const std::string &city) {
-    m_city = city;
+    m_city = StringPool::global().intern(city);
 }
 
 void Airport::setCountry(const std::string &country) {
-    m_country = country;
+    m_country = StringPool::global().intern(country);
 }
 
 void Airport::setLatitude(double latitude) {
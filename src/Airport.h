@@ -2,9 +2,22 @@
 #define AIRPORT_H
 
 #include <string>
+#include <cstdint>
+#include <functional>
 
+/**
+ * @brief An airport, in 40 bytes: the code packed into an integer, the ids of its name, city and
+ *        country in the StringPool, and its coordinates.
+ *
+ * The record holds what searches and statistics touch on every vertex (the code, which is the
+ * key, the ids and the coordinates); the names themselves live in the pool, out of the way,
+ * and are returned by reference without copying.
+ */
 class Airport {
 public:
+    static const size_t MaxCodeLength = 8;
+    static const uint64_t InvalidCode = ~uint64_t(0);  // the key of codes longer than MaxCodeLength
+
     // Constructor
 
     explicit Airport(const std::string& code);
@@ -14,11 +27,16 @@ public:
 
     Airport(){};
 
+    static uint64_t packCode(const std::string& code);
+
     // Getters
     std::string getCode() const;
-    std::string getName() const;
-    std::string getCity() const;
-    std::string getCountry() const;
+    uint64_t getCodeKey() const;
+    const std::string& getName() const;
+    const std::string& getCity() const;
+    const std::string& getCountry() const;
+    uint32_t getCityId() const;
+    uint32_t getCountryId() const;
     double getLatitude() const;
     double getLongitude() const;
 
@@ -35,24 +53,34 @@ public:
     }
 
 private:
-    std::string m_code;       // Airport code
-    std::string m_name;       // Airport name
-    std::string m_city;       // City where the airport is located
-    std::string m_country;    // Country where the airport is located
-    double m_latitude;        // Latitude
-    double m_longitude;       // Longitude
+    uint64_t m_code = 0;        // Airport code, first character in the highest byte
+    uint32_t m_name = 0;        // Airport name, as a StringPool id
+    uint32_t m_city = 0;        // City where the airport is located, as a StringPool id
+    uint32_t m_country = 0;     // Country where the airport is located, as a StringPool id
+    double m_latitude = 0;      // Latitude
+    double m_longitude = 0;     // Longitude
 };
 
 struct AirportHash {
     size_t operator()(const Airport& airport) const {
-        return std::hash<std::string>()(airport.getCode());
+        return std::hash<uint64_t>()(airport.getCodeKey());
     }
 };
 
 struct AirportEqual {
     bool operator()(const Airport& lhs, const Airport& rhs) const {
-        return lhs.getCode() == rhs.getCode();
+        return lhs.getCodeKey() == rhs.getCodeKey();
     }
 };
 
+namespace std {
+    template<>
+    struct hash<Airport> {
+        size_t operator()(const Airport& airport) const {
+            // Hash based on the unique airport code
+            return AirportHash()(airport);
+        }
+    };
+}
+
 #endif // AIRPORT_H
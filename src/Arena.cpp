@@ -0,0 +1,129 @@
+#include "Arena.h"
+
+/**
+ * @brief Constructor: creates an empty arena; chunks are only reserved by the first allocations.
+ * @param chunkBytes Size of each chunk.
+ */
+Arena::Arena(size_t chunkBytes) : chunkBytes(chunkBytes) {}
+
+Arena::~Arena() {
+    release();
+}
+
+/**
+ * @brief Allocates a block, 16-byte aligned.
+ * @param bytes Size of the block.
+ * @param account Account charged with the block, below MaxAccounts.
+ * @return The block.
+ * @note Time complexity: O(1)
+ */
+void* Arena::allocate(size_t bytes, int account) {
+    size_t rounded;
+    size_t c = sizeClass(bytes, rounded);
+    if (rounded > chunkBytes / 4) {
+        accountBytes[account] += bytes;
+        return ::operator new(bytes);
+    }
+    bytesInUse += rounded;
+    accountBytes[account] += rounded;
+
+    if (c < freeLists.size() && freeLists[c]) {
+        void* block = freeLists[c];
+        freeLists[c] = *static_cast<void**>(block);
+        return block;
+    }
+    if (cursor == nullptr || (size_t) (chunkEnd - cursor) < rounded) {
+        cursor = static_cast<char*>(::operator new(chunkBytes));
+        chunkEnd = cursor + chunkBytes;
+        chunks.push_back(cursor);
+    }
+    void* block = cursor;
+    cursor += rounded;
+    return block;
+}
+
+/**
+ * @brief Returns a block to the free list of its size class.
+ * @param block A block allocated by this arena.
+ * @param bytes The size it was allocated with.
+ * @param account The account it was allocated on.
+ * @note Time complexity: O(1)
+ */
+void Arena::deallocate(void* block, size_t bytes, int account) {
+    if (block == nullptr) return;
+    size_t rounded;
+    size_t c = sizeClass(bytes, rounded);
+    if (rounded > chunkBytes / 4) {
+        accountBytes[account] -= bytes;
+        ::operator delete(block);
+        return;
+    }
+    bytesInUse -= rounded;
+    accountBytes[account] -= rounded;
+    if (c >= freeLists.size()) freeLists.resize(c + 1, nullptr);
+    *static_cast<void**>(block) = freeLists[c];
+    freeLists[c] = block;
+}
+
+/**
+ * @brief Frees every chunk at once. Blocks handed out before become invalid, and those larger
+ *        than a quarter of a chunk must have been deallocated already.
+ * @note Time complexity: O(C) where C is the number of chunks.
+ */
+void Arena::release() {
+    for (char* chunk : chunks) {
+        ::operator delete(chunk);
+    }
+    chunks.clear();
+    freeLists.clear();
+    cursor = chunkEnd = nullptr;
+    bytesInUse = 0;
+    for (size_t& bytes : accountBytes) bytes = 0;
+}
+
+size_t Arena::getNumChunks() const {
+    return chunks.size();
+}
+
+size_t Arena::getBytesReserved() const {
+    return chunks.size() * chunkBytes;
+}
+
+/**
+ * @brief Gets the bytes of the blocks currently allocated from the chunks, rounded up to their size classes.
+ * @return The number of bytes.
+ */
+size_t Arena::getBytesInUse() const {
+    return bytesInUse;
+}
+
+/**
+ * @brief Gets the bytes of the blocks currently allocated on an account: rounded up to their size classes,
+ *        except blocks larger than a quarter of a chunk, which are counted as requested.
+ * @param account The account.
+ * @return The number of bytes.
+ */
+size_t Arena::getBytesInUse(int account) const {
+    return accountBytes[account];
+}
+
+/**
+ * @brief Finds the size class of a block: multiples of 16 bytes up to 256, then powers of two.
+ * @param bytes Size of the block.
+ * @param rounded Set to the size of the class.
+ * @return The class number.
+ */
+size_t Arena::sizeClass(size_t bytes, size_t& rounded) const {
+    if (bytes <= 256) {
+        size_t c = bytes == 0 ? 0 : (bytes - 1) / Alignment;
+        rounded = (c + 1) * Alignment;
+        return c;
+    }
+    size_t c = 256 / Alignment;
+    rounded = 512;
+    while (rounded < bytes) {
+        rounded *= 2;
+        c++;
+    }
+    return c;
+}
@@ -0,0 +1,110 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Memory pool that hands out blocks carved from large chunks.
+ *
+ * Small blocks are rounded up to a size class; freed blocks go to a free list per class and are
+ * reused by the next allocation of that class, so nothing is returned to the system until the
+ * arena is released or destroyed, which frees every chunk at once. Blocks larger than a quarter
+ * of a chunk bypass the pool.
+ *
+ * Every allocation is charged to one of a few accounts chosen by the caller, so the owner can
+ * tell what its memory holds without walking it.
+ *
+ * Not thread-safe: an arena belongs to one graph, which is only modified by one thread at a time.
+ */
+class Arena {
+public:
+    explicit Arena(size_t chunkBytes = 64 * 1024);
+    ~Arena();
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    static const int MaxAccounts = 8;
+
+    void* allocate(size_t bytes, int account = 0);
+    void deallocate(void* block, size_t bytes, int account = 0);
+    void release();
+
+    size_t getNumChunks() const;
+    size_t getBytesReserved() const;
+    size_t getBytesInUse() const;
+    size_t getBytesInUse(int account) const;
+
+private:
+    static const size_t Alignment = 16;
+
+    size_t chunkBytes;
+    std::vector<char*> chunks;
+    char* cursor = nullptr;        // next free byte of the current chunk
+    char* chunkEnd = nullptr;
+    std::vector<void*> freeLists;  // per size class, linked through the first word of each block
+    size_t bytesInUse = 0;
+    size_t accountBytes[MaxAccounts] = {};  // blocks in use per account, large ones included
+
+    size_t sizeClass(size_t bytes, size_t& rounded) const;
+};
+
+/**
+ * @brief Standard allocator over an Arena, for the containers of a graph's vertices and edges.
+ *
+ * Its blocks are charged to the account it was constructed with, which rebinding keeps, so a
+ * container's nodes and bucket arrays are charged together. Without an arena it falls back to
+ * operator new. Copies of a container do not inherit the
+ * arena (they are often made by readers, which must not allocate from it), so they use the heap.
+ */
+template <class T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ArenaAllocator() = default;
+    explicit ArenaAllocator(Arena* arena, int account = 0) : arena(arena), account(account) {}
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.getArena()), account(other.getAccount()) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(arena ? arena->allocate(n * sizeof(T), account) : ::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* block, size_t n) {
+        if (arena) arena->deallocate(block, n * sizeof(T), account);
+        else ::operator delete(block);
+    }
+
+    ArenaAllocator select_on_container_copy_construction() const {
+        return ArenaAllocator();
+    }
+
+    Arena* getArena() const {
+        return arena;
+    }
+
+    int getAccount() const {
+        return account;
+    }
+
+private:
+    Arena* arena = nullptr;
+    int account = 0;
+};
+
+template <class T, class U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.getArena() == b.getArena();
+}
+
+template <class T, class U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.getArena() != b.getArena();
+}
+
+#endif // ARENA_H
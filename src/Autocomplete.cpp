@@ -0,0 +1,244 @@
+#include "Autocomplete.h"
+#include "MemoryReport.h"
+#include <algorithm>
+#include <queue>
+
+/**
+ * @brief Adds a name to the index; build() must be called before the next query.
+ * @param kind What the name is.
+ * @param name The name, as in the dataset.
+ * @param code The airport or airline code, also matched by queries; empty for cities and countries.
+ * @param weight Flights of the airport, city, country or airline; heavier suggestions come first.
+ * @note Time complexity: O(W * L) where W is the number of words of the name and L its length.
+ */
+void Autocomplete::add(Kind kind, const std::string& name, const std::string& code, long weight) {
+    int entry = entries.size();
+    entries.push_back({kind, name, code, weight});
+
+    std::string text = normalize(name);
+    if (!text.empty()) keys.push_back({text, entry, true});
+    for (size_t i = 1; i < text.size(); i++) {
+        if (text[i - 1] == ' ') keys.push_back({text.substr(i), entry, false});
+    }
+    std::string normalizedCode = normalize(code);
+    if (!normalizedCode.empty() && normalizedCode != text) keys.push_back({normalizedCode, entry, true});
+}
+
+/**
+ * @brief Sorts the keys and builds the sparse table of the heaviest key of every power-of-two range.
+ * @note Time complexity: O(K log K) where K is the number of keys.
+ */
+void Autocomplete::build() {
+    std::sort(keys.begin(), keys.end(), [](const Key& a, const Key& b) {
+        return a.text != b.text ? a.text < b.text : a.entry < b.entry;
+    });
+    longestKey = 0;
+    for (const auto& key : keys) longestKey = std::max(longestKey, key.text.size());
+
+    best.assign(1, std::vector<int>(keys.size()));
+    for (size_t i = 0; i < keys.size(); i++) best[0][i] = i;
+    for (size_t width = 2; width <= keys.size(); width *= 2) {
+        const std::vector<int>& half = best.back();
+        std::vector<int> level(keys.size() - width + 1);
+        for (size_t i = 0; i < level.size(); i++) {
+            int a = half[i], b = half[i + width / 2];
+            level[i] = entries[keys[b].entry].weight > entries[keys[a].entry].weight ? b : a;
+        }
+        best.push_back(std::move(level));
+    }
+}
+
+/**
+ * @brief Suggests names starting like a query, allowing a few typos.
+ * @param query What was typed so far; normalised like the names.
+ * @param limit Largest number of suggestions.
+ * @param maxEdits Insertions, deletions and substitutions allowed between the query and the start of a name
+ *        or of one of its words; by default 0 below 4 characters, 1 below 8 and 2 from then on. It is capped
+ *        at MaxEdits and below the length of the query.
+ * @return The suggestions, by increasing edits and then by decreasing weight; each name at most once.
+ * @note Time complexity: O(N * (Q + log K) + S log S) where N is the number of trie nodes within maxEdits of a prefix
+ *       of the query, Q the query length, K the number of keys and S the number of suggestions looked at.
+ */
+std::vector<Autocomplete::Suggestion> Autocomplete::complete(const std::string& query, int limit, int maxEdits) const {
+    std::vector<Suggestion> suggestions;
+    std::string text = normalize(query);
+    if (text.empty() || limit <= 0 || keys.empty()) return suggestions;
+    int length = text.size();
+    if (maxEdits < 0) maxEdits = length < 4 ? 0 : length < 8 ? 1 : 2;
+    maxEdits = std::max(0, std::min({maxEdits, (int) MaxEdits, length - 1}));
+
+    // ranges[e]: the key ranges whose common prefix is e edits from the query
+    std::vector<std::vector<std::pair<int, int>>> ranges(maxEdits + 1);
+    std::vector<int> rows((longestKey + 1) * (length + 1));
+    for (int j = 0; j <= length; j++) rows[j] = j;
+    walk(0, keys.size(), 0, text, maxEdits, maxEdits + 1, rows, ranges);
+
+    struct Candidate {
+        long weight;
+        int key, lo, hi;
+        bool operator<(const Candidate& other) const {
+            return weight != other.weight ? weight < other.weight : key > other.key;
+        }
+    };
+    std::vector<char> taken(entries.size(), false);
+    for (int edits = 0; edits <= maxEdits && (int) suggestions.size() < limit; edits++) {
+        std::priority_queue<Candidate> heap;
+        auto push = [&](int lo, int hi) {
+            if (lo >= hi) return;
+            int key = bestIn(lo, hi);
+            heap.push({entries[keys[key].entry].weight, key, lo, hi});
+        };
+        for (const auto& range : ranges[edits]) push(range.first, range.second);
+        while (!heap.empty() && (int) suggestions.size() < limit) {
+            Candidate top = heap.top();
+            heap.pop();
+            int entry = keys[top.key].entry;
+            if (!taken[entry]) {
+                taken[entry] = true;
+                suggestions.push_back(toSuggestion(entry, edits));
+            }
+            push(top.lo, top.key);
+            push(top.key + 1, top.hi);
+        }
+    }
+    return suggestions;
+}
+
+/**
+ * @brief Finds the names and codes equal to a query once both are normalised.
+ * @param query The text to look up.
+ * @return The matching names, heaviest first.
+ * @note Time complexity: O(Q log K + M log M) where Q is the query length, K the number of keys and M the number of matches.
+ */
+std::vector<Autocomplete::Suggestion> Autocomplete::match(const std::string& query) const {
+    std::vector<Suggestion> matches;
+    std::string text = normalize(query);
+    if (text.empty()) return matches;
+    auto it = std::lower_bound(keys.begin(), keys.end(), text, [](const Key& key, const std::string& value) {
+        return key.text < value;
+    });
+    std::vector<int> found;
+    for (; it != keys.end() && it->text == text; it++) {
+        if (it->whole && std::find(found.begin(), found.end(), it->entry) == found.end()) found.push_back(it->entry);
+    }
+    std::sort(found.begin(), found.end(), [&](int a, int b) {
+        return entries[a].weight != entries[b].weight ? entries[a].weight > entries[b].weight : a < b;
+    });
+    for (int entry : found) matches.push_back(toSuggestion(entry, 0));
+    return matches;
+}
+
+/**
+ * @brief Gets the number of names indexed.
+ * @return The number of names.
+ */
+size_t Autocomplete::size() const {
+    return entries.size();
+}
+
+/**
+ * @brief Estimates the heap bytes of the index: the names, the keys and the sparse table.
+ * @return The number of bytes.
+ * @note Time complexity: O(K) where K is the number of keys.
+ */
+size_t Autocomplete::getBytes() const {
+    size_t bytes = MemoryReport::bytesOf(entries) + MemoryReport::bytesOf(keys) + MemoryReport::bytesOf(best);
+    for (const auto& entry : entries) bytes += MemoryReport::bytesOf(entry.name) + MemoryReport::bytesOf(entry.code);
+    for (const auto& key : keys) bytes += MemoryReport::bytesOf(key.text);
+    return bytes;
+}
+
+/**
+ * @brief Normalises a name or query: ASCII letters in lower case, other ASCII characters but digits as
+ *        word breaks, one space between words and none around them. Bytes above ASCII are kept as they are.
+ * @param text The text.
+ * @return The normalised text.
+ * @note Time complexity: O(L) where L is the length of the text.
+ */
+std::string Autocomplete::normalize(const std::string& text) {
+    std::string normalized;
+    bool pendingSpace = false;
+    for (unsigned char c : text) {
+        bool word = c >= 128 || (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        if (!word) {
+            pendingSpace = !normalized.empty();
+            continue;
+        }
+        if (pendingSpace) normalized += ' ';
+        pendingSpace = false;
+        normalized += (c >= 'A' && c <= 'Z') ? (char) (c - 'A' + 'a') : (char) c;
+    }
+    return normalized;
+}
+
+/**
+ * @brief Gets the name of a kind of suggestion, as used in JSON answers.
+ * @param kind The kind.
+ * @return Its name.
+ */
+std::string Autocomplete::getName(Kind kind) {
+    switch (kind) {
+        case Kind::Airport: return "airport";
+        case Kind::City: return "city";
+        case Kind::Country: return "country";
+        case Kind::Airline: return "airline";
+    }
+    return "";
+}
+
+/**
+ * @brief Finds the heaviest key of a range, the first one on ties.
+ * @param lo First key of the range.
+ * @param hi One past the last key; greater than lo.
+ * @return The key's index.
+ * @note Time complexity: O(1)
+ */
+int Autocomplete::bestIn(int lo, int hi) const {
+    int level = 0;
+    while ((2 << level) <= hi - lo) level++;
+    int a = best[level][lo], b = best[level][hi - (1 << level)];
+    return entries[keys[b].entry].weight > entries[keys[a].entry].weight ? b : a;
+}
+
+/**
+ * @brief Walks the children of a trie node, the keys lo to hi - 1 which share their first depth characters.
+ * @param depth Length of the shared prefix; rows[depth * (Q + 1)] holds its edit distance row against the query.
+ * @param pathEdits Fewest edits a range on the path to this node was recorded with; only closer ranges are recorded below.
+ * @param ranges Receives the ranges whose prefix is within maxEdits edits of the query, by number of edits.
+ */
+void Autocomplete::walk(int lo, int hi, size_t depth, const std::string& query, int maxEdits, int pathEdits,
+                        std::vector<int>& rows, std::vector<std::vector<std::pair<int, int>>>& ranges) const {
+    int length = query.size();
+    const int* row = &rows[depth * (length + 1)];
+    int* next = &rows[(depth + 1) * (length + 1)];
+
+    int i = lo;
+    while (i < hi && keys[i].text.size() == depth) i++;  // the prefix itself sorts first
+    while (i < hi) {
+        unsigned char c = keys[i].text[depth];
+        int j = std::partition_point(keys.begin() + i, keys.begin() + hi, [&](const Key& key) {
+            return (unsigned char) key.text[depth] <= c;
+        }) - keys.begin();
+
+        next[0] = row[0] + 1;
+        int closest = next[0];
+        for (int k = 1; k <= length; k++) {
+            next[k] = std::min({row[k] + 1, next[k - 1] + 1, row[k - 1] + ((unsigned char) query[k - 1] != c)});
+            closest = std::min(closest, next[k]);
+        }
+        if (closest <= maxEdits) {
+            int edits = pathEdits;
+            if (next[length] < pathEdits) {
+                ranges[next[length]].push_back({i, j});
+                edits = next[length];
+            }
+            if (edits > 0) walk(i, j, depth + 1, query, maxEdits, edits, rows, ranges);
+        }
+        i = j;
+    }
+}
+
+Autocomplete::Suggestion Autocomplete::toSuggestion(int entry, int edits) const {
+    const Entry& e = entries[entry];
+    return {e.kind, e.name, e.code, e.weight, edits};
+}
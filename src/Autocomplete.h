@@ -0,0 +1,73 @@
+#ifndef AUTOCOMPLETE_H
+#define AUTOCOMPLETE_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Type-ahead index over airport, city, country and airline names, tolerant of typos.
+ *
+ * Names are normalised (lower case, punctuation as spaces, single spaces) and stored once per
+ * word, as the text from that word on, in one sorted array of keys; airport and airline codes
+ * are keys too. The keys sharing a prefix are a range of the array, so it is walked as a trie
+ * without storing one: each step keeps a row of the edit distance table between the query and
+ * the path so far, and stops where no prefix below can come within the allowed edits. The
+ * matching ranges are ranked by weight with a sparse table of range maxima, so a query costs
+ * the part of the trie near the query plus O(k log k) for k suggestions, whatever the ranges hold.
+ */
+class Autocomplete {
+public:
+    enum class Kind {
+        Airport,
+        City,
+        Country,
+        Airline
+    };
+
+    struct Suggestion {
+        Kind kind;
+        std::string name;  // as in the dataset
+        std::string code;  // airport or airline code; empty for cities and countries
+        long weight;       // flights of the airport, city, country or airline
+        int edits;         // edits between the query and the start of the name or word it matched
+    };
+
+    static const int MaxEdits = 3;
+
+    void add(Kind kind, const std::string& name, const std::string& code, long weight);
+    void build();
+
+    std::vector<Suggestion> complete(const std::string& query, int limit, int maxEdits = -1) const;
+    std::vector<Suggestion> match(const std::string& query) const;
+    size_t size() const;
+    size_t getBytes() const;
+
+    static std::string normalize(const std::string& text);
+    static std::string getName(Kind kind);
+
+private:
+    struct Entry {
+        Kind kind;
+        std::string name;
+        std::string code;
+        long weight;
+    };
+
+    struct Key {
+        std::string text;
+        int entry;
+        bool whole;  // the whole normalised name or code, not the text from a later word
+    };
+
+    std::vector<Entry> entries;
+    std::vector<Key> keys;               // sorted by text
+    std::vector<std::vector<int>> best;  // best[j][i]: the key of highest weight among keys i to i + 2^j - 1
+    size_t longestKey = 0;
+
+    int bestIn(int lo, int hi) const;
+    void walk(int lo, int hi, size_t depth, const std::string& query, int maxEdits, int pathEdits,
+              std::vector<int>& rows, std::vector<std::vector<std::pair<int, int>>>& ranges) const;
+    Suggestion toSuggestion(int entry, int edits) const;
+};
+
+#endif // AUTOCOMPLETE_H
@@ -0,0 +1,567 @@
+#include "BatchRunner.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <sys/stat.h>
+
+namespace {
+
+const char* const statisticNames[] = {
+        "total_airports", "total_flights",
+        "flights_from_airport", "flights_to_airport", "unique_airlines_from_airport", "unique_airlines_to_airport",
+        "airports_with_flights_to",
+        "flights_per_city", "flights_per_airline", "flights_per_city_airline", "flights_per_country_airline",
+        "flights_per_distance",
+        "countries_by_airport", "countries_to_airport", "countries_by_city", "countries_from_country",
+        "reachable_airports", "reachable_cities", "reachable_countries",
+        "airports_reaching", "cities_reaching", "countries_reaching",
+        "longest_path", "top_k_airports", "essential_airports", "component_sizes",
+        "betweenness", "pagerank", "related_destinations", "memory_report",
+};
+
+bool getString(const std::map<std::string, JsonValue>& query, const std::string& key, std::string& value, std::string& error) {
+    auto it = query.find(key);
+    if (it == query.end() || it->second.type != JsonValue::String) {
+        error = "missing string \"" + key + "\"";
+        return false;
+    }
+    value = it->second.text;
+    return true;
+}
+
+// Numbers may also be given as strings, as the command line does
+double getNumber(const std::map<std::string, JsonValue>& query, const std::string& key, double fallback) {
+    auto it = query.find(key);
+    if (it == query.end()) return fallback;
+    if (it->second.type == JsonValue::Number) return it->second.number;
+    if (it->second.type == JsonValue::String) return std::atof(it->second.text.c_str());
+    return fallback;
+}
+
+// Whole-number parameters: anything outside the range of int (NaN and infinities included) is an error, not a cast
+bool getInt(const std::map<std::string, JsonValue>& query, const std::string& key, int fallback, int& value, std::string& error) {
+    double number = getNumber(query, key, fallback);
+    if (!std::isfinite(number) || number < std::numeric_limits<int>::min() || number > std::numeric_limits<int>::max()) {
+        error = "invalid \"" + key + "\" (expected a number from " + std::to_string(std::numeric_limits<int>::min())
+                + " to " + std::to_string(std::numeric_limits<int>::max()) + ")";
+        return false;
+    }
+    value = (int) number;
+    return true;
+}
+
+bool getBool(const std::map<std::string, JsonValue>& query, const std::string& key) {
+    auto it = query.find(key);
+    if (it == query.end()) return false;
+    return it->second.type == JsonValue::Bool ? it->second.boolean : it->second.text == "true";
+}
+
+// Times as minutes or as strings Timetable::parseTime() reads ("08:30", "08:30+1"); -1 if invalid
+int getTime(const std::map<std::string, JsonValue>& query, const std::string& key, int fallback) {
+    auto it = query.find(key);
+    if (it == query.end()) return fallback;
+    if (it->second.type == JsonValue::Number) {
+        double minutes = it->second.number;
+        return minutes >= 0 && minutes <= Timetable::MaxTime ? (int) minutes : -1;  // false for NaN too
+    }
+    if (it->second.type == JsonValue::String) return Timetable::parseTime(it->second.text);
+    return -1;
+}
+
+std::string journeyOf(const Timetable::Journey& journey) {
+    JsonArray legs;
+    for (const auto& leg : journey.legs) {
+        legs.pushRaw(JsonObject()
+                             .add("from", leg.from->getInfo().getCode())
+                             .add("to", leg.to->getInfo().getCode())
+                             .add("airline", leg.airline)
+                             .add("departure", Timetable::formatTime(leg.departure))
+                             .add("arrival", Timetable::formatTime(leg.arrival))
+                             .str());
+    }
+    JsonObject object;
+    object.add("found", !journey.legs.empty());
+    if (!journey.legs.empty()) {
+        object.add("departure", Timetable::formatTime(journey.departure))
+                .add("arrival", Timetable::formatTime(journey.arrival))
+                .add("duration", journey.arrival - journey.departure);
+    }
+    return object.addRaw("legs", legs.str()).str();
+}
+
+std::string codesOf(const std::vector<Airport>& airports) {
+    JsonArray codes;
+    for (const auto& airport : airports) codes.push(airport.getCode());
+    return codes.str();
+}
+
+std::string sortedArray(const std::unordered_set<std::string>& values) {
+    std::vector<std::string> sorted(values.begin(), values.end());
+    std::sort(sorted.begin(), sorted.end());
+    JsonArray array;
+    for (const auto& value : sorted) array.push(value);
+    return array.str();
+}
+
+template <class T>
+std::string scoredAirports(const std::vector<std::pair<Airport, T>>& airports) {
+    JsonArray array;
+    for (const auto& pair : airports) {
+        array.pushRaw(JsonObject().add("airport", pair.first.getCode()).add("score", pair.second).str());
+    }
+    return array.str();
+}
+
+std::string countsByKey(const std::map<std::string, long>& counts) {
+    JsonObject object;
+    for (const auto& pair : counts) object.add(pair.first, pair.second);
+    return object.str();
+}
+
+std::string countsByPair(const std::map<std::pair<std::string, std::string>, long>& counts, const char* first, const char* second) {
+    JsonArray array;
+    for (const auto& pair : counts) {
+        array.pushRaw(JsonObject()
+                              .add(first, pair.first.first)
+                              .add(second, pair.first.second)
+                              .add("flights", pair.second)
+                              .str());
+    }
+    return array.str();
+}
+
+bool parseMetric(const std::string& name, RankingMetric& metric) {
+    const std::pair<const char*, RankingMetric> metrics[] = {
+            {"outgoing_flights", RankingMetric::OutgoingFlights},
+            {"incoming_flights", RankingMetric::IncomingFlights},
+            {"distinct_routes", RankingMetric::DistinctRoutes},
+            {"distinct_airlines", RankingMetric::DistinctAirlines},
+            {"reach", RankingMetric::ReachWithinStops},
+    };
+    for (const auto& pair : metrics) {
+        if (name == pair.first) {
+            metric = pair.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+}
+
+/**
+ * @brief Constructor: loads the dataset and builds every index the queries use, as snapshot version 1.
+ * @param datasetPath Directory holding airports.csv, airlines.csv and flights.csv, with a trailing '/'.
+ * @note Time complexity: that of loading the dataset and constructing Search and Statistics.
+ */
+BatchRunner::BatchRunner(const std::string& datasetPath)
+        : datasetPath(datasetPath), dataset(std::make_shared<const Dataset>(datasetPath, 1)) {}
+
+/**
+ * @brief Destructor: stops watching the dataset files.
+ */
+BatchRunner::~BatchRunner() {
+    {
+        std::lock_guard<std::mutex> lock(watchLock);
+        stopWatching = true;
+    }
+    watchStopped.notify_all();
+    if (watcher.joinable()) watcher.join();
+}
+
+/**
+ * @brief Describes the current snapshot.
+ * @return A JSON line with its version, the number of airports, airlines and flights and the time taken to load and index them.
+ */
+std::string BatchRunner::getLoadReport() const {
+    auto data = getSnapshot();
+    return JsonObject()
+            .add("type", "load")
+            .add("ok", !data->isEmpty())
+            .add("version", data->getVersion())
+            .add("airports", data->getGraph().getNumVertex())
+            .add("airlines", data->getNumAirlines())
+            .add("flights", data->getGraph().getNumFlights())
+            .add("departures", data->getTimetable().size())
+            .add("elapsed_ms", data->getLoadMs())
+            .str();
+}
+
+/**
+ * @brief Pins the current snapshot: it stays alive, unchanged, for as long as the returned pointer is held.
+ * @return The current snapshot.
+ * @note Time complexity: O(1).
+ */
+std::shared_ptr<const Dataset> BatchRunner::getSnapshot() const {
+    return std::atomic_load(&dataset);
+}
+
+/**
+ * @brief Loads the dataset directory again into a new snapshot and makes it current.
+ * Queries keep running on the current snapshot meanwhile; those that start after the swap see the new one.
+ * A load that finds no airports (the files are missing or being replaced) is discarded and the current snapshot kept.
+ * @param report If given, set to the load report of the new snapshot, or of the current one if the load was discarded.
+ * @return True if the new snapshot was swapped in.
+ * @note Time complexity: that of loading the dataset; only one reload runs at a time.
+ */
+bool BatchRunner::reload(std::string* report) {
+    std::lock_guard<std::mutex> lock(reloadLock);
+    std::shared_ptr<const Dataset> next = std::make_shared<const Dataset>(datasetPath, lastVersion + 1);
+    bool swapped = !next->isEmpty();
+    if (swapped) {
+        lastVersion++;
+        std::atomic_store(&dataset, next);
+    }
+    // Unless swapped in, the new snapshot is freed here; the old one when its last reader finishes
+    next.reset();
+    if (report) *report = getLoadReport();
+    return swapped;
+}
+
+/**
+ * @brief Starts a background thread that reloads the dataset when its CSV files change.
+ * A change is only acted on once the files have stayed the same for a whole interval, so files still being written are not loaded.
+ * @param intervalMs Time between two checks of the files' modification times and sizes.
+ */
+void BatchRunner::startWatching(int intervalMs) {
+    if (watcher.joinable() || intervalMs <= 0) return;
+    watcher = std::thread(&BatchRunner::watch, this, intervalMs);
+}
+
+std::string BatchRunner::getFileSignature() const {
+    std::string signature;
+    for (const char* file : {"airports.csv", "airlines.csv", "flights.csv"}) {
+        struct stat info;
+        if (stat((datasetPath + file).c_str(), &info) != 0) return "";
+        signature += std::to_string((long long) info.st_mtime) + "." + std::to_string((long long) info.st_size) + " ";
+    }
+    // The timetable is optional, but a new or changed one is reloaded too
+    for (const char* file : {"timetable.csv", "min_connection.csv"}) {
+        struct stat info;
+        if (stat((datasetPath + file).c_str(), &info) != 0) continue;
+        signature += std::string(file) + "=" + std::to_string((long long) info.st_mtime) + "." + std::to_string((long long) info.st_size) + " ";
+    }
+    return signature;
+}
+
+void BatchRunner::watch(int intervalMs) {
+    std::string loaded = getFileSignature(), seen = loaded;
+    std::unique_lock<std::mutex> lock(watchLock);
+    while (!watchStopped.wait_for(lock, std::chrono::milliseconds(intervalMs), [this]() { return stopWatching; })) {
+        std::string current = getFileSignature();
+        if (current != seen || current == loaded || current.empty()) {
+            seen = current;
+            continue;
+        }
+        lock.unlock();
+        std::string report;
+        reload(&report);
+        std::cerr << report << std::endl;
+        loaded = current;
+        lock.lock();
+    }
+}
+
+/**
+ * @brief Answers one query.
+ * @param query The members of the query object.
+ * @param ok If given, set to whether the query succeeded.
+ * @return The JSON line answering it; errors are reported in it rather than thrown.
+ */
+std::string BatchRunner::run(const std::map<std::string, JsonValue>& query, bool* ok) {
+    JsonObject answer;
+    auto id = query.find("id");
+    if (id != query.end()) {
+        if (id->second.type == JsonValue::String) answer.add("id", id->second.text);
+        else if (id->second.type == JsonValue::Number) answer.add("id", id->second.number);
+    }
+
+    std::string type, result, error;
+    auto start = std::chrono::steady_clock::now();
+    bool succeeded = getString(query, "type", type, error);
+    if (succeeded && type == "reload") {
+        succeeded = reload(&result);
+        if (!succeeded) error = "the reloaded dataset has no airports; kept the current version";
+    }
+
+    // The query runs on the snapshot current when it started, even if a reload swaps in another meanwhile
+    std::shared_ptr<const Dataset> data = getSnapshot();
+    if (succeeded && type != "reload") {
+        if (type == "search") succeeded = runSearch(*data, query, result, error);
+        else if (type == "filtered") succeeded = runFilteredSearch(*data, query, result, error);
+        else if (type == "suggest") succeeded = runSuggest(*data, query, result, error);
+        else if (type == "shortest") succeeded = runShortestRoute(*data, query, result, error);
+        else if (type == "earliest") succeeded = runEarliestArrival(*data, query, result, error);
+        else if (type == "profile") succeeded = runProfile(*data, query, result, error);
+        else if (type == "stat") succeeded = runStatistic(*data, query, result, error);
+        else {
+            succeeded = false;
+            error = "unknown type \"" + type + "\" (expected search, filtered, suggest, shortest, earliest, profile, stat or reload)";
+        }
+    }
+    double elapsedUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    if (ok) *ok = succeeded;
+    answer.add("type", type).add("ok", succeeded).add("version", data->getVersion()).add("elapsed_us", elapsedUs);
+    if (succeeded) answer.addRaw("result", result);
+    else answer.add("error", error);
+    return answer.str();
+}
+
+/**
+ * @brief Parses and answers one query line.
+ * @param line A JSON object.
+ * @param ok If given, set to whether the query succeeded.
+ * @return The JSON line answering it.
+ */
+std::string BatchRunner::runLine(const std::string& line, bool* ok) {
+    std::map<std::string, JsonValue> query;
+    std::string error;
+    if (!Json::parseObject(line, query, error)) {
+        if (ok) *ok = false;
+        return JsonObject().add("ok", false).add("error", "invalid query: " + error).str();
+    }
+    return run(query, ok);
+}
+
+/**
+ * @brief Answers every query of a stream, one JSON object per line; blank lines are skipped.
+ * @param in Stream of queries.
+ * @param out Stream the answers are written to, one line each, in order.
+ * @return The number of queries that failed.
+ */
+long BatchRunner::runAll(std::istream& in, std::ostream& out) {
+    long failed = 0;
+    std::string line;
+    while (getline(in, line)) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        bool ok;
+        out << runLine(line, &ok) << '\n';
+        if (!ok) failed++;
+    }
+    out.flush();
+    return failed;
+}
+
+/**
+ * @brief Gets the names accepted by "stat" queries.
+ * @return Every statistic name.
+ */
+std::vector<std::string> BatchRunner::getStatisticNames() {
+    return std::vector<std::string>(std::begin(statisticNames), std::end(statisticNames));
+}
+
+bool BatchRunner::runSearch(const Dataset& data, const std::map<std::string, JsonValue>& query, std::string& result, std::string& error) {
+    std::string source, destination;
+    if (!getString(query, "source", source, error) || !getString(query, "destination", destination, error)) return false;
+
+    std::vector<Airport> path = data.getSearch().findBestFlight(source, destination);
+    result = JsonObject()
+            .add("found", !path.empty())
+            .add("stops", path.empty() ? -1 : (int) path.size() - 1)
+            .addRaw("path", codesOf(path))
+            .str();
+    return true;
+}
+
+bool BatchRunner::runFilteredSearch(const Dataset& data, const std::map<std::string, JsonValue>& query, std::string& result, std::string& error) {
+    std::string source, destination;
+    if (!getString(query, "source", source, error) || !getString(query, "destination", destination, error)) return false;
+
+    // Preferred airlines as an array of codes or as one comma-separated string
+    std::unordered_set<std::string> preferredAirlines;
+    auto it = query.find("airlines");
+    if (it != query.end()) {
+        if (it->second.type == JsonValue::Array) {
+            for (const auto& item : it->second.items) preferredAirlines.insert(item.text);
+        } else {
+            std::istringstream ss(it->second.text);
+            std::string airlineCode;
+            while (std::getline(ss, airlineCode, ',')) {
+                if (!airlineCode.empty()) preferredAirlines.insert(airlineCode);
+            }
+        }
+    }
+
+    auto path = data.getSearch().findBestFlight(source, destination, preferredAirlines, getBool(query, "minimize_changes"));
+    JsonArray legs;
+    for (const auto& leg : path) {
+        legs.pushRaw(JsonObject().add("airport", leg.first.getCode()).add("airline", leg.second).str());
+    }
+    result = JsonObject()
+            .add("found", !path.empty())
+            .add("stops", path.empty() ? -1 : (int) path.size() - 1)
+            .addRaw("path", legs.str())
+            .str();
+    return true;
+}
+
+bool BatchRunner::runSuggest(const Dataset& data, const std::map<std::string, JsonValue>& query, std::string& result, std::string& error) {
+    std::string text;
+    if (!getString(query, "text", text, error)) return false;
+    int limit, edits;
+    if (!getInt(query, "limit", 10, limit, error) || !getInt(query, "edits", -1, edits, error)) return false;
+    JsonArray suggestions;
+    for (const auto& suggestion : data.getSearch().suggest(text, limit, edits)) {
+        JsonObject item;
+        item.add("kind", Autocomplete::getName(suggestion.kind)).add("name", suggestion.name);
+        if (!suggestion.code.empty()) item.add("code", suggestion.code);
+        suggestions.pushRaw(item.add("flights", suggestion.weight).add("edits", suggestion.edits).str());
+    }
+    result = suggestions.str();
+    return true;
+}
+
+bool BatchRunner::runShortestRoute(const Dataset& data, const std::map<std::string, JsonValue>& query, std::string& result, std::string& error) {
+    std::string source, destination;
+    if (!getString(query, "source", source, error) || !getString(query, "destination", destination, error)) return false;
+
+    ContractionHierarchy::Route route = data.getSearch().findShortestRoute(source, destination);
+    JsonArray path;
+    for (const auto* vertex : route.path) path.push(vertex->getInfo().getCode());
+    JsonObject object;
+    object.add("found", !route.path.empty());
+    if (!route.path.empty()) object.add("km", route.distance);
+    result = object.add("stops", route.path.empty() ? -1 : (int) route.path.size() - 1).addRaw("path", path.str()).str();
+    return true;
+}
+
+bool BatchRunner::runEarliestArrival(const Dataset& data, const std::map<std::string, JsonValue>& query, std::string& result, std::string& error) {
+    std::string source, destination;
+    if (!getString(query, "source", source, error) || !getString(query, "destination", destination, error)) return false;
+    if (data.getTimetable().empty()) {
+        error = "no timetable loaded (timetable.csv)";
+        return false;
+    }
+    int depart = getTime(query, "depart", 0);
+    if (depart < 0) {
+        error = "invalid \"depart\" (expected minutes or HH:MM[+D])";
+        return false;
+    }
+    result = journeyOf(data.getSearch().findEarliestArrival(source, destination, depart));
+    return true;
+}
+
+bool BatchRunner::runProfile(const Dataset& data, const std::map<std::string, JsonValue>& query, std::string& result, std::string& error) {
+    std::string source, destination;
+    if (!getString(query, "source", source, error) || !getString(query, "destination", destination, error)) return false;
+    if (data.getTimetable().empty()) {
+        error = "no timetable loaded (timetable.csv)";
+        return false;
+    }
+    int from = getTime(query, "depart", 0);
+    int until = getTime(query, "until", from + 24 * 60 - 1);
+    if (from < 0 || until < from) {
+        error = "invalid \"depart\" or \"until\" (expected minutes or HH:MM[+D], depart first)";
+        return false;
+    }
+    JsonArray journeys;
+    for (const auto& journey : data.getSearch().findJourneys(source, destination, from, until)) journeys.pushRaw(journeyOf(journey));
+    result = journeys.str();
+    return true;
+}
+
+bool BatchRunner::runStatistic(const Dataset& data, const std::map<std::string, JsonValue>& query, std::string& result, std::string& error) {
+    const Statistics& statistics = data.getStatistics();
+    std::string name, airport, city, country;
+    if (!getString(query, "name", name, error)) return false;
+    int stops, k, pivots;
+    if (!getInt(query, "stops", 1, stops, error) || !getInt(query, "k", 10, k, error)
+        || !getInt(query, "pivots", 0, pivots, error)) return false;
+
+    if (name == "total_airports") {
+        result = std::to_string(statistics.getTotalNumberOfAirports());
+    } else if (name == "total_flights") {
+        result = std::to_string(statistics.getTotalNumberOfFlights());
+    } else if (name == "flights_from_airport" || name == "flights_to_airport" || name == "unique_airlines_from_airport"
+               || name == "unique_airlines_to_airport" || name == "countries_by_airport" || name == "countries_to_airport") {
+        if (!getString(query, "airport", airport, error)) return false;
+        long count = name == "flights_from_airport" ? statistics.getNumberOfFlightsFromAirport(airport)
+                   : name == "flights_to_airport" ? statistics.getNumberOfFlightsToAirport(airport)
+                   : name == "unique_airlines_from_airport" ? statistics.getNumberOfUniqueAirlinesFromAirport(airport)
+                   : name == "unique_airlines_to_airport" ? statistics.getNumberOfUniqueAirlinesToAirport(airport)
+                   : name == "countries_by_airport" ? statistics.getNumberOfDiffCountriesByAirport(airport)
+                   : statistics.getNumberOfDiffCountriesToAirport(airport);
+        result = std::to_string(count);
+    } else if (name == "airports_with_flights_to") {
+        if (!getString(query, "airport", airport, error)) return false;
+        JsonArray origins;
+        for (const auto& origin : statistics.getAirportsWithFlightsTo(airport)) origins.push(origin);
+        result = origins.str();
+    } else if (name == "flights_per_city") {
+        result = countsByKey(statistics.getNumberOfFlightsPerCity());
+    } else if (name == "flights_per_airline") {
+        result = countsByKey(statistics.getNumberOfFlightsPerAirline());
+    } else if (name == "flights_per_city_airline") {
+        result = countsByPair(statistics.getNumberOfFlightsPerCityAirline(), "city", "airline");
+    } else if (name == "flights_per_country_airline") {
+        result = countsByPair(statistics.getNumberOfFlightsPerCountryAirline(), "country", "airline");
+    } else if (name == "flights_per_distance") {
+        double bucketKm = getNumber(query, "bucket_km", 500);
+        if (!(bucketKm >= Statistics::MinBucketKm) || !std::isfinite(bucketKm)) {
+            error = "invalid \"bucket_km\" (expected a width of at least " + Json::number(Statistics::MinBucketKm) + " km)";
+            return false;
+        }
+        JsonArray buckets;
+        for (const auto& pair : statistics.getNumberOfFlightsPerDistance(bucketKm)) {
+            buckets.pushRaw(JsonObject().add("from_km", pair.first).add("flights", pair.second).str());
+        }
+        result = buckets.str();
+    } else if (name == "countries_by_city") {
+        if (!getString(query, "city", city, error)) return false;
+        result = std::to_string(statistics.getNumberOfDiffCountriesByCity(city));
+    } else if (name == "countries_from_country") {
+        if (!getString(query, "country", country, error)) return false;
+        JsonArray countries;
+        for (const auto& destination : statistics.getCountriesReachableFromCountry(country)) countries.push(destination);
+        result = countries.str();
+    } else if (name == "reachable_airports" || name == "reachable_cities" || name == "reachable_countries") {
+        if (!getString(query, "airport", airport, error)) return false;
+        result = sortedArray(name == "reachable_airports" ? statistics.getReachableAirports(airport, stops)
+                           : name == "reachable_cities" ? statistics.getReachableCities(airport, stops)
+                           : statistics.getReachableCountries(airport, stops));
+    } else if (name == "airports_reaching" || name == "cities_reaching" || name == "countries_reaching") {
+        if (!getString(query, "airport", airport, error)) return false;
+        result = sortedArray(name == "airports_reaching" ? statistics.getAirportsReaching(airport, stops)
+                           : name == "cities_reaching" ? statistics.getCitiesReaching(airport, stops)
+                           : statistics.getCountriesReaching(airport, stops));
+    } else if (name == "longest_path") {
+        JsonArray paths;
+        for (const auto& path : statistics.findLongestPath()) paths.pushRaw(codesOf(path));
+        result = paths.str();
+    } else if (name == "top_k_airports") {
+        RankingMetric metric = RankingMetric::OutgoingFlights;
+        std::string metricName;
+        if (getString(query, "metric", metricName, error) && !parseMetric(metricName, metric)) {
+            error = "unknown metric \"" + metricName + "\" (expected outgoing_flights, incoming_flights, "
+                    "distinct_routes, distinct_airlines or reach)";
+            return false;
+        }
+        result = scoredAirports(statistics.getTopKAirports(metric, k, stops));
+    } else if (name == "essential_airports") {
+        std::unordered_set<std::string> codes;
+        for (const auto& essential : statistics.findEssentialAirports()) codes.insert(essential.getCode());
+        result = sortedArray(codes);
+    } else if (name == "component_sizes") {
+        JsonArray sizes;
+        for (int size : statistics.getComponentSizes()) sizes.push(size);
+        result = sizes.str();
+    } else if (name == "betweenness") {
+        result = scoredAirports(statistics.getTopKAirportsByBetweenness(k, pivots));
+    } else if (name == "pagerank") {
+        result = scoredAirports(statistics.getTopKAirportsByPageRank(k));
+    } else if (name == "related_destinations") {
+        if (!getString(query, "airport", airport, error)) return false;
+        result = scoredAirports(statistics.getRelatedDestinations(airport, k));
+    } else if (name == "memory_report") {
+        result = statistics.getMemoryReport().toJson();
+    } else {
+        error = "unknown statistic \"" + name + "\" (expected one of:";
+        for (const char* known : statisticNames) error += std::string(" ") + known;
+        error += ")";
+        return false;
+    }
+    return true;
+}
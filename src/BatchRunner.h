@@ -0,0 +1,80 @@
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include "Dataset.h"
+#include "Json.h"
+#include <condition_variable>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+
+/**
+ * @brief Answers queries without the menu, one JSON line per query.
+ *
+ * The dataset and every index (condensation, live ranking, Search and Statistics with their
+ * tables, the timetable if the directory has one) live in an immutable Dataset snapshot, built by the constructor and shared by the queries.
+ * reload() builds the next version of the snapshot from the same directory while queries keep
+ * running on the current one, then swaps it in; each query pins the snapshot it started on, so
+ * the old version is freed by whichever query finishes with it last. startWatching() reloads by
+ * itself when the CSV files change.
+ *
+ * A query is a flat JSON object with a "type":
+ *   {"type": "search", "source": "JFK", "destination": "Lisbon"}
+ *   {"type": "filtered", "source": "JFK", "destination": "LIS", "airlines": ["TAP", "UAL"], "minimize_changes": true}
+ *   {"type": "shortest", "source": "OPO", "destination": "Sydney"}
+ *   {"type": "earliest", "source": "OPO", "destination": "JFK", "depart": "08:00"}
+ *   {"type": "profile", "source": "OPO", "destination": "JFK", "depart": "06:00", "until": "12:00+1"}
+ *   {"type": "stat", "name": "reachable_airports", "airport": "OPO", "stops": 2}
+ *   {"type": "reload"}
+ * and an optional "id" that is echoed back. Each answer carries "ok", "version" (of the snapshot
+ * that answered it), "elapsed_us" (the time spent answering, without writing the JSON) and either
+ * "result" or "error".
+ *
+ * run() may be called from several threads at once: queries only read their snapshot, which the
+ * Dataset hands out as const Search and Statistics views.
+ */
+class BatchRunner {
+public:
+    explicit BatchRunner(const std::string& datasetPath);
+    ~BatchRunner();
+    BatchRunner(const BatchRunner&) = delete;
+    BatchRunner& operator=(const BatchRunner&) = delete;
+
+    std::string getLoadReport() const;
+    std::shared_ptr<const Dataset> getSnapshot() const;
+    bool reload(std::string* report = nullptr);
+    void startWatching(int intervalMs);
+    std::string run(const std::map<std::string, JsonValue>& query, bool* ok = nullptr);
+    std::string runLine(const std::string& line, bool* ok = nullptr);
+    long runAll(std::istream& in, std::ostream& out);
+
+    static std::vector<std::string> getStatisticNames();
+
+private:
+    std::string datasetPath;
+    std::shared_ptr<const Dataset> dataset;  // read and replaced only through std::atomic_load/atomic_store
+    long lastVersion = 1;
+    std::mutex reloadLock;  // one reload at a time
+
+    std::thread watcher;
+    std::mutex watchLock;
+    std::condition_variable watchStopped;
+    bool stopWatching = false;
+
+    std::string getFileSignature() const;
+    void watch(int intervalMs);
+
+    bool runSearch(const Dataset& data, const std::map<std::string, JsonValue>& query, std::string& result, std::string& error);
+    bool runFilteredSearch(const Dataset& data, const std::map<std::string, JsonValue>& query, std::string& result, std::string& error);
+    bool runSuggest(const Dataset& data, const std::map<std::string, JsonValue>& query, std::string& result, std::string& error);
+    bool runShortestRoute(const Dataset& data, const std::map<std::string, JsonValue>& query, std::string& result, std::string& error);
+    bool runEarliestArrival(const Dataset& data, const std::map<std::string, JsonValue>& query, std::string& result, std::string& error);
+    bool runProfile(const Dataset& data, const std::map<std::string, JsonValue>& query, std::string& result, std::string& error);
+    bool runStatistic(const Dataset& data, const std::map<std::string, JsonValue>& query, std::string& result, std::string& error);
+};
+
+#endif // BATCHRUNNER_H
@@ -0,0 +1,134 @@
+#include "Centrality.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+/**
+ * @brief Computes the exact betweenness centrality of every airport (Brandes' algorithm).
+ *
+ * The betweenness of v is the sum, over every ordered pair (s, t) with s != v != t, of the
+ * fraction of shortest s-t paths that go through v.
+ *
+ * @param graph CSR view of the airport graph.
+ * @param threads Number of threads (values below 1 use all hardware threads).
+ * @return A vector indexed by vertex id with the betweenness of each airport.
+ * @note Time complexity: O(V * E / T) where T is the number of threads.
+ */
+std::vector<double> Centrality::betweenness(const DenseGraph& graph, int threads) {
+    std::vector<int> sources(graph.getNumVertices());
+    std::iota(sources.begin(), sources.end(), 0);
+    return brandes(graph, sources, threads);
+}
+
+/**
+ * @brief Estimates the betweenness centrality from the shortest paths of a random sample of source airports.
+ * @param graph CSR view of the airport graph.
+ * @param pivots Number of sources to sample (the exact algorithm is used when it is not below the number of airports).
+ * @param seed Seed of the sampling, so results are repeatable.
+ * @param threads Number of threads (values below 1 use all hardware threads).
+ * @return A vector indexed by vertex id with the estimated betweenness, scaled to the exact range.
+ * @note Time complexity: O(P * E / T) for P pivots and T threads.
+ */
+std::vector<double> Centrality::approximateBetweenness(const DenseGraph& graph, int pivots, unsigned seed, int threads) {
+    int n = graph.getNumVertices();
+    if (pivots >= n) return betweenness(graph, threads);
+
+    std::vector<int> sources(n);
+    std::iota(sources.begin(), sources.end(), 0);
+    std::mt19937 random(seed);
+    std::shuffle(sources.begin(), sources.end(), random);
+    sources.resize(std::max(pivots, 1));
+
+    std::vector<double> scores = brandes(graph, sources, threads);
+    double scale = (double) n / sources.size();
+    for (double& score : scores) {
+        score *= scale;
+    }
+    return scores;
+}
+
+/**
+ * @brief Accumulates the dependencies of the given sources on every vertex.
+ *
+ * Sources are handed out to the threads dynamically; each thread keeps its own distance,
+ * path count, dependency and result arrays, and the results are summed at the end.
+ *
+ * @param graph CSR view of the airport graph.
+ * @param sources Source vertex ids.
+ * @param threads Number of threads (values below 1 use all hardware threads).
+ * @return A vector indexed by vertex id with the summed dependencies.
+ * @note Time complexity: O(S * E / T) for S sources and T threads.
+ */
+std::vector<double> Centrality::brandes(const DenseGraph& graph, const std::vector<int>& sources, int threads) {
+    struct Workspace {
+        std::vector<int> dist;
+        std::vector<double> sigma, delta, result;
+        std::vector<int> order;
+    };
+
+    int n = graph.getNumVertices();
+    if (threads < 1) threads = Parallel::defaultThreads();
+    std::vector<Workspace> workspaces(threads);
+
+    int used = Parallel::forEach(sources.size(), threads, [&](size_t i, int thread) {
+        Workspace& w = workspaces[thread];
+        if (w.result.empty()) {
+            w.dist.assign(n, -1);
+            w.sigma.assign(n, 0);
+            w.delta.assign(n, 0);
+            w.result.assign(n, 0);
+            w.order.reserve(n);
+        }
+
+        int s = sources[i];
+        w.order.clear();
+        w.order.push_back(s);
+        w.dist[s] = 0;
+        w.sigma[s] = 1;
+        for (size_t head = 0; head < w.order.size(); head++) {
+            int v = w.order[head];
+            for (int e = graph.offsets[v]; e < graph.offsets[v + 1]; e++) {
+                int t = graph.targets[e];
+                if (w.dist[t] < 0) {
+                    w.dist[t] = w.dist[v] + 1;
+                    w.order.push_back(t);
+                }
+                if (w.dist[t] == w.dist[v] + 1) {
+                    w.sigma[t] += w.sigma[v];
+                }
+            }
+        }
+
+        // Vertices in non-increasing distance order; the successors of v on shortest paths are one step further
+        for (size_t k = w.order.size(); k-- > 0;) {
+            int v = w.order[k];
+            double dependency = 0;
+            for (int e = graph.offsets[v]; e < graph.offsets[v + 1]; e++) {
+                int t = graph.targets[e];
+                if (w.dist[t] == w.dist[v] + 1) {
+                    dependency += w.sigma[v] / w.sigma[t] * (1 + w.delta[t]);
+                }
+            }
+            w.delta[v] = dependency;
+            if (v != s) {
+                w.result[v] += dependency;
+            }
+        }
+
+        for (int v : w.order) {
+            w.dist[v] = -1;
+            w.sigma[v] = 0;
+            w.delta[v] = 0;
+        }
+    });
+
+    std::vector<double> scores(n, 0);
+    for (int t = 0; t < used; t++) {
+        const Workspace& w = workspaces[t];
+        for (size_t v = 0; v < w.result.size(); v++) {
+            scores[v] += w.result[v];
+        }
+    }
+    return scores;
+}
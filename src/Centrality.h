@@ -0,0 +1,19 @@
+#ifndef CENTRALITY_H
+#define CENTRALITY_H
+
+#include "DenseGraph.h"
+#include <vector>
+
+/**
+ * @brief Betweenness centrality of the airports on the unweighted (stop count) route graph.
+ */
+class Centrality {
+public:
+    static std::vector<double> betweenness(const DenseGraph& graph, int threads = 0);
+    static std::vector<double> approximateBetweenness(const DenseGraph& graph, int pivots, unsigned seed = 42, int threads = 0);
+
+private:
+    static std::vector<double> brandes(const DenseGraph& graph, const std::vector<int>& sources, int threads);
+};
+
+#endif // CENTRALITY_H
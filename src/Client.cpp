@@ -0,0 +1,51 @@
+#include "Client.h"
+#include "Protocol.h"
+#include <unistd.h>
+
+Client::~Client() {
+    disconnect();
+}
+
+/**
+ * @brief Connects to a server listening on a Unix domain socket, closing any previous connection.
+ * @param path Path of the socket file.
+ * @return False if the connection failed.
+ */
+bool Client::connectUnix(const std::string& path) {
+    disconnect();
+    fd = Protocol::connectUnix(path);
+    return fd >= 0;
+}
+
+/**
+ * @brief Connects to a server listening on a loopback TCP port, closing any previous connection.
+ * @param port The port.
+ * @return False if the connection failed.
+ */
+bool Client::connectTcp(int port) {
+    disconnect();
+    fd = Protocol::connectTcp(port);
+    return fd >= 0;
+}
+
+bool Client::isConnected() const {
+    return fd >= 0;
+}
+
+/**
+ * @brief Sends one query and waits for its answer.
+ * @param query A JSON query object.
+ * @param answer Set to the JSON answer.
+ * @return False if the connection failed, in which case it is closed.
+ */
+bool Client::request(const std::string& query, std::string& answer) {
+    if (fd < 0) return false;
+    if (Protocol::writeFrame(fd, query) && Protocol::readFrame(fd, answer)) return true;
+    disconnect();
+    return false;
+}
+
+void Client::disconnect() {
+    if (fd >= 0) close(fd);
+    fd = -1;
+}
@@ -0,0 +1,26 @@
+#ifndef CLIENT_H
+#define CLIENT_H
+
+#include <string>
+
+/**
+ * @brief Connection to a query Server: sends query objects and waits for each answer.
+ */
+class Client {
+public:
+    Client() = default;
+    ~Client();
+    Client(const Client&) = delete;
+    Client& operator=(const Client&) = delete;
+
+    bool connectUnix(const std::string& path);
+    bool connectTcp(int port);
+    bool isConnected() const;
+    bool request(const std::string& query, std::string& answer);
+    void disconnect();
+
+private:
+    int fd = -1;
+};
+
+#endif // CLIENT_H
@@ -0,0 +1,155 @@
+#include "Condensation.h"
+#include "MemoryReport.h"
+
+/**
+ * @brief Builds the condensation DAG of the airport graph.
+ *
+ * Every strongly connected component becomes a single node and every route between
+ * two different components becomes a (deduplicated) DAG edge.
+ *
+ * @param graph Reference to the graph of airports.
+ * @note Time complexity: O(V + E log E) where V is the number of airports and E is the number of routes.
+ */
+Condensation::Condensation(const Graph<Airport>& graph) : graph(&graph) {
+    componentOf = graph.sccIds(numComponents);
+    componentSizes.assign(numComponents, 0);
+    dag.assign(numComponents, std::vector<int>());
+
+    for (const auto* vertex : graph.getVertexSet()) {
+        int from = componentOf[vertex->getId()];
+        componentSizes[from]++;
+        for (const auto& edge : vertex->getAdj()) {
+            int to = componentOf[edge.getDest()->getId()];
+            if (to != from) {
+                dag[from].push_back(to);
+            }
+        }
+    }
+
+    for (auto& successors : dag) {
+        std::sort(successors.begin(), successors.end());
+        successors.erase(std::unique(successors.begin(), successors.end()), successors.end());
+    }
+}
+
+/**
+ * @brief Gets the number of strongly connected components.
+ * @return Number of components.
+ * @note Time complexity: O(1)
+ */
+int Condensation::getNumComponents() const {
+    return numComponents;
+}
+
+/**
+ * @brief Gets the component of a vertex of the graph the condensation was built from.
+ * @param vertex The vertex.
+ * @return The component number, or -1 if the vertex is unknown.
+ * @note Time complexity: O(1)
+ */
+int Condensation::getComponent(const Vertex<Airport>* vertex) const {
+    if (!vertex || vertex->getId() < 0 || vertex->getId() >= (int) componentOf.size()) return -1;
+    return componentOf[vertex->getId()];
+}
+
+/**
+ * @brief Gets the number of airports in each component.
+ * @return A vector indexed by component number.
+ * @note Time complexity: O(1)
+ */
+const std::vector<int>& Condensation::getComponentSizes() const {
+    return componentSizes;
+}
+
+/**
+ * @brief Gets the adjacency of the condensation DAG.
+ * @return A vector indexed by component number with the sorted successor components.
+ * @note Time complexity: O(1)
+ */
+const std::vector<std::vector<int>>& Condensation::getDag() const {
+    return dag;
+}
+
+/**
+ * @brief Checks whether any airport of a component can reach any airport of another.
+ *
+ * Components are numbered in reverse topological order, so a component can only reach
+ * components with a lower or equal number. That test alone rejects most impossible
+ * pairs; the remaining ones run a DFS on the DAG restricted to the components in between.
+ *
+ * @param fromComponent Source component.
+ * @param toComponent Target component.
+ * @return True if there is a path in the DAG, false otherwise.
+ * @note Time complexity: O(1) for the same component or a rejected order, O(C + D) otherwise,
+ *       where C and D are the number of components and DAG edges.
+ */
+bool Condensation::canReach(int fromComponent, int toComponent) const {
+    if (fromComponent < 0 || toComponent < 0) return false;
+    if (fromComponent == toComponent) return true;
+    if (fromComponent < toComponent) return false;
+
+    std::vector<char> visited(fromComponent + 1, false);
+    std::vector<int> stack = {fromComponent};
+    visited[fromComponent] = true;
+
+    while (!stack.empty()) {
+        int c = stack.back();
+        stack.pop_back();
+        for (int next : dag[c]) {
+            if (next == toComponent) return true;
+            if (next > toComponent && !visited[next]) {
+                visited[next] = true;
+                stack.push_back(next);
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Checks whether there is any route between two airports.
+ * @param source Source airport.
+ * @param destination Destination airport.
+ * @return True if the destination is reachable from the source, false otherwise.
+ * @note Time complexity: see canReach().
+ */
+bool Condensation::routeExists(const Airport& source, const Airport& destination) const {
+    if (!graph) return true;
+    return canReach(getComponent(graph->findVertex(source)), getComponent(graph->findVertex(destination)));
+}
+
+/**
+ * @brief Patches the condensation after a route was added to the graph.
+ *
+ * A route inside a component changes nothing. A route from a higher to a lower numbered
+ * component keeps the numbering in reverse topological order and only adds a DAG edge. A route
+ * the other way may merge components or break the numbering, so the condensation must be rebuilt.
+ *
+ * Removed routes need no patch: the condensation then over-approximates reachability, which
+ * routeExists() callers only use to skip searches that cannot succeed.
+ *
+ * @param source Source vertex of the new route.
+ * @param destination Destination vertex of the new route.
+ * @return False if the condensation must be rebuilt.
+ * @note Time complexity: O(D) where D is the number of DAG edges leaving the source component.
+ */
+bool Condensation::addRoute(const Vertex<Airport>* source, const Vertex<Airport>* destination) {
+    int from = getComponent(source), to = getComponent(destination);
+    if (from < 0 || to < 0) return false;
+    if (from == to) return true;
+    if (from < to) return false;
+
+    auto& successors = dag[from];
+    auto it = std::lower_bound(successors.begin(), successors.end(), to);
+    if (it == successors.end() || *it != to) successors.insert(it, to);
+    return true;
+}
+
+/**
+ * @brief Gets the heap bytes of the component arrays and of the DAG's successor lists.
+ * @return The number of bytes.
+ * @note Time complexity: O(C) where C is the number of components.
+ */
+size_t Condensation::getBytes() const {
+    return MemoryReport::bytesOf(componentOf) + MemoryReport::bytesOf(componentSizes) + MemoryReport::bytesOf(dag);
+}
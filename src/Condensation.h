@@ -0,0 +1,33 @@
+#ifndef CONDENSATION_H
+#define CONDENSATION_H
+
+#include "Graph.h"
+#include "Airport.h"
+#include <vector>
+
+class Condensation {
+public:
+    Condensation() = default;
+    explicit Condensation(const Graph<Airport>& graph);
+
+    int getNumComponents() const;
+    int getComponent(const Vertex<Airport>* vertex) const;
+    const std::vector<int>& getComponentSizes() const;
+    const std::vector<std::vector<int>>& getDag() const;
+
+    bool canReach(int fromComponent, int toComponent) const;
+    bool routeExists(const Airport& source, const Airport& destination) const;
+
+    bool addRoute(const Vertex<Airport>* source, const Vertex<Airport>* destination);
+
+    size_t getBytes() const;
+
+private:
+    const Graph<Airport>* graph = nullptr;
+    int numComponents = 0;
+    std::vector<int> componentOf;             // vertex id -> component
+    std::vector<int> componentSizes;          // component -> number of airports
+    std::vector<std::vector<int>> dag;        // component -> successor components
+};
+
+#endif // CONDENSATION_H
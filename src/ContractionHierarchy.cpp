@@ -0,0 +1,590 @@
+#include "ContractionHierarchy.h"
+#include "Haversine.h"
+#include "Instrumentation.h"
+#include "MemoryReport.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <queue>
+
+namespace {
+
+const double Infinity = std::numeric_limits<double>::infinity();
+const uint32_t FileMagic = 0x48434c46;  // "FLCH"
+const uint32_t FileVersion = 2;  // 2: the route hash covers the airport coordinates
+// Witness searches give up after scanning this many arcs; a missed witness only costs a shortcut.
+// Estimating a priority only needs a count of shortcuts, so it gets a much smaller budget
+const int WitnessScanLimit = 5000;
+const int PriorityScanLimit = 300;
+// Airports with more pairs of neighbours than this get a bound instead of a simulated contraction as their priority
+const long HubPairs = 2500;
+// Once a round contracts fewer than 1 in this many of the airports left, what is left is a dense core of hubs
+const size_t CoreRatio = 8;
+
+struct WorkArc {
+    int node;
+    int middle;
+    double weight;
+};
+
+struct Shortcut {
+    int from;
+    int to;
+    int middle;
+    double weight;
+};
+
+using QueueEntry = std::pair<double, int>;
+using MinQueue = std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>>;
+
+// The graph being contracted; arcs to contracted airports are skipped until the lists are pruned
+struct Remaining {
+    std::vector<std::vector<WorkArc>> out, in;
+    std::vector<char> contracted;
+    std::vector<char> inRound;  // being contracted in the current round
+
+    bool live(int v) const {
+        return !contracted[v] && !inRound[v];
+    }
+};
+
+// One thread's Dijkstra state, reset through the list of airports it reached
+struct WitnessSearch {
+    std::vector<double> dist;
+    std::vector<int> reached;
+    std::vector<char> target;
+    MinQueue queue;
+
+    // Stops once every target is settled, past the limit or after scanning scanLimit arcs
+    void run(const Remaining& graph, int source, int skip, double limit, int targets, int scanLimit) {
+        dist[source] = 0;
+        reached.push_back(source);
+        queue.push({0, source});
+        while (!queue.empty() && targets > 0 && scanLimit > 0) {
+            QueueEntry top = queue.top();
+            queue.pop();
+            int u = top.second;
+            if (top.first > dist[u]) continue;
+            if (top.first > limit) break;
+            if (target[u] && u != source) targets--;
+            scanLimit -= graph.out[u].size();
+            for (const auto& arc : graph.out[u]) {
+                int x = arc.node;
+                if (x == skip || !graph.live(x)) continue;
+                double candidate = top.first + arc.weight;
+                if (candidate < dist[x]) {
+                    if (dist[x] == Infinity) reached.push_back(x);
+                    dist[x] = candidate;
+                    queue.push({candidate, x});
+                }
+            }
+        }
+        while (!queue.empty()) queue.pop();
+    }
+
+    void reset() {
+        for (int v : reached) dist[v] = Infinity;
+        reached.clear();
+    }
+};
+
+/*
+ * The shortcuts contracting v adds: u -> x for every route u -> v -> x whose length no witness
+ * path, avoiding v and the airports contracted in the same round, matches.
+ */
+std::vector<Shortcut> findShortcuts(const Remaining& graph, int v, WitnessSearch& search, int scanLimit) {
+    std::vector<Shortcut> shortcuts;
+    if (search.dist.empty()) {
+        search.dist.assign(graph.out.size(), Infinity);
+        search.target.assign(graph.out.size(), 0);
+    }
+    double longestOut = 0;
+    int targets = 0;
+    for (const auto& arc : graph.out[v]) {
+        if (!graph.live(arc.node)) continue;
+        longestOut = std::max(longestOut, arc.weight);
+        search.target[arc.node] = 1;
+        targets++;
+    }
+    for (const auto& in : graph.in[v]) {
+        int u = in.node;
+        if (!graph.live(u)) continue;
+        search.run(graph, u, v, in.weight + longestOut, targets - search.target[u], scanLimit);
+        for (const auto& out : graph.out[v]) {
+            int x = out.node;
+            if (x == u || !graph.live(x)) continue;
+            if (search.dist[x] > in.weight + out.weight) shortcuts.push_back({u, x, v, in.weight + out.weight});
+        }
+        search.reset();
+    }
+    for (const auto& arc : graph.out[v]) search.target[arc.node] = 0;
+    return shortcuts;
+}
+
+// Adds an arc, or shortens the one already there
+bool addArc(std::vector<WorkArc>& arcs, int node, int middle, double weight) {
+    for (auto& arc : arcs) {
+        if (arc.node != node) continue;
+        if (weight < arc.weight) arc = {node, middle, weight};
+        return false;
+    }
+    arcs.push_back({node, middle, weight});
+    return true;
+}
+
+// FNV-1a over the airports, their coordinates and the routes, so a saved hierarchy is not used with different
+// flights or with routes whose great-circle lengths changed
+uint64_t hashRoutes(const DenseGraph& graph) {
+    uint64_t hash = 1469598103934665603ULL;
+    auto mix = [&hash](uint64_t value) {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    };
+    auto bitsOf = [](double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    };
+    for (int v = 0; v < graph.getNumVertices(); v++) {
+        const Airport& airport = graph.vertices[v]->getInfo();
+        mix(airport.getCodeKey());
+        mix(bitsOf(airport.getLatitude()));
+        mix(bitsOf(airport.getLongitude()));
+        for (int i = graph.offsets[v]; i < graph.offsets[v + 1]; i++) mix((uint64_t) graph.targets[i]);
+    }
+    return hash;
+}
+
+template <class T>
+void writeArray(std::ofstream& file, const std::vector<T>& values) {
+    file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+template <class T>
+bool readArray(std::ifstream& file, std::vector<T>& values, uint64_t size) {
+    values.resize(size);
+    file.read(reinterpret_cast<char*>(values.data()), size * sizeof(T));
+    return (bool) file;
+}
+
+}
+
+/**
+ * @brief Constructor: contracts the route graph.
+ * @param graph CSR view of the airport graph; routes are weighted by great-circle distance.
+ * @param threads Number of threads (values below 1 use all hardware threads).
+ * @note Time complexity: O(V * D^2 * W / T) in practice, where D is the degree of the airports when they
+ *       are contracted, W the cost of a witness search (bounded) and T the number of threads.
+ */
+ContractionHierarchy::ContractionHierarchy(const DenseGraph& graph, int threads)
+        : vertices(graph.vertices), routeHash(hashRoutes(graph)) {
+    INSTRUMENT_SCOPE(BuildHierarchy);
+    contract(graph, threads);
+}
+
+/**
+ * @brief Contracts the airports in rounds of independent ones and stores the upward arcs.
+ * @param graph CSR view of the airport graph.
+ * @param threads Number of threads (values below 1 use all hardware threads).
+ */
+void ContractionHierarchy::contract(const DenseGraph& graph, int threads) {
+    int n = graph.getNumVertices();
+    if (threads < 1) threads = Parallel::defaultThreads();
+
+    Remaining remaining;
+    remaining.out.resize(n);
+    remaining.in.resize(n);
+    remaining.contracted.assign(n, 0);
+    remaining.inRound.assign(n, 0);
+    for (int v = 0; v < n; v++) {
+        const Airport& from = vertices[v]->getInfo();
+        for (int i = graph.offsets[v]; i < graph.offsets[v + 1]; i++) {
+            int w = graph.targets[i];
+            if (w == v) continue;
+            double length = routeLength(from, vertices[w]->getInfo());
+            remaining.out[v].push_back({w, -1, length});
+            remaining.in[w].push_back({v, -1, length});
+        }
+    }
+
+    std::vector<WitnessSearch> searches(threads);
+    std::vector<int> contractedNeighbours(n, 0);
+    std::vector<int> priority(n);
+    auto updatePriority = [&](int v, int thread) {
+        int in = 0, out = 0;
+        for (const auto& arc : remaining.out[v]) out += remaining.live(arc.node);
+        for (const auto& arc : remaining.in[v]) in += remaining.live(arc.node);
+        // Hubs are contracted last anyway; every pair of their neighbours is a bound cheap enough to recompute each round
+        long shortcuts = (long) in * out > HubPairs ? (long) in * out : (long) findShortcuts(remaining, v, searches[thread], PriorityScanLimit).size();
+        priority[v] = (int) std::min<long>(shortcuts - in - out + contractedNeighbours[v], std::numeric_limits<int>::max());
+    };
+    Parallel::forEach(n, threads, [&](size_t v, int thread) { updatePriority((int) v, thread); });
+
+    std::vector<std::vector<Arc>> up(n), down(n);
+    rank.assign(n, -1);
+    std::vector<int> live(n), selected, touched;
+    for (int v = 0; v < n; v++) live[v] = v;
+    std::vector<char> isSelected(n, 0), isTouched(n, 0);
+    std::vector<std::vector<Shortcut>> shortcuts;
+    int next = 0;
+    numShortcuts = 0;
+    bool core = false;  // priorities are no longer simulated, only raised by the neighbours contracted
+
+    while (!live.empty()) {
+        // Airports whose (priority, id) is below that of every live neighbour; the lowest one always is
+        Parallel::forRange(live.size(), threads, [&](size_t begin, size_t end, int) {
+            for (size_t i = begin; i < end; i++) {
+                int v = live[i];
+                auto lower = [&](int w) {
+                    return priority[w] < priority[v] || (priority[w] == priority[v] && w < v);
+                };
+                bool minimal = true;
+                for (const auto& arc : remaining.out[v]) minimal = minimal && (remaining.contracted[arc.node] || !lower(arc.node));
+                for (const auto& arc : remaining.in[v]) minimal = minimal && (remaining.contracted[arc.node] || !lower(arc.node));
+                isSelected[v] = minimal;
+            }
+        });
+        selected.clear();
+        for (int v : live) {
+            if (isSelected[v]) selected.push_back(v);
+        }
+        for (int v : selected) remaining.inRound[v] = 1;
+        core = core || selected.size() * CoreRatio < live.size();
+
+        shortcuts.assign(selected.size(), {});
+        Parallel::forEach(selected.size(), threads, [&](size_t i, int thread) {
+            shortcuts[i] = findShortcuts(remaining, selected[i], searches[thread], WitnessScanLimit);
+        });
+
+        touched.clear();
+        for (size_t i = 0; i < selected.size(); i++) {
+            int v = selected[i];
+            rank[v] = next++;
+            // The arcs to the airports still there lead upwards
+            for (const auto& arc : remaining.out[v]) {
+                if (remaining.contracted[arc.node]) continue;
+                up[v].push_back({arc.node, arc.middle, arc.weight});
+                contractedNeighbours[arc.node]++;
+                priority[arc.node] += core;
+                if (!isTouched[arc.node]) touched.push_back(arc.node);
+                isTouched[arc.node] = 1;
+            }
+            for (const auto& arc : remaining.in[v]) {
+                if (remaining.contracted[arc.node]) continue;
+                down[v].push_back({arc.node, arc.middle, arc.weight});
+                contractedNeighbours[arc.node]++;
+                priority[arc.node] += core;
+                if (!isTouched[arc.node]) touched.push_back(arc.node);
+                isTouched[arc.node] = 1;
+            }
+            for (const auto& shortcut : shortcuts[i]) {
+                if (addArc(remaining.out[shortcut.from], shortcut.to, shortcut.middle, shortcut.weight)) numShortcuts++;
+                addArc(remaining.in[shortcut.to], shortcut.from, shortcut.middle, shortcut.weight);
+            }
+        }
+        for (int v : selected) {
+            remaining.contracted[v] = 1;
+            remaining.inRound[v] = 0;
+            isSelected[v] = 0;
+            std::vector<WorkArc>().swap(remaining.out[v]);
+            std::vector<WorkArc>().swap(remaining.in[v]);
+        }
+
+        // Neighbours lose their arcs to the contracted airports and, outside the core, get a new priority;
+        // in the core every airport neighbours most others, and simulating them all each round would dominate
+        auto isContracted = [&](const WorkArc& arc) { return remaining.contracted[arc.node] != 0; };
+        for (int w : touched) {
+            auto& out = remaining.out[w];
+            auto& in = remaining.in[w];
+            out.erase(std::remove_if(out.begin(), out.end(), isContracted), out.end());
+            in.erase(std::remove_if(in.begin(), in.end(), isContracted), in.end());
+            isTouched[w] = 0;
+        }
+        if (!core) Parallel::forEach(touched.size(), threads, [&](size_t i, int thread) { updatePriority(touched[i], thread); });
+
+        live.erase(std::remove_if(live.begin(), live.end(), [&](int v) { return remaining.contracted[v] != 0; }), live.end());
+    }
+
+    upOffsets.assign(n + 1, 0);
+    downOffsets.assign(n + 1, 0);
+    for (int v = 0; v < n; v++) {
+        upOffsets[v + 1] = upOffsets[v] + up[v].size();
+        downOffsets[v + 1] = downOffsets[v] + down[v].size();
+    }
+    upArcs.clear();
+    downArcs.clear();
+    upArcs.reserve(upOffsets[n]);
+    downArcs.reserve(downOffsets[n]);
+    for (int v = 0; v < n; v++) {
+        upArcs.insert(upArcs.end(), up[v].begin(), up[v].end());
+        downArcs.insert(downArcs.end(), down[v].begin(), down[v].end());
+    }
+}
+
+/**
+ * @brief Writes the hierarchy to a binary file, together with the airports and routes it was built for.
+ * @param filename The file to write.
+ * @return False if there is no hierarchy or the file could not be written.
+ * @note Time complexity: O(V + A) where A is the number of arcs.
+ */
+bool ContractionHierarchy::save(const std::string& filename) const {
+    if (empty()) return false;
+    std::ofstream file(filename, std::ios::binary);
+    if (!file) return false;
+
+    uint64_t header[] = {FileMagic, FileVersion, vertices.size(), upArcs.size(), downArcs.size(), numShortcuts, routeHash};
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    std::vector<uint64_t> codes;
+    for (const auto* vertex : vertices) codes.push_back(vertex->getInfo().getCodeKey());
+    writeArray(file, codes);
+    writeArray(file, rank);
+    writeArray(file, upOffsets);
+    writeArray(file, upArcs);
+    writeArray(file, downOffsets);
+    writeArray(file, downArcs);
+    return (bool) file;
+}
+
+/**
+ * @brief Reads a hierarchy written by save(), if it was built for the same airports, at the same coordinates, and
+ *        the same routes as a graph.
+ * @param graph CSR view of the airport graph the hierarchy is for.
+ * @param filename The file to read.
+ * @return False, leaving the hierarchy unchanged, if the file could not be read or is for another graph.
+ * @note Time complexity: O(V + E + A) where A is the number of arcs.
+ */
+bool ContractionHierarchy::load(const DenseGraph& graph, const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) return false;
+    uint64_t header[7];
+    if (!file.read(reinterpret_cast<char*>(header), sizeof(header))) return false;
+    uint64_t n = graph.getNumVertices();
+    if (header[0] != FileMagic || header[1] != FileVersion || header[2] != n || header[6] != hashRoutes(graph)) return false;
+
+    ContractionHierarchy loaded;
+    loaded.vertices = graph.vertices;
+    loaded.numShortcuts = header[5];
+    loaded.routeHash = header[6];
+    std::vector<uint64_t> codes;
+    if (!readArray(file, codes, n) || !readArray(file, loaded.rank, n) || !readArray(file, loaded.upOffsets, n + 1)
+        || !readArray(file, loaded.upArcs, header[3]) || !readArray(file, loaded.downOffsets, n + 1)
+        || !readArray(file, loaded.downArcs, header[4])) {
+        return false;
+    }
+
+    // Reject anything a query could index out of bounds with
+    for (uint64_t v = 0; v < n; v++) {
+        if (codes[v] != graph.vertices[v]->getInfo().getCodeKey() || loaded.rank[v] < 0 || (uint64_t) loaded.rank[v] >= n) return false;
+    }
+    auto validOffsets = [n](const std::vector<int>& offsets, uint64_t arcs) {
+        if (offsets[0] != 0 || (uint64_t) offsets[n] != arcs) return false;
+        for (uint64_t v = 0; v < n; v++) {
+            if (offsets[v] > offsets[v + 1]) return false;
+        }
+        return true;
+    };
+    auto validArcs = [n](const std::vector<Arc>& arcs) {
+        for (const auto& arc : arcs) {
+            if (arc.node < 0 || (uint64_t) arc.node >= n || arc.middle < -1 || arc.middle >= (long long) n || !(arc.weight >= 0)) return false;
+        }
+        return true;
+    };
+    if (!validOffsets(loaded.upOffsets, header[3]) || !validOffsets(loaded.downOffsets, header[4])
+        || !validArcs(loaded.upArcs) || !validArcs(loaded.downArcs)) {
+        return false;
+    }
+    *this = std::move(loaded);
+    return true;
+}
+
+bool ContractionHierarchy::empty() const {
+    return rank.empty();
+}
+
+int ContractionHierarchy::getNumVertices() const {
+    return rank.size();
+}
+
+/**
+ * @brief Gets the number of upward arcs, routes and shortcuts.
+ * @return Number of arcs.
+ */
+size_t ContractionHierarchy::getNumArcs() const {
+    return upArcs.size() + downArcs.size();
+}
+
+size_t ContractionHierarchy::getNumShortcuts() const {
+    return numShortcuts;
+}
+
+/**
+ * @brief Estimates the bytes held by the hierarchy.
+ * @return The number of bytes.
+ */
+size_t ContractionHierarchy::getBytes() const {
+    return MemoryReport::bytesOf(vertices) + MemoryReport::bytesOf(rank) + MemoryReport::bytesOf(upOffsets)
+           + MemoryReport::bytesOf(upArcs) + MemoryReport::bytesOf(downOffsets) + MemoryReport::bytesOf(downArcs);
+}
+
+/**
+ * @brief Finds the shortest route in kilometres from any source to any target.
+ *
+ * Two Dijkstra searches, forwards from the sources and backwards from the targets, only follow
+ * arcs to higher airports, and stop once their next distance is not below the best route through
+ * an airport both reached. An airport is not expanded when a higher one proves it was reached by
+ * a shorter path (stall-on-demand). The route is then unpacked from the shortcuts.
+ *
+ * @param sources Vertex ids of the origin airports.
+ * @param targets Vertex ids of the destination airports.
+ * @return The route; no vertices if no target is reachable or there is no hierarchy.
+ * @note Time complexity: O(S log S) where S is the size of the two search spaces, typically a few hundred airports.
+ */
+ContractionHierarchy::Route ContractionHierarchy::shortestRoute(const std::vector<int>& sources, const std::vector<int>& targets) const {
+    INSTRUMENT_SCOPE(ShortestRoute);
+    Route route{Infinity, {}};
+    int n = getNumVertices();
+    if (n == 0) return route;
+
+    // Forward (0) and backward (1) search state, kept per thread and reset through the airports reached
+    struct Workspace {
+        std::vector<double> dist[2];
+        std::vector<int> parent[2];
+        std::vector<int> middle[2];
+        std::vector<int> reached;
+    };
+    thread_local Workspace w;
+    if ((int) w.dist[0].size() != n) {
+        for (int side = 0; side < 2; side++) {
+            w.dist[side].assign(n, Infinity);
+            w.parent[side].assign(n, -1);
+            w.middle[side].assign(n, -1);
+        }
+        w.reached.clear();
+    }
+
+    MinQueue queues[2];
+    for (int side = 0; side < 2; side++) {
+        for (int v : side == 0 ? sources : targets) {
+            if (v < 0 || v >= n || w.dist[side][v] == 0) continue;
+            w.dist[side][v] = 0;
+            w.reached.push_back(v);
+            queues[side].push({0, v});
+        }
+    }
+
+    double best = Infinity;
+    int meeting = -1;
+    long dequeued = 0, scanned = 0;
+    while (true) {
+        // Expand the side with the smaller next distance, while it can still improve the best route
+        int side = -1;
+        for (int s = 0; s < 2; s++) {
+            if (!queues[s].empty() && queues[s].top().first < best && (side < 0 || queues[s].top().first < queues[side].top().first)) side = s;
+        }
+        if (side < 0) break;
+        QueueEntry top = queues[side].top();
+        queues[side].pop();
+        int v = top.second;
+        double d = top.first;
+        if (d > w.dist[side][v]) continue;
+        dequeued++;
+        if (d + w.dist[1 - side][v] < best) {
+            best = d + w.dist[1 - side][v];
+            meeting = v;
+        }
+
+        // Forwards, the arcs arriving from higher airports can prove v was reached the long way; backwards, those leaving to them
+        const std::vector<Arc>& stallArcs = side == 0 ? downArcs : upArcs;
+        const std::vector<int>& stallOffsets = side == 0 ? downOffsets : upOffsets;
+        bool stalled = false;
+        for (int i = stallOffsets[v]; i < stallOffsets[v + 1] && !stalled; i++) {
+            stalled = w.dist[side][stallArcs[i].node] + stallArcs[i].weight < d;
+        }
+        if (stalled) continue;
+
+        const std::vector<Arc>& arcs = side == 0 ? upArcs : downArcs;
+        const std::vector<int>& offsets = side == 0 ? upOffsets : downOffsets;
+        for (int i = offsets[v]; i < offsets[v + 1]; i++) {
+            const Arc& arc = arcs[i];
+            scanned++;
+            double candidate = d + arc.weight;
+            if (candidate < w.dist[side][arc.node]) {
+                if (w.dist[0][arc.node] == Infinity && w.dist[1][arc.node] == Infinity) w.reached.push_back(arc.node);
+                w.dist[side][arc.node] = candidate;
+                w.parent[side][arc.node] = v;
+                w.middle[side][arc.node] = arc.middle;
+                queues[side].push({candidate, arc.node});
+            }
+        }
+    }
+    INSTRUMENT_COUNT(VerticesDequeued, dequeued);
+    INSTRUMENT_COUNT(EdgesScanned, scanned);
+
+    if (meeting >= 0) {
+        // Up the forward search tree from the meeting airport, then down the backward one
+        std::vector<int> chain;
+        for (int v = meeting; v >= 0; v = w.parent[0][v]) chain.push_back(v);
+        std::reverse(chain.begin(), chain.end());
+        std::vector<int> path{chain[0]};
+        for (size_t i = 1; i < chain.size(); i++) unpack(chain[i - 1], chain[i], w.middle[0][chain[i]], path);
+        for (int v = meeting; w.parent[1][v] >= 0; v = w.parent[1][v]) unpack(v, w.parent[1][v], w.middle[1][v], path);
+
+        route.distance = best;
+        for (int v : path) route.path.push_back(vertices[v]);
+    }
+
+    for (int v : w.reached) {
+        for (int side = 0; side < 2; side++) {
+            w.dist[side][v] = Infinity;
+            w.parent[side][v] = -1;
+            w.middle[side][v] = -1;
+        }
+    }
+    w.reached.clear();
+    return route;
+}
+
+/**
+ * @brief Gets the great-circle distance of a route.
+ * @param from The departure airport.
+ * @param to The arrival airport.
+ * @return The distance in kilometres.
+ */
+double ContractionHierarchy::routeLength(const Airport& from, const Airport& to) {
+    return Haversine::haversineDistance(from.getLatitude(), from.getLongitude(), to.getLatitude(), to.getLongitude());
+}
+
+// The arc between two airports, stored at the lower one
+const ContractionHierarchy::Arc* ContractionHierarchy::findArc(int from, int to) const {
+    bool upwards = rank[to] > rank[from];
+    const std::vector<Arc>& arcs = upwards ? upArcs : downArcs;
+    int lower = upwards ? from : to, other = upwards ? to : from;
+    const std::vector<int>& offsets = upwards ? upOffsets : downOffsets;
+    for (int i = offsets[lower]; i < offsets[lower + 1]; i++) {
+        if (arcs[i].node == other) return &arcs[i];
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Appends the airports after from on the route an arc stands for, up to and including to.
+ * @param from Airport the arc leaves.
+ * @param to Airport it arrives at.
+ * @param middle Airport a shortcut bypasses, or -1 for a route.
+ * @param path The route so far, ending at from.
+ * @note Time complexity: O(L * D) where L is the number of routes unpacked and D the degree of the airports bypassed.
+ */
+void ContractionHierarchy::unpack(int from, int to, int middle, std::vector<int>& path) const {
+    if (middle < 0) {
+        path.push_back(to);
+        return;
+    }
+    const Arc* first = findArc(from, middle);
+    const Arc* second = findArc(middle, to);
+    unpack(from, middle, first ? first->middle : -1, path);
+    unpack(middle, to, second ? second->middle : -1, path);
+}
@@ -0,0 +1,71 @@
+#ifndef CONTRACTIONHIERARCHY_H
+#define CONTRACTIONHIERARCHY_H
+
+#include "DenseGraph.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Contraction hierarchy of the route graph weighted by great-circle distance, answering
+ *        kilometre-optimal route queries with two small upward searches.
+ *
+ * Preprocessing contracts the airports one by one, least important first: removing an airport adds
+ * a shortcut between each pair of its neighbours whose shortest path went through it, unless a
+ * witness search finds another path at most as long. The next airports are those with the lowest
+ * edge difference (shortcuts added minus routes removed) plus the number of neighbours already
+ * contracted; rounds contract every airport whose priority is lower than all of its neighbours' at
+ * once, on several threads, and their witness searches avoid each other.
+ *
+ * Every route and shortcut then leads from a lower to a higher airport in the contraction order. A
+ * query searches upwards from the origin over the routes leaving airports and upwards from the
+ * destination over the routes arriving at them, and meets in the middle; shortcuts remember the
+ * airport they bypass, so the route is unpacked recursively. Arcs are stored in CSR arrays over the
+ * vertex ids of the DenseGraph the hierarchy was built from.
+ */
+class ContractionHierarchy {
+public:
+    // A route and its length; no vertices if there is none
+    struct Route {
+        double distance;
+        std::vector<const Vertex<Airport>*> path;
+    };
+
+    ContractionHierarchy() = default;
+    explicit ContractionHierarchy(const DenseGraph& graph, int threads = 0);
+
+    bool save(const std::string& filename) const;
+    bool load(const DenseGraph& graph, const std::string& filename);
+
+    bool empty() const;
+    int getNumVertices() const;
+    size_t getNumArcs() const;
+    size_t getNumShortcuts() const;
+    size_t getBytes() const;
+
+    Route shortestRoute(const std::vector<int>& sources, const std::vector<int>& targets) const;
+
+    static double routeLength(const Airport& from, const Airport& to);
+
+private:
+    struct Arc {
+        int node;       // the higher airport at the other end
+        int middle;     // airport a shortcut bypasses, or -1 for a route
+        double weight;  // kilometres
+    };
+
+    std::vector<const Vertex<Airport>*> vertices;  // id -> vertex
+    std::vector<int> rank;                         // id -> position in the contraction order
+    std::vector<int> upOffsets;                    // routes from v to higher airports: upArcs[upOffsets[v] .. upOffsets[v + 1])
+    std::vector<Arc> upArcs;
+    std::vector<int> downOffsets;                  // routes from higher airports to v, stored at v
+    std::vector<Arc> downArcs;
+    size_t numShortcuts = 0;
+    uint64_t routeHash = 0;                        // of the routes it was built from
+
+    void contract(const DenseGraph& graph, int threads);
+    const Arc* findArc(int from, int to) const;
+    void unpack(int from, int to, int middle, std::vector<int>& path) const;
+};
+
+#endif // CONTRACTIONHIERARCHY_H
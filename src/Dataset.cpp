@@ -0,0 +1,79 @@
+#include "Dataset.h"
+#include "Read.h"
+#include <chrono>
+
+/**
+ * @brief Constructor: loads the CSV files and builds the query engine, with its contraction hierarchy and hop labels,
+ *        and the Search and Statistics views; a reload does all of it before any query sees the new version.
+ * @param path Directory holding airports.csv, airlines.csv and flights.csv, with a trailing '/', and optionally
+ *        timetable.csv, min_connection.csv and hierarchy.ch.
+ * @param version Version number reported with every answer computed on this dataset.
+ * @note Time complexity: that of loading the dataset and building the query engine, the hierarchy included
+ *       unless hierarchy.ch was read.
+ */
+Dataset::Dataset(const std::string& path, long version) : path(path), version(version) {
+    auto start = std::chrono::steady_clock::now();
+    Read reader;
+    reader.readAirports(airportGraph, path + "airports.csv");
+    reader.readAirlines(airlines, path + "airlines.csv");
+    reader.readFlights(airportGraph, path + "flights.csv");
+    engine.reset(new QueryEngine(airportGraph, airlines));
+    if (reader.readTimetable(engine->getTimetable(), path + "timetable.csv")) {
+        reader.readMinConnectionTimes(engine->getTimetable(), path + "min_connection.csv");
+    }
+    engine->loadHierarchy(path + "hierarchy.ch");
+    engine->buildRouteIndexes();
+    search.reset(new Search(*engine));
+    statistics.reset(new Statistics(*engine));
+    loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Destructor: frees the indexes, then the vertices and edges of the graph.
+ */
+Dataset::~Dataset() {
+    statistics.reset();
+    search.reset();
+    engine.reset();
+    airportGraph.clear();
+}
+
+long Dataset::getVersion() const {
+    return version;
+}
+
+const std::string& Dataset::getPath() const {
+    return path;
+}
+
+double Dataset::getLoadMs() const {
+    return loadMs;
+}
+
+/**
+ * @brief Tells whether the dataset has no airports, which is what loading a missing directory gives.
+ * @return True if there are no airports.
+ */
+bool Dataset::isEmpty() const {
+    return airportGraph.getNumVertex() == 0;
+}
+
+const Graph<Airport>& Dataset::getGraph() const {
+    return airportGraph;
+}
+
+long Dataset::getNumAirlines() const {
+    return (long) airlines.size();
+}
+
+const Search& Dataset::getSearch() const {
+    return *search;
+}
+
+const Statistics& Dataset::getStatistics() const {
+    return *statistics;
+}
+
+const Timetable& Dataset::getTimetable() const {
+    return engine->getTimetable();
+}
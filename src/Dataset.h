@@ -0,0 +1,52 @@
+#ifndef DATASET_H
+#define DATASET_H
+
+#include "Graph.h"
+#include "Airport.h"
+#include "Airline.h"
+#include "QueryEngine.h"
+#include "Search.h"
+#include "Statistics.h"
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+/**
+ * @brief One loaded version of the dataset: the graph, the airlines, the query engine with every index
+ *        built on them, and the Search and Statistics views over it.
+ *
+ * A Dataset is never modified after construction, so any number of queries can read it at once;
+ * a reload builds a new one instead. Its memory, vertices included, is freed by its destructor,
+ * which runs when the last query pinning it lets go (see BatchRunner).
+ */
+class Dataset {
+public:
+    Dataset(const std::string& path, long version);
+    ~Dataset();
+    Dataset(const Dataset&) = delete;
+    Dataset& operator=(const Dataset&) = delete;
+
+    long getVersion() const;
+    const std::string& getPath() const;
+    double getLoadMs() const;
+    bool isEmpty() const;
+
+    const Graph<Airport>& getGraph() const;
+    long getNumAirlines() const;
+    const Search& getSearch() const;
+    const Statistics& getStatistics() const;
+    const Timetable& getTimetable() const;
+
+private:
+    std::string path;
+    long version;
+    double loadMs = 0;
+
+    Graph<Airport> airportGraph;
+    std::unordered_set<Airline> airlines;
+    std::unique_ptr<QueryEngine> engine;
+    std::unique_ptr<Search> search;
+    std::unique_ptr<Statistics> statistics;
+};
+
+#endif // DATASET_H
@@ -0,0 +1,417 @@
+#include "DatasetGenerator.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <unordered_set>
+
+namespace {
+
+enum Region { NorthAmerica, SouthAmerica, Europe, Africa, MiddleEast, Asia, Oceania, NumRegions };
+
+struct CountryProfile {
+    const char* name;
+    Region region;
+    double latitude;
+    double longitude;
+    double spread;  // standard deviation of city positions, in degrees
+    double share;   // airports in the bundled dataset
+};
+
+// Countries with the most airports in the bundled dataset, plus the main hubs of each region
+const CountryProfile countries[] = {
+        {"United States", NorthAmerica, 38.0, -97.0, 9.0, 539},
+        {"Canada", NorthAmerica, 53.0, -100.0, 10.0, 138},
+        {"Mexico", NorthAmerica, 23.0, -102.0, 4.5, 55},
+        {"Bahamas", NorthAmerica, 24.5, -77.0, 1.2, 17},
+        {"Panama", NorthAmerica, 8.5, -80.0, 1.0, 15},
+        {"Greenland", NorthAmerica, 68.0, -42.0, 6.0, 21},
+        {"Brazil", SouthAmerica, -12.0, -50.0, 8.0, 111},
+        {"Colombia", SouthAmerica, 4.5, -74.0, 3.0, 51},
+        {"Argentina", SouthAmerica, -36.0, -64.0, 6.0, 36},
+        {"Venezuela", SouthAmerica, 7.5, -66.0, 2.5, 23},
+        {"Peru", SouthAmerica, -9.5, -75.0, 3.0, 18},
+        {"Chile", SouthAmerica, -33.0, -71.0, 7.0, 15},
+        {"France", Europe, 46.5, 2.5, 2.5, 55},
+        {"Norway", Europe, 64.0, 12.0, 4.0, 50},
+        {"United Kingdom", Europe, 53.5, -2.0, 2.0, 49},
+        {"Spain", Europe, 40.0, -3.5, 2.5, 40},
+        {"Greece", Europe, 38.5, 23.5, 1.8, 37},
+        {"Italy", Europe, 42.5, 12.5, 2.5, 36},
+        {"Germany", Europe, 51.0, 10.0, 2.0, 32},
+        {"Sweden", Europe, 62.0, 16.0, 4.0, 31},
+        {"Finland", Europe, 64.0, 26.0, 3.0, 19},
+        {"Portugal", Europe, 39.5, -8.0, 1.5, 14},
+        {"Netherlands", Europe, 52.2, 5.3, 0.6, 6},
+        {"Poland", Europe, 52.0, 19.0, 2.0, 12},
+        {"Ukraine", Europe, 49.0, 31.0, 2.5, 12},
+        {"Russia", Asia, 58.0, 60.0, 15.0, 81},
+        {"Turkey", MiddleEast, 39.0, 35.0, 3.0, 43},
+        {"Iran", MiddleEast, 32.5, 53.5, 4.0, 38},
+        {"Saudi Arabia", MiddleEast, 24.0, 45.0, 4.0, 25},
+        {"United Arab Emirates", MiddleEast, 24.3, 54.3, 0.8, 6},
+        {"Pakistan", MiddleEast, 30.0, 70.0, 4.0, 22},
+        {"Egypt", Africa, 27.0, 30.0, 3.0, 12},
+        {"Algeria", Africa, 30.0, 3.0, 5.0, 26},
+        {"Morocco", Africa, 32.0, -6.5, 2.5, 10},
+        {"Nigeria", Africa, 9.0, 8.0, 3.0, 10},
+        {"Kenya", Africa, 0.5, 37.5, 2.0, 9},
+        {"Ethiopia", Africa, 9.0, 39.5, 3.0, 9},
+        {"South Africa", Africa, -29.0, 25.0, 4.0, 19},
+        {"Madagascar", Africa, -19.0, 46.5, 3.0, 10},
+        {"China", Asia, 32.0, 108.0, 9.0, 164},
+        {"India", Asia, 22.0, 79.0, 6.0, 71},
+        {"Japan", Asia, 36.0, 138.0, 4.0, 60},
+        {"Indonesia", Asia, -2.5, 118.0, 8.0, 58},
+        {"Philippines", Asia, 12.0, 122.0, 3.5, 36},
+        {"Malaysia", Asia, 3.5, 108.0, 4.0, 34},
+        {"Thailand", Asia, 14.5, 101.0, 3.0, 30},
+        {"Vietnam", Asia, 15.5, 106.5, 4.0, 21},
+        {"Kazakhstan", Asia, 48.0, 67.0, 6.0, 17},
+        {"South Korea", Asia, 36.5, 127.8, 1.2, 15},
+        {"Australia", Oceania, -26.0, 134.0, 9.0, 112},
+        {"New Zealand", Oceania, -41.0, 174.0, 3.0, 25},
+        {"Papua New Guinea", Oceania, -6.5, 145.0, 2.5, 26},
+        {"Vanuatu", Oceania, -16.0, 167.5, 1.5, 27},
+        {"French Polynesia", Oceania, -17.5, -149.5, 3.0, 27},
+        {"Solomon Islands", Oceania, -9.0, 160.0, 2.0, 17},
+};
+
+const int numCountries = sizeof(countries) / sizeof(countries[0]);
+
+// The bundled dataset, which a scale factor of 1 reproduces in size
+const long baseAirports = 3019;
+const long baseAirlines = 444;
+const long baseFlights = 63832;
+
+const char* const syllables[] = {
+        "ka", "lo", "ri", "ta", "ven", "mar", "sa", "do", "bel", "na", "por", "li", "an", "to", "ber",
+        "gu", "ra", "mi", "sel", "ko", "ha", "ne", "vil", "zu", "ar", "te", "lan", "bo", "cas", "di",
+        "fa", "ga", "jo", "ku", "me", "nor", "pe", "qui", "ru", "sto", "um", "va", "wen", "yo", "zel",
+};
+
+const int numSyllables = sizeof(syllables) / sizeof(syllables[0]);
+
+void appendCumulative(std::vector<double>& cumulative, double weight) {
+    cumulative.push_back((cumulative.empty() ? 0 : cumulative.back()) + weight);
+}
+
+}
+
+uint64_t DatasetGenerator::Random::next() {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+double DatasetGenerator::Random::uniform() {
+    return (next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+double DatasetGenerator::Random::normal() {
+    // Box-Muller, so no implementation-defined standard distribution is involved
+    double u = 1.0 - uniform();
+    return std::sqrt(-2.0 * std::log(u)) * std::cos(2 * M_PI * uniform());
+}
+
+double DatasetGenerator::Random::pareto(double alpha, double cap) {
+    return std::min(cap, std::pow(1.0 - uniform(), -1.0 / alpha));
+}
+
+size_t DatasetGenerator::Random::below(size_t n) {
+    return next() % n;
+}
+
+/**
+ * @brief Constructor: generates the airports; airlines and flights are streamed by write().
+ * @param scale Size relative to the bundled dataset (10 writes about 30k airports and 640k flights).
+ * @param seed Seed of the generator; the same scale and seed always produce the same files.
+ * @note Time complexity: O(A) where A is the number of airports.
+ */
+DatasetGenerator::DatasetGenerator(double scale, uint64_t seed)
+        : scale(scale), seed(seed),
+          numAirports(std::max(1L, std::lround(baseAirports * scale))),
+          numAirlines(std::max(1L, std::lround(baseAirlines * std::sqrt(scale)))) {
+    Random random(seed);
+    generateAirports(random);
+}
+
+/**
+ * @brief Places every airport in a city of a country, drawing its size from a heavy-tailed distribution.
+ * @param random Generator to draw from.
+ * @note Time complexity: O(A + C) where A is the number of airports and C the number of cities.
+ */
+void DatasetGenerator::generateAirports(Random& random) {
+    // Airports per country, proportional to the share in the bundled dataset (largest remainder)
+    double totalShare = 0;
+    for (const auto& country : countries) totalShare += country.share;
+    std::vector<long> perCountry(numCountries);
+    std::vector<std::pair<double, int>> remainders;
+    long assigned = 0;
+    for (int c = 0; c < numCountries; c++) {
+        double exact = numAirports * countries[c].share / totalShare;
+        perCountry[c] = (long) exact;
+        assigned += perCountry[c];
+        remainders.push_back({-(exact - perCountry[c]), c});
+    }
+    std::sort(remainders.begin(), remainders.end());
+    for (long i = 0; assigned < numAirports; i++, assigned++) perCountry[remainders[i % numCountries].second]++;
+
+    airports.reserve(numAirports);
+    countryAirports.assign(numCountries, {});
+    countryWeights.assign(numCountries, {});
+    regionAirports.assign(NumRegions, {});
+    regionWeights.assign(NumRegions, {});
+    std::unordered_set<std::string> usedNames;
+
+    for (int c = 0; c < numCountries; c++) {
+        const CountryProfile& profile = countries[c];
+        std::vector<int> cities;  // cities of this country, as indexes in cityNames
+        std::vector<std::pair<double, double>> cityCentres;
+        for (long i = 0; i < perCountry[c]; i++) {
+            // A quarter of the airports share a city with an earlier one
+            int local;
+            if (!cities.empty() && random.uniform() < 0.25) {
+                local = (int) random.below(cities.size());
+            } else {
+                std::string name = makeName(random);
+                for (int tries = 1; !usedNames.insert(name).second; tries++) {
+                    // Generated names have no spaces, so a numbered name cannot collide
+                    name = tries < 8 ? makeName(random) : name + " " + std::to_string(cityNames.size());
+                }
+                local = (int) cities.size();
+                cities.push_back((int) cityNames.size());
+                cityNames.push_back(name);
+                double latitude = std::max(-85.0, std::min(85.0, profile.latitude + profile.spread * random.normal()));
+                double longitude = std::remainder(profile.longitude + profile.spread * random.normal(), 360.0);
+                cityCentres.push_back({latitude, longitude});
+            }
+
+            GeneratedAirport airport;
+            airport.country = c;
+            airport.city = cities[local];
+            airport.latitude = std::max(-89.0, std::min(89.0, cityCentres[local].first + 0.15 * random.normal()));
+            airport.longitude = std::remainder(cityCentres[local].second + 0.15 * random.normal(), 360.0);
+            airport.size = random.pareto(1.1, 2000);
+
+            int id = (int) airports.size();
+            airports.push_back(airport);
+            countryAirports[c].push_back(id);
+            appendCumulative(countryWeights[c], airport.size);
+            regionAirports[profile.region].push_back(id);
+            appendCumulative(regionWeights[profile.region], airport.size);
+            appendCumulative(globalWeights, airport.size);
+        }
+    }
+}
+
+/**
+ * @brief Writes airports.csv, airlines.csv and flights.csv into a directory.
+ * @param directory Existing directory to write to.
+ * @return False if any of the files could not be written.
+ * @note Time complexity: O(A + L + F) for A airports, L airlines and F flights.
+ */
+bool DatasetGenerator::write(const std::string& directory) {
+    std::string prefix = directory.empty() || directory.back() == '/' ? directory : directory + "/";
+    // Airlines and flights have their own stream, so the airports do not depend on how they are drawn
+    Random random(seed ^ 0x5DEECE66DULL);
+    std::vector<int> homeCountries;
+    std::vector<double> sizes;
+    return writeAirports(prefix + "airports.csv")
+           && writeAirlines(prefix + "airlines.csv", random, homeCountries, sizes)
+           && writeFlights(prefix + "flights.csv", random, homeCountries, sizes);
+}
+
+/**
+ * @brief Writes every airport, named after its city and size.
+ * @param filename File to write.
+ * @return False if the file could not be written.
+ * @note Time complexity: O(A) where A is the number of airports.
+ */
+bool DatasetGenerator::writeAirports(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file) return false;
+    file << "Code,Name,City,Country,Latitude,Longitude\n";
+
+    std::vector<int> airportsInCity(cityNames.size(), 0);
+    char coordinates[64];
+    for (long i = 0; i < numAirports; i++) {
+        const GeneratedAirport& airport = airports[i];
+        const std::string& city = cityNames[airport.city];
+        int nth = ++airportsInCity[airport.city];
+        std::string name = city + (airport.size > 20 ? " International" : airport.size > 3 ? " Airport" : " Regional");
+        if (nth > 1) name += " " + std::to_string(nth);
+        snprintf(coordinates, sizeof(coordinates), "%.6f,%.6f", airport.latitude, airport.longitude);
+        file << makeCode(i, numAirports) << ',' << name << ',' << city << ','
+             << countries[airport.country].name << ',' << coordinates << '\n';
+    }
+    return (bool) file;
+}
+
+/**
+ * @brief Writes every airline, choosing its home country and its size.
+ * @param filename File to write.
+ * @param random Generator to draw from.
+ * @param homeCountries Filled with the home country of every airline.
+ * @param sizes Filled with the relative size of every airline.
+ * @return False if the file could not be written.
+ * @note Time complexity: O(L log N) for L airlines and N countries.
+ */
+bool DatasetGenerator::writeAirlines(const std::string& filename, Random& random, std::vector<int>& homeCountries, std::vector<double>& sizes) const {
+    std::ofstream file(filename);
+    if (!file) return false;
+    file << "Code,Name,Callsign,Country\n";
+
+    // Countries with more airports are home to more airlines
+    std::vector<double> countryTotals;
+    for (int c = 0; c < numCountries; c++) {
+        appendCumulative(countryTotals, countryWeights[c].empty() ? 0 : countryWeights[c].back());
+    }
+    const char* const kinds[] = {" Airlines", " Air", " Airways", " Aviation", " Express"};
+    for (long i = 0; i < numAirlines; i++) {
+        int country = pick(countryTotals, random);
+        homeCountries.push_back(country);
+        sizes.push_back(random.pareto(1.0, 500));
+
+        std::string name = makeName(random);
+        std::string callsign = name;
+        std::transform(callsign.begin(), callsign.end(), callsign.begin(), ::toupper);
+        file << makeCode(i, numAirlines) << ',' << name << kinds[random.below(5)] << ','
+             << callsign << ',' << countries[country].name << '\n';
+    }
+    return (bool) file;
+}
+
+/**
+ * @brief Writes the routes of every airline, from its hubs to mostly domestic and same-region airports.
+ * @param filename File to write.
+ * @param random Generator to draw from.
+ * @param homeCountries Home country of every airline.
+ * @param sizes Relative size of every airline; its share of the flights is proportional to it.
+ * @return False if the file could not be written.
+ * @note Time complexity: O(F log A) for F flights and A airports.
+ */
+bool DatasetGenerator::writeFlights(const std::string& filename, Random& random, const std::vector<int>& homeCountries, const std::vector<double>& sizes) {
+    std::ofstream file(filename);
+    if (!file) return false;
+    file << "Source,Target,Airline\n";
+
+    long routes = std::max(1L, std::lround(baseFlights * scale / 2));
+    double totalSize = 0;
+    for (double size : sizes) totalSize += size;
+
+    numFlights = 0;
+    long written = 0;
+    double sizeSoFar = 0;
+    std::unordered_set<uint64_t> airlineRoutes;
+    for (long a = 0; a < numAirlines; a++) {
+        // Budgets follow the running share of the sizes, so routes an airline could not place go to the next ones
+        sizeSoFar += sizes[a];
+        long budget = (a + 1 == numAirlines ? routes : std::lround(routes * sizeSoFar / totalSize)) - written;
+        int country = homeCountries[a];
+        Region region = countries[country].region;
+        if (budget <= 0 || countryAirports[country].empty()) continue;
+
+        // Hubs are the best of a few draws, so they are among the biggest airports of the country;
+        // large airlines get more of them
+        std::vector<int> hubs(1 + random.below(3) + budget / 1000);
+        for (int& hub : hubs) {
+            hub = countryAirports[country][pick(countryWeights[country], random)];
+            for (int draw = 0; draw < 2; draw++) {
+                int other = countryAirports[country][pick(countryWeights[country], random)];
+                if (airports[other].size > airports[hub].size) hub = other;
+            }
+        }
+
+        std::string airline = makeCode(a, numAirlines);
+        airlineRoutes.clear();
+        long added = 0;
+        for (long attempt = 0; added < budget && attempt < 8 * budget; attempt++) {
+            int hub = hubs[random.below(hubs.size())];
+            double where = random.uniform();
+            int destination;
+            if (where < 0.45) destination = countryAirports[country][pick(countryWeights[country], random)];
+            else if (where < 0.8) destination = regionAirports[region][pick(regionWeights[region], random)];
+            else destination = pick(globalWeights, random);
+            if (destination == hub) continue;
+            if (!airlineRoutes.insert((uint64_t) std::min(hub, destination) * numAirports + std::max(hub, destination)).second) continue;
+
+            std::string source = makeCode(hub, numAirports), target = makeCode(destination, numAirports);
+            file << source << ',' << target << ',' << airline << '\n'
+                 << target << ',' << source << ',' << airline << '\n';
+            added++;
+        }
+        written += added;
+        numFlights += 2 * added;
+    }
+    return (bool) file;
+}
+
+/**
+ * @brief Draws an index with probability proportional to its weight.
+ * @param cumulative Running sums of the weights.
+ * @param random Generator to draw from.
+ * @return The index drawn.
+ * @note Time complexity: O(log N).
+ */
+int DatasetGenerator::pick(const std::vector<double>& cumulative, Random& random) {
+    double target = random.uniform() * cumulative.back();
+    return (int) std::min(cumulative.size() - 1,
+                          (size_t) (std::upper_bound(cumulative.begin(), cumulative.end(), target) - cumulative.begin()));
+}
+
+/**
+ * @brief Builds a unique upper-case code: three letters while they suffice, more for larger datasets.
+ * @param index Index of the airport or airline.
+ * @param count Number of codes needed.
+ * @return The code; codes are scattered so neighbouring indexes do not share a prefix.
+ * @note Time complexity: O(log count).
+ */
+std::string DatasetGenerator::makeCode(long index, long count) {
+    int length = 3;
+    uint64_t space = 26 * 26 * 26;
+    while (space < (uint64_t) count) {
+        space *= 26;
+        length++;
+    }
+    // 7919 is coprime with 26, so this is a permutation of [0, space)
+    uint64_t value = ((uint64_t) index * 7919 + 12345) % space;
+    std::string code(length, 'A');
+    for (int i = length - 1; i >= 0; i--) {
+        code[i] = (char) ('A' + value % 26);
+        value /= 26;
+    }
+    return code;
+}
+
+/**
+ * @brief Builds a pronounceable capitalised name of two to four syllables.
+ * @param random Generator to draw from.
+ * @return The name.
+ * @note Time complexity: O(1).
+ */
+std::string DatasetGenerator::makeName(Random& random) {
+    std::string name;
+    int parts = 2 + (int) random.below(3);
+    for (int i = 0; i < parts; i++) name += syllables[random.below(numSyllables)];
+    name[0] = (char) toupper(name[0]);
+    return name;
+}
+
+long DatasetGenerator::getNumAirports() const {
+    return numAirports;
+}
+
+long DatasetGenerator::getNumAirlines() const {
+    return numAirlines;
+}
+
+/**
+ * @brief Gets the number of flights written by the last call to write().
+ * @return Number of flights, counting both directions.
+ */
+long DatasetGenerator::getNumFlights() const {
+    return numFlights;
+}
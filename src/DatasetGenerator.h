@@ -0,0 +1,76 @@
+#ifndef DATASETGENERATOR_H
+#define DATASETGENERATOR_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Writes synthetic airports.csv, airlines.csv and flights.csv in the format Read consumes.
+ *
+ * A scale factor of 1 matches the bundled dataset (about 3k airports, 440 airlines and 64k flights).
+ * Airports are clustered into cities around real country centres, each airport gets a heavy-tailed
+ * size, and every airline flies out of one to three hubs in its home country, mostly to domestic and
+ * same-region destinations, so degrees follow a hub-and-spoke distribution. Every flight is written
+ * in both directions. The output only depends on the scale and the seed.
+ */
+class DatasetGenerator {
+public:
+    DatasetGenerator(double scale, uint64_t seed);
+
+    bool write(const std::string& directory);
+
+    long getNumAirports() const;
+    long getNumAirlines() const;
+    long getNumFlights() const;
+
+    /**
+     * @brief Small portable generator (splitmix64) so the same seed gives the same files on every standard library.
+     */
+    class Random {
+    public:
+        explicit Random(uint64_t seed) : state(seed) {}
+        uint64_t next();
+        double uniform();
+        double normal();
+        double pareto(double alpha, double cap);
+        size_t below(size_t n);
+
+    private:
+        uint64_t state;
+    };
+
+private:
+    struct GeneratedAirport {
+        int country;
+        int city;
+        double latitude;
+        double longitude;
+        double size;
+    };
+
+    double scale;
+    uint64_t seed;
+    long numAirports;
+    long numAirlines;
+    long numFlights = 0;
+
+    std::vector<GeneratedAirport> airports;
+    std::vector<std::vector<int>> countryAirports;     // country -> airports, in generation order
+    std::vector<std::vector<double>> countryWeights;   // country -> cumulative airport sizes
+    std::vector<std::vector<int>> regionAirports;      // region -> airports
+    std::vector<std::vector<double>> regionWeights;    // region -> cumulative airport sizes
+    std::vector<double> globalWeights;                 // cumulative airport sizes
+    std::vector<std::string> cityNames;
+
+    void generateAirports(Random& random);
+    bool writeAirports(const std::string& filename) const;
+    bool writeAirlines(const std::string& filename, Random& random, std::vector<int>& homeCountries, std::vector<double>& sizes) const;
+    bool writeFlights(const std::string& filename, Random& random, const std::vector<int>& homeCountries, const std::vector<double>& sizes);
+
+    static int pick(const std::vector<double>& cumulative, Random& random);
+    static std::string makeCode(long index, long count);
+    static std::string makeName(Random& random);
+};
+
+#endif // DATASETGENERATOR_H
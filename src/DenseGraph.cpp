@@ -0,0 +1,96 @@
+#include "DenseGraph.h"
+#include "MemoryReport.h"
+#include <algorithm>
+
+/**
+ * @brief Builds the CSR arrays (forward and reverse) from a graph.
+ * @param graph Reference to the graph of airports.
+ * @note Time complexity: O(V + E) where V is the number of airports and E is the number of routes.
+ */
+DenseGraph::DenseGraph(const Graph<Airport>& graph) {
+    const auto& vertexSet = graph.getVertexSet();
+    int n = vertexSet.size();
+    vertices.assign(vertexSet.begin(), vertexSet.end());
+
+    offsets.assign(n + 1, 0);
+    reverseOffsets.assign(n + 1, 0);
+    for (const auto* vertex : vertexSet) {
+        offsets[vertex->getId() + 1] = vertex->getAdj().size();
+        for (const auto& edge : vertex->getAdj()) {
+            reverseOffsets[edge.getDest()->getId() + 1]++;
+        }
+    }
+    for (int v = 0; v < n; v++) {
+        offsets[v + 1] += offsets[v];
+        reverseOffsets[v + 1] += reverseOffsets[v];
+    }
+
+    targets.resize(offsets[n]);
+    weights.resize(offsets[n]);
+    reverseSources.resize(reverseOffsets[n]);
+    reverseWeights.resize(reverseOffsets[n]);
+    std::vector<int> next(reverseOffsets.begin(), reverseOffsets.end() - 1);
+
+    for (const auto* vertex : vertexSet) {
+        int v = vertex->getId(), i = offsets[v];
+        for (const auto& edge : vertex->getAdj()) {
+            int w = edge.getDest()->getId();
+            targets[i] = w;
+            weights[i] = edge.getFlights().size();
+            reverseSources[next[w]] = v;
+            reverseWeights[next[w]++] = edge.getFlights().size();
+            i++;
+        }
+    }
+}
+
+/**
+ * @brief Gets the number of vertices.
+ * @return Number of vertices.
+ * @note Time complexity: O(1)
+ */
+int DenseGraph::getNumVertices() const {
+    return vertices.size();
+}
+
+/**
+ * @brief Gets the number of edges (routes).
+ * @return Number of edges.
+ * @note Time complexity: O(1)
+ */
+size_t DenseGraph::getNumEdges() const {
+    return targets.size();
+}
+
+/**
+ * @brief Sets the number of flights of an existing route, in both the forward and the reverse arrays.
+ * Routes cannot be added or removed: the arrays must be rebuilt for that.
+ * @param from Source vertex id.
+ * @param to Target vertex id.
+ * @param weight The new number of flights.
+ * @return False if the route is not in the arrays.
+ * @note Time complexity: O(D) where D is the number of routes leaving from plus those arriving at to.
+ */
+bool DenseGraph::setWeight(int from, int to, double weight) {
+    auto first = targets.begin() + offsets[from], last = targets.begin() + offsets[from + 1];
+    auto forward = std::find(first, last, to);
+    if (forward == last) return false;
+    weights[forward - targets.begin()] = weight;
+
+    first = reverseSources.begin() + reverseOffsets[to];
+    last = reverseSources.begin() + reverseOffsets[to + 1];
+    auto reverse = std::find(first, last, from);
+    if (reverse != last) reverseWeights[reverse - reverseSources.begin()] = weight;
+    return true;
+}
+
+/**
+ * @brief Gets the heap bytes of the arrays.
+ * @return The number of bytes.
+ * @note Time complexity: O(1)
+ */
+size_t DenseGraph::getBytes() const {
+    return MemoryReport::bytesOf(vertices) + MemoryReport::bytesOf(offsets) + MemoryReport::bytesOf(targets)
+           + MemoryReport::bytesOf(weights) + MemoryReport::bytesOf(reverseOffsets)
+           + MemoryReport::bytesOf(reverseSources) + MemoryReport::bytesOf(reverseWeights);
+}
@@ -0,0 +1,36 @@
+#ifndef DENSEGRAPH_H
+#define DENSEGRAPH_H
+
+#include "Graph.h"
+#include "Airport.h"
+#include <vector>
+
+/**
+ * @brief Compressed sparse row (CSR) view of the airport graph over dense vertex ids.
+ *
+ * The routes leaving vertex v are targets[offsets[v] .. offsets[v + 1]), with the number
+ * of flights on each route in the parallel weights array. The reverse arrays hold the
+ * routes arriving at each vertex in the same layout.
+ */
+class DenseGraph {
+public:
+    DenseGraph() = default;
+    explicit DenseGraph(const Graph<Airport>& graph);
+
+    int getNumVertices() const;
+    size_t getNumEdges() const;
+    bool setWeight(int from, int to, double weight);
+    size_t getBytes() const;
+
+    std::vector<const Vertex<Airport>*> vertices;  // id -> vertex
+
+    std::vector<int> offsets;
+    std::vector<int> targets;
+    std::vector<double> weights;
+
+    std::vector<int> reverseOffsets;
+    std::vector<int> reverseSources;
+    std::vector<double> reverseWeights;
+};
+
+#endif // DENSEGRAPH_H
@@ -0,0 +1,58 @@
+#include "Dictionary.h"
+#include "MemoryReport.h"
+
+/**
+ * @brief Gets the id of a string, assigning the next free id if it is new.
+ * @param value The string.
+ * @return The id of the string.
+ * @note Time complexity: O(1) on average.
+ */
+int Dictionary::intern(const std::string& value) {
+    auto it = ids.find(value);
+    if (it != ids.end()) return it->second;
+    int id = values.size();
+    values.push_back(value);
+    ids.emplace(value, id);
+    return id;
+}
+
+/**
+ * @brief Gets the id of a string without inserting it.
+ * @param value The string.
+ * @return The id of the string, or -1 if it was never interned.
+ * @note Time complexity: O(1) on average.
+ */
+int Dictionary::find(const std::string& value) const {
+    auto it = ids.find(value);
+    return it == ids.end() ? -1 : it->second;
+}
+
+/**
+ * @brief Gets the string with a given id.
+ * @param id The id.
+ * @return The string.
+ * @note Time complexity: O(1)
+ */
+const std::string& Dictionary::get(int id) const {
+    return values[id];
+}
+
+/**
+ * @brief Gets the number of interned strings.
+ * @return Number of strings, which is also the next id to be assigned.
+ * @note Time complexity: O(1)
+ */
+int Dictionary::size() const {
+    return values.size();
+}
+
+/**
+ * @brief Estimates the heap bytes of the dictionary: the strings, kept twice, and the hash table.
+ * @return The number of bytes.
+ * @note Time complexity: O(N) where N is the number of strings.
+ */
+size_t Dictionary::getBytes() const {
+    size_t bytes = MemoryReport::bytesOf(values) + MemoryReport::hashTableBytes(ids);
+    for (const auto& pair : ids) bytes += MemoryReport::bytesOf(pair.first);
+    return bytes;
+}
@@ -0,0 +1,24 @@
+#ifndef DICTIONARY_H
+#define DICTIONARY_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+/**
+ * @brief Interns strings into dense integer ids (0, 1, 2, ...) in insertion order.
+ */
+class Dictionary {
+public:
+    int intern(const std::string& value);
+    int find(const std::string& value) const;
+    const std::string& get(int id) const;
+    int size() const;
+    size_t getBytes() const;
+
+private:
+    std::vector<std::string> values;
+    std::unordered_map<std::string, int> ids;
+};
+
+#endif // DICTIONARY_H
@@ -20,8 +20,9 @@ std::vector<std::pair<Airport, std::string>> Search::findBestFlight(
         const std::string& source,
         const std::string& destination,
         const std::unordered_set<std::string>& preferredAirlines,
-        bool minimizeAirlineChanges)
+        bool minimizeAirlineChanges) const
 {
+    INSTRUMENT_SCOPE(FilteredSearch);
     std::vector<Airport> sourceAirports = resolveInput(source);
     std::vector<Airport> destinationAirports = resolveInput(destination);
 
@@ -30,7 +31,13 @@ std::vector<std::pair<Airport, std::string>> Search::findBestFlight(
 
     for (const auto& srcAirport : sourceAirports) {
         for (const auto& destAirport : destinationAirports) {
+            if (condensation && !condensation->routeExists(srcAirport, destAirport)) {
+                continue;
+            }
             auto pathWithAirlines = bfsFindPathWithFilters(srcAirport, destAirport, preferredAirlines, minimizeAirlineChanges);
+            if (pathWithAirlines.empty()) {
+                continue;
+            }
             int stops = pathWithAirlines.size() - 1; // Number of stops is one less than the number of airports in the path
 
             if (stops < minStops) {
@@ -63,7 +70,7 @@ std::vector<std::pair<Airport, std::string>> Search::bfsFindPathWithFilters(
         const Airport& src,
         const Airport& dest,
         const std::unordered_set<std::string>& preferredAirlines,
-        bool minimizeAirlineChanges)
+        bool minimizeAirlineChanges) const
 {
     struct QueueNode {
         Airport airport;
@@ -84,6 +91,7 @@ std::vector<std::pair<Airport, std::string>> Search::bfsFindPathWithFilters(
     while (!queue.empty()) {
         QueueNode currentNode = queue.front();
         queue.pop();
+        INSTRUMENT_COUNT(VerticesDequeued, 1);
         Airport currentAirport = currentNode.airport;
         std::string currentAirline = currentNode.lastAirline;
         int currentChanges = currentNode.airlineChanges;
@@ -92,7 +100,10 @@ std::vector<std::pair<Airport, std::string>> Search::bfsFindPathWithFilters(
             return currentNode.path;
         }
 
-        for (const auto& edge : graph.findVertex(currentAirport)->getAdj()) {
+        const auto& adj = graph.findVertex(currentAirport)->getAdj();
+        INSTRUMENT_COUNT(EdgesScanned, adj.size());
+        for (const auto& edge : adj) {
+            INSTRUMENT_COUNT(FlightsInspected, edge.getFlights().size());
             for (const auto& flight : edge.getFlights()) {
                 Airport nextAirport = edge.getDest()->getInfo();
                 std::string nextAirline = flight.getAirline();
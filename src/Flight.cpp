@@ -1,4 +1,5 @@
 #include "Flight.h"
+#include "MemoryReport.h"
 
 Flight::Flight(const std::string& airlineCode) : m_airline(airlineCode) {}
 
@@ -31,3 +32,8 @@ void Flight::setTarget(const std::string &target) {
 void Flight::setAirline(const std::string &airline) {
     m_airline = airline;
 }
+
+// Heap bytes of the codes, none while they fit in their strings' inline buffers
+size_t Flight::getHeapBytes() const {
+    return MemoryReport::bytesOf(m_source) + MemoryReport::bytesOf(m_target) + MemoryReport::bytesOf(m_airline);
+}
@@ -20,6 +20,8 @@ public:
     void setTarget(const std::string &target);
     void setAirline(const std::string &airline);
 
+    size_t getHeapBytes() const;
+
     bool operator<(const Flight& other) const {
         return (m_source < other.m_source);  // Compare based on airline code
     }
@@ -34,6 +36,12 @@ private:
     std::string m_airline; // Airline code
 };
 
+// One row of a flight delta: a flight to add to the graph, or to remove from it
+struct FlightChange {
+    bool removal;
+    Flight flight;
+};
+
 namespace std {
     template<>
     struct hash<Flight> {
@@ -0,0 +1,62 @@
+#include "FlightDelta.h"
+#include "Instrumentation.h"
+
+namespace {
+
+bool hasRoute(const Vertex<Airport>* source, const Vertex<Airport>* destination) {
+    for (const auto& edge : source->getAdj()) {
+        if (edge.getDest() == destination) return true;
+    }
+    return false;
+}
+
+}
+
+/**
+ * @brief Applies the changes of a flight delta in order.
+ * @param graph The graph of airports; the delta may only refer to airports already in it.
+ * @param changes The flights to add and remove.
+ * @param engine Optional query engine built on the graph, whose indexes are updated; its condensation
+ *        is patched, or rebuilt if a new route requires it.
+ * @return How many changes were applied and ignored, and how many routes appeared or disappeared.
+ * @note Time complexity: O(C * (D + M log V)) for C changes, D routes per airport and M tracked ranking
+ *       metrics, plus O(V + E log E) if the condensation is rebuilt.
+ */
+FlightDelta::Result FlightDelta::apply(Graph<Airport>& graph, const std::vector<FlightChange>& changes, QueryEngine* engine) {
+    INSTRUMENT_SCOPE(ApplyFlightDelta);
+    Result result;
+
+    for (const auto& change : changes) {
+        const Vertex<Airport>* source = graph.findVertex(Airport(change.flight.getSource()));
+        const Vertex<Airport>* destination = graph.findVertex(Airport(change.flight.getTarget()));
+        if (!source || !destination) {
+            result.ignored++;
+            continue;
+        }
+        const Airport& from = source->getInfo();
+        const Airport& to = destination->getInfo();
+
+        if (!change.removal) {
+            bool newRoute = !hasRoute(source, destination);
+            if (!graph.addFlight(from, to, change.flight)) {
+                result.ignored++;
+                continue;
+            }
+            result.added++;
+            if (newRoute) result.routesAdded++;
+            if (engine) engine->onFlightAdded(source, destination, change.flight, newRoute);
+        } else {
+            if (!graph.removeFlight(from, to, change.flight)) {
+                result.ignored++;
+                continue;
+            }
+            result.removed++;
+            bool routeRemoved = !hasRoute(source, destination);
+            if (routeRemoved) result.routesRemoved++;
+            if (engine) engine->onFlightRemoved(source, destination, change.flight, routeRemoved);
+        }
+    }
+
+    if (engine) result.condensationRebuilt = engine->refreshCondensation();
+    return result;
+}
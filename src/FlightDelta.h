@@ -0,0 +1,33 @@
+#ifndef FLIGHTDELTA_H
+#define FLIGHTDELTA_H
+
+#include "Graph.h"
+#include "Airport.h"
+#include "Flight.h"
+#include "QueryEngine.h"
+#include <vector>
+
+/**
+ * @brief Applies a flight delta (see Read::readFlightDelta) to a loaded graph and its derived indexes.
+ *
+ * Each change goes through Graph::addFlight/removeFlight, which keep the route airline sets and
+ * the flight counters in sync, and is then passed on to the query engine's indexes, so the
+ * cost is proportional to the delta rather than to the dataset. The condensation is the only
+ * index that may need a full rebuild (at most once per delta), when a new route joins or
+ * reorders its components.
+ */
+class FlightDelta {
+public:
+    struct Result {
+        long added = 0;
+        long removed = 0;
+        long ignored = 0;        // unknown airports, flights already present or not present
+        long routesAdded = 0;
+        long routesRemoved = 0;
+        bool condensationRebuilt = false;
+    };
+
+    static Result apply(Graph<Airport>& graph, const std::vector<FlightChange>& changes, QueryEngine* engine = nullptr);
+};
+
+#endif // FLIGHTDELTA_H
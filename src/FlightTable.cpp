@@ -0,0 +1,141 @@
+#include "FlightTable.h"
+#include "Haversine.h"
+#include "MemoryReport.h"
+
+/**
+ * @brief Builds the fact table from the flights stored in the edges of a graph.
+ * @param graph Reference to the graph of airports.
+ * @note Time complexity: O(V + F) where V is the number of airports and F is the number of flights.
+ */
+FlightTable::FlightTable(const Graph<Airport>& graph) {
+    const auto& vertices = graph.getVertexSet();
+    airportCity.resize(vertices.size());
+    airportCountry.resize(vertices.size());
+    for (const auto* vertex : vertices) {
+        const Airport& airport = vertex->getInfo();
+        airports.intern(airport.getCode());
+        airportCity[vertex->getId()] = cities.intern(airport.getCity());
+        airportCountry[vertex->getId()] = countries.intern(airport.getCountry());
+    }
+
+    size_t rows = graph.getNumFlights();
+    source.reserve(rows);
+    target.reserve(rows);
+    airline.reserve(rows);
+    sourceCity.reserve(rows);
+    sourceCountry.reserve(rows);
+    distance.reserve(rows);
+
+    for (const auto* vertex : vertices) {
+        int from = vertex->getId();
+        const Airport& src = vertex->getInfo();
+        for (const auto& edge : vertex->getAdj()) {
+            int to = edge.getDest()->getId();
+            const Airport& dest = edge.getDest()->getInfo();
+            double km = Haversine::haversineDistance(src.getLatitude(), src.getLongitude(),
+                                                     dest.getLatitude(), dest.getLongitude());
+            for (const auto& flight : edge.getFlights()) {
+                source.push_back(from);
+                target.push_back(to);
+                airline.push_back(airlines.intern(flight.getAirline()));
+                sourceCity.push_back(airportCity[from]);
+                sourceCountry.push_back(airportCountry[from]);
+                distance.push_back(km);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Gets the number of rows (flights) in the table.
+ * @return Number of rows.
+ * @note Time complexity: O(1)
+ */
+size_t FlightTable::size() const {
+    return source.size();
+}
+
+/**
+ * @brief Estimates the heap bytes of the table: its columns, the airport dimension, the dictionaries
+ *        and the row index once built.
+ * @return The number of bytes.
+ * @note Time complexity: O(S) where S is the number of strings in the dictionaries.
+ */
+size_t FlightTable::getBytes() const {
+    return MemoryReport::bytesOf(source) + MemoryReport::bytesOf(target) + MemoryReport::bytesOf(airline)
+           + MemoryReport::bytesOf(sourceCity) + MemoryReport::bytesOf(sourceCountry) + MemoryReport::bytesOf(distance)
+           + MemoryReport::bytesOf(airportCity) + MemoryReport::bytesOf(airportCountry)
+           + airports.getBytes() + airlines.getBytes() + cities.getBytes() + countries.getBytes()
+           + MemoryReport::hashTableBytes(rowOf);
+}
+
+/**
+ * @brief Appends the row of a flight added to the graph.
+ * @param sourceVertex Source vertex, with its id in the graph the table was built from.
+ * @param destinationVertex Destination vertex.
+ * @param airlineCode The airline, interned if the table has not seen it yet.
+ * @note Time complexity: O(1) amortized.
+ */
+void FlightTable::addFlight(const Vertex<Airport>* sourceVertex, const Vertex<Airport>* destinationVertex, const std::string& airlineCode) {
+    const Airport& src = sourceVertex->getInfo();
+    const Airport& dest = destinationVertex->getInfo();
+    double km = Haversine::haversineDistance(src.getLatitude(), src.getLongitude(), dest.getLatitude(), dest.getLongitude());
+    size_t row = size();
+    source.push_back(0);
+    target.push_back(0);
+    airline.push_back(0);
+    sourceCity.push_back(0);
+    sourceCountry.push_back(0);
+    distance.push_back(0);
+    setRow(row, sourceVertex->getId(), destinationVertex->getId(), airlines.intern(airlineCode), km);
+}
+
+/**
+ * @brief Removes the row of a flight removed from the graph, moving the last row into its place.
+ * @param sourceVertex Source vertex.
+ * @param destinationVertex Destination vertex.
+ * @param airlineCode The airline.
+ * @return False if the table has no such row.
+ * @note Time complexity: O(F) for the first removal, which indexes the rows, O(1) on average afterwards.
+ */
+bool FlightTable::removeFlight(const Vertex<Airport>* sourceVertex, const Vertex<Airport>* destinationVertex, const std::string& airlineCode) {
+    int airlineId = airlines.find(airlineCode);
+    if (airlineId < 0) return false;
+    if (!indexed) {
+        indexed = true;
+        rowOf.reserve(size());
+        for (size_t row = 0; row < size(); row++) {
+            rowOf[rowKey(source[row], target[row], airline[row])] = row;
+        }
+    }
+    auto it = rowOf.find(rowKey(sourceVertex->getId(), destinationVertex->getId(), airlineId));
+    if (it == rowOf.end()) return false;
+
+    size_t row = it->second, last = size() - 1;
+    rowOf.erase(it);
+    if (row != last) {
+        setRow(row, source[last], target[last], airline[last], distance[last]);
+    }
+    source.pop_back();
+    target.pop_back();
+    airline.pop_back();
+    sourceCity.pop_back();
+    sourceCountry.pop_back();
+    distance.pop_back();
+    return true;
+}
+
+uint64_t FlightTable::rowKey(int source, int target, int airline) {
+    return ((uint64_t) source << 42) | ((uint64_t) target << 21) | (uint64_t) airline;
+}
+
+// Fills a row and keeps the row index, when it has been built, pointing at it
+void FlightTable::setRow(size_t row, int from, int to, int airlineId, double km) {
+    source[row] = from;
+    target[row] = to;
+    airline[row] = airlineId;
+    sourceCity[row] = airportCity[from];
+    sourceCountry[row] = airportCountry[from];
+    distance[row] = km;
+    if (indexed) rowOf[rowKey(from, to, airlineId)] = row;
+}
@@ -0,0 +1,56 @@
+#ifndef FLIGHTTABLE_H
+#define FLIGHTTABLE_H
+
+#include "Graph.h"
+#include "Airport.h"
+#include "Dictionary.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Columnar fact table with one row per flight.
+ *
+ * Airports are identified by their vertex id in the graph the table was built from;
+ * airlines, cities and countries by their id in the table's dictionaries. The city and
+ * country of every airport are kept as a small dimension table next to the flight columns.
+ * Rows are in no particular order: removing one moves the last row into its place.
+ */
+class FlightTable {
+public:
+    FlightTable() = default;
+    explicit FlightTable(const Graph<Airport>& graph);
+
+    size_t size() const;
+    size_t getBytes() const;
+
+    void addFlight(const Vertex<Airport>* source, const Vertex<Airport>* destination, const std::string& airlineCode);
+    bool removeFlight(const Vertex<Airport>* source, const Vertex<Airport>* destination, const std::string& airlineCode);
+
+    // Columns
+    std::vector<int> source;
+    std::vector<int> target;
+    std::vector<int> airline;
+    std::vector<int> sourceCity;
+    std::vector<int> sourceCountry;
+    std::vector<double> distance;
+
+    // Airport dimension, indexed by vertex id
+    std::vector<int> airportCity;
+    std::vector<int> airportCountry;
+
+    // Dictionaries
+    Dictionary airports;
+    Dictionary airlines;
+    Dictionary cities;
+    Dictionary countries;
+
+private:
+    std::unordered_map<uint64_t, size_t> rowOf;  // (source, target, airline) -> row, built by the first removal
+    bool indexed = false;
+
+    static uint64_t rowKey(int source, int target, int airline);  // ids below 2^21
+    void setRow(size_t row, int from, int to, int airlineId, double km);
+};
+
+#endif // FLIGHTTABLE_H
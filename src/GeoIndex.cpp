@@ -0,0 +1,144 @@
+#include "GeoIndex.h"
+#include "MemoryReport.h"
+#include <algorithm>
+#include <bitset>
+
+/**
+ * @brief Builds the city/country indexes and the destination-country bitsets.
+ * @param graph Reference to the graph of airports.
+ * @param table Flight table built from the same graph, whose dictionaries give the city and country ids.
+ * @note Time complexity: O(V * N / 64 + E) where V is the number of airports, N the number of countries and E the number of routes.
+ */
+GeoIndex::GeoIndex(const Graph<Airport>& graph, const FlightTable& table) {
+    words = (table.countries.size() + 63) / 64;
+    cityAirports.assign(table.cities.size(), std::vector<int>());
+    countryAirports.assign(table.countries.size(), std::vector<int>());
+    destinationCountries.assign(graph.getNumVertex() * words, 0);
+
+    for (const auto* vertex : graph.getVertexSet()) {
+        int airport = vertex->getId();
+        cityAirports[table.airportCity[airport]].push_back(airport);
+        countryAirports[table.airportCountry[airport]].push_back(airport);
+
+        uint64_t* bits = &destinationCountries[airport * words];
+        for (const auto& edge : vertex->getAdj()) {
+            int country = table.airportCountry[edge.getDest()->getId()];
+            bits[country / 64] |= uint64_t(1) << (country % 64);
+        }
+    }
+}
+
+/**
+ * @brief Gets the airports of a city.
+ * @param city City id.
+ * @return The airport (vertex) ids.
+ * @note Time complexity: O(1)
+ */
+const std::vector<int>& GeoIndex::getAirportsInCity(int city) const {
+    return cityAirports[city];
+}
+
+/**
+ * @brief Gets the airports of a country.
+ * @param country Country id.
+ * @return The airport (vertex) ids.
+ * @note Time complexity: O(1)
+ */
+const std::vector<int>& GeoIndex::getAirportsInCountry(int country) const {
+    return countryAirports[country];
+}
+
+/**
+ * @brief Counts the countries an airport has direct flights to.
+ * @param airport Airport (vertex) id.
+ * @return The number of countries.
+ * @note Time complexity: O(N / 64) where N is the number of countries.
+ */
+long GeoIndex::countDestinationCountriesOfAirport(int airport) const {
+    return popcount(&destinationCountries[airport * words], words);
+}
+
+/**
+ * @brief Counts the countries the airports of a city have direct flights to.
+ * @param city City id.
+ * @return The number of countries.
+ * @note Time complexity: O(A * N / 64) where A is the number of airports in the city and N the number of countries.
+ */
+long GeoIndex::countDestinationCountriesOfCity(int city) const {
+    std::vector<uint64_t> bits = unionOf(cityAirports[city]);
+    return popcount(bits.data(), words);
+}
+
+/**
+ * @brief Gets the countries the airports of a country have direct flights to.
+ * @param country Country id.
+ * @return The destination country ids, in increasing order.
+ * @note Time complexity: O(A * N / 64 + N) where A is the number of airports in the country and N the number of countries.
+ */
+std::vector<int> GeoIndex::getDestinationCountriesOfCountry(int country) const {
+    std::vector<int> countries;
+    std::vector<uint64_t> bits = unionOf(countryAirports[country]);
+    for (size_t w = 0; w < words; w++) {
+        for (int bit = 0; bit < 64; bit++) {
+            if ((bits[w] >> bit) & 1) {
+                countries.push_back(w * 64 + bit);
+            }
+        }
+    }
+    return countries;
+}
+
+/**
+ * @brief Recomputes the destination countries of an airport whose routes changed.
+ * @param vertex The airport's vertex.
+ * @param table Flight table the index was built with.
+ * @note Time complexity: O(D + N / 64) where D is the number of routes leaving the airport and N the number of countries.
+ */
+void GeoIndex::updateAirport(const Vertex<Airport>* vertex, const FlightTable& table) {
+    uint64_t* bits = &destinationCountries[vertex->getId() * words];
+    std::fill(bits, bits + words, 0);
+    for (const auto& edge : vertex->getAdj()) {
+        int country = table.airportCountry[edge.getDest()->getId()];
+        bits[country / 64] |= uint64_t(1) << (country % 64);
+    }
+}
+
+/**
+ * @brief ORs the destination-country bitsets of a group of airports.
+ * @param airports Airport (vertex) ids.
+ * @return The combined bitset.
+ */
+std::vector<uint64_t> GeoIndex::unionOf(const std::vector<int>& airports) const {
+    std::vector<uint64_t> bits(words, 0);
+    for (int airport : airports) {
+        const uint64_t* other = &destinationCountries[airport * words];
+        for (size_t w = 0; w < words; w++) {
+            bits[w] |= other[w];
+        }
+    }
+    return bits;
+}
+
+/**
+ * @brief Gets the heap bytes of the airport lists and of the destination country bit matrix.
+ * @return The number of bytes.
+ * @note Time complexity: O(C + N) where C is the number of cities and N the number of countries.
+ */
+size_t GeoIndex::getBytes() const {
+    return MemoryReport::bytesOf(cityAirports) + MemoryReport::bytesOf(countryAirports)
+           + MemoryReport::bytesOf(destinationCountries);
+}
+
+/**
+ * @brief Counts the bits set in a bitset.
+ * @param bits The bitset words.
+ * @param words Number of words.
+ * @return The number of bits set.
+ */
+long GeoIndex::popcount(const uint64_t* bits, size_t words) {
+    long count = 0;
+    for (size_t w = 0; w < words; w++) {
+        count += std::bitset<64>(bits[w]).count();
+    }
+    return count;
+}
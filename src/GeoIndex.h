@@ -0,0 +1,43 @@
+#ifndef GEOINDEX_H
+#define GEOINDEX_H
+
+#include "Graph.h"
+#include "Airport.h"
+#include "FlightTable.h"
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Load-time indexes for country-diversity queries.
+ *
+ * Maps every city and country (by their id in a FlightTable's dictionaries) to its airports,
+ * and keeps, for every airport, a bitset over the country dictionary with the countries it
+ * has direct flights to.
+ */
+class GeoIndex {
+public:
+    GeoIndex() = default;
+    GeoIndex(const Graph<Airport>& graph, const FlightTable& table);
+
+    const std::vector<int>& getAirportsInCity(int city) const;
+    const std::vector<int>& getAirportsInCountry(int country) const;
+
+    long countDestinationCountriesOfAirport(int airport) const;
+    long countDestinationCountriesOfCity(int city) const;
+    std::vector<int> getDestinationCountriesOfCountry(int country) const;
+
+    void updateAirport(const Vertex<Airport>* vertex, const FlightTable& table);
+
+    size_t getBytes() const;
+
+private:
+    size_t words = 0;                               // 64-bit words per bitset
+    std::vector<std::vector<int>> cityAirports;     // city id -> airport ids
+    std::vector<std::vector<int>> countryAirports;  // country id -> airport ids
+    std::vector<uint64_t> destinationCountries;     // airport id -> bitset of destination countries
+
+    std::vector<uint64_t> unionOf(const std::vector<int>& airports) const;
+    static long popcount(const uint64_t* bits, size_t words);
+};
+
+#endif // GEOINDEX_H
@@ -6,8 +6,12 @@
 #include <queue>
 #include <stack>
 #include <list>
+#include <algorithm>
+#include <memory>
 #include <Flight.h>
+#include "Arena.h"
 #include <unordered_set>
+#include <unordered_map>
 
 using namespace std;
 
@@ -15,31 +19,51 @@ template <class T> class Edge;
 template <class T> class Graph;
 template <class T> class Vertex;
 
+/*
+ * The arena accounts a graph's memory is charged to: the vertices themselves, their edge lists,
+ * their incoming lists, the flight sets of the edges and the per-airline flight counters.
+ */
+enum class GraphMemory { Vertices, Edges, Incoming, Flights, AirlineCounts, Count };
+
 
 /****************** Provided structures  ********************/
 
 template <class T>
 class Vertex {
+public:
+    using EdgeList = vector<Edge<T>, ArenaAllocator<Edge<T>>>;
+    using VertexList = vector<Vertex<T> *, ArenaAllocator<Vertex<T> *>>;
+private:
     T info;                // contents
-    vector<Edge<T> > adj;  // list of outgoing edges
+    Arena *arena;          // of the graph owning the vertex, or null; holds adj, incoming and the flights
+    EdgeList adj;          // list of outgoing edges
+    VertexList incoming;   // source of every incoming edge (once per edge), kept in sync with adj
     bool visited;          // auxiliary field
     bool processing;       // auxiliary field
     int indegree;          // auxiliary field
     int num;               // auxiliary field
     int low;               // auxiliary field
+    int id;                // dense index in the graph's vertex set
+    long outFlights;       // flights departing from this vertex
+    long inFlights;        // flights arriving at this vertex
+    unordered_map<string, long, hash<string>, equal_to<string>,
+                  ArenaAllocator<pair<const string, long>>> airlineFlights;  // departing flights per airline
 
     void addEdge(Vertex<T> *dest, double w);
     bool removeEdgeTo(Vertex<T> *d);
+    void removeIncoming(Vertex<T> *s);
+    void countFlight(Vertex<T> *dest, const Flight &flight, int delta);
 public:
-    Vertex(T in);
+    explicit Vertex(T in, Arena *arena = nullptr);
     T getInfo() const;
     void setInfo(T in);
     bool isVisited() const;
     void setVisited(bool v);
     bool isProcessing() const;
     void setProcessing(bool p);
-    const vector<Edge<T>> &getAdj() const;
+    const EdgeList &getAdj() const;
     void setAdj(const vector<Edge<T>> &adj);
+    const VertexList &getIncoming() const;
 
     int getIndegree() const;
 
@@ -53,38 +77,62 @@ public:
 
     void setLow(int low);
 
+    int getId() const;
+    long getOutFlights() const;
+    long getInFlights() const;
+    long getNumAirlines() const;
+
     friend class Graph<T>;
 };
 
 template <class T>
 class Edge {
+public:
+    using FlightSet = std::unordered_set<Flight, std::hash<Flight>, std::equal_to<Flight>, ArenaAllocator<Flight>>;
+private:
     Vertex<T> * dest;      // destination vertex
     double weight;         // edge weight
-    std::unordered_set<Flight> flights;
+    FlightSet flights;
+
+    // Flights are only added or removed through the graph, which keeps its counters in sync
+    bool addFlight(const Flight& flight);
+    bool removeFlight(const Flight& flight);
 public:
-    Edge(Vertex<T> *d, double w);
+    Edge(Vertex<T> *d, double w, Arena *arena = nullptr);
     Vertex<T> *getDest() const;
-    void setDest(Vertex<T> *dest);
+    void setDest(Vertex<T> *dest);  // does not update the destinations' incoming lists
     double getWeight() const;
     void setWeight(double weight);
-    void addFlight(const Flight& flight);
     friend class Graph<T>;
     friend class Vertex<T>;
 
-    const std::unordered_set<Flight>& getFlights() const {
+    const FlightSet& getFlights() const {
         return flights;
     }
 };
 
+/*
+ * The graph owns its vertices. They, their edges and the flights on them are allocated from
+ * the graph's arena, so they sit close together and a whole graph is freed in one go.
+ * A graph can be moved but not copied.
+ */
 template <class T>
 class Graph {
+    unique_ptr<Arena> arena;            // allocated on the heap so that it stays put when the graph is moved
     vector<Vertex<T> *> vertexSet;      // vertex set
-    int _index_;                        // auxiliary field
-    stack<Vertex<T>> _stack_;           // auxiliary field
-    list<list<T>> _list_sccs_;        // auxiliary field
+    unordered_map<T, Vertex<T> *> vertexIndex;  // contents -> vertex, for O(1) lookups
+    long numFlights = 0;                // flights over all edges
 
     void dfsVisit(Vertex<T> *v,  vector<T> & res) const;
+    void destroyVertex(Vertex<T> *v);
 public:
+    Graph();
+    ~Graph();
+    Graph(const Graph &) = delete;
+    Graph &operator=(const Graph &) = delete;
+    Graph(Graph &&other) noexcept;
+    Graph &operator=(Graph &&other) noexcept;
+
     Vertex<T> *findVertex(const T &in) const;
     int getNumVertex() const;
     bool addVertex(const T &in);
@@ -96,6 +144,14 @@ public:
     vector<T> dfs(const T & source) const;
     vector<T> bfs(const T &source) const;
     Edge<T>* getEdge(const T &source, const T &dest);
+    bool addFlight(const T &sourc, const T &dest, const Flight &flight);
+    bool removeFlight(const T &sourc, const T &dest, const Flight &flight);
+    long getNumFlights() const;
+    const Arena &getArena() const;
+    size_t getIndexBytes() const;
+    void clear();
+    vector<int> sccIds(int &numComponents) const;
+    list<list<T>> sccs() const;
 
 };
 
@@ -118,15 +174,67 @@ Edge<T>* Graph<T>::getEdge(const T &source, const T &dest) {
 }
 
 template <class T>
-Vertex<T>::Vertex(T in): info(in) {}
+Vertex<T>::Vertex(T in, Arena *arena): info(in), arena(arena), adj(ArenaAllocator<Edge<T>>(arena, (int) GraphMemory::Edges)),
+                         incoming(ArenaAllocator<Vertex<T> *>(arena, (int) GraphMemory::Incoming)), visited(false), processing(false), indegree(0),
+                         num(0), low(0), id(-1), outFlights(0), inFlights(0),
+                         airlineFlights(ArenaAllocator<pair<const string, long>>(arena, (int) GraphMemory::AirlineCounts)) {}
+
+template <class T>
+Edge<T>::Edge(Vertex<T> *d, double w, Arena *arena): dest(d), weight(w), flights(ArenaAllocator<Flight>(arena, (int) GraphMemory::Flights)) {}
+
+template <class T>
+Graph<T>::Graph(): arena(new Arena()) {}
 
 template <class T>
-Edge<T>::Edge(Vertex<T> *d, double w): dest(d), weight(w) {}
+Graph<T>::~Graph() {
+    clear();
+}
 
 template <class T>
-void Edge<T>::addFlight(const Flight& flight) {
-    flights.insert(flight);
-    weight = flights.size(); // Optionally, you can keep the weight updated as the count of flights
+Graph<T>::Graph(Graph &&other) noexcept: arena(std::move(other.arena)), vertexSet(std::move(other.vertexSet)),
+                                          vertexIndex(std::move(other.vertexIndex)), numFlights(other.numFlights) {
+    other.arena.reset(new Arena());
+    other.vertexSet.clear();
+    other.vertexIndex.clear();
+    other.numFlights = 0;
+}
+
+template <class T>
+Graph<T> &Graph<T>::operator=(Graph &&other) noexcept {
+    if (this != &other) {
+        clear();
+        arena = std::move(other.arena);
+        vertexSet = std::move(other.vertexSet);
+        vertexIndex = std::move(other.vertexIndex);
+        numFlights = other.numFlights;
+        other.arena.reset(new Arena());
+        other.vertexSet.clear();
+        other.vertexIndex.clear();
+        other.numFlights = 0;
+    }
+    return *this;
+}
+
+/*
+ * Adds a flight to an edge (this), keeping the weight as the number of flights.
+ * Returns true if the flight was not on the edge yet.
+ */
+template <class T>
+bool Edge<T>::addFlight(const Flight& flight) {
+    bool inserted = flights.insert(flight).second;
+    weight = flights.size();
+    return inserted;
+}
+
+/*
+ * Removes a flight from an edge (this), keeping the weight as the number of flights.
+ * Returns true if the flight was on the edge.
+ */
+template <class T>
+bool Edge<T>::removeFlight(const Flight& flight) {
+    bool erased = flights.erase(flight) > 0;
+    weight = flights.size();
+    return erased;
 }
 
 template <class T>
@@ -181,13 +289,14 @@ void Edge<T>::setWeight(double weight) {
 
 /*
  * Auxiliary function to find a vertex with a given content.
+ * Uses the hash index kept alongside the vertex set, so lookups are O(1) on average.
  */
 template <class T>
 Vertex<T> * Graph<T>::findVertex(const T &in) const {
-    for (auto v : vertexSet)
-        if (v->info == in)
-            return v;
-    return NULL;
+    auto it = vertexIndex.find(in);
+    if (it == vertexIndex.end())
+        return NULL;
+    return it->second;
 }
 
 template <class T>
@@ -225,19 +334,71 @@ void Vertex<T>::setLow(int low) {
     Vertex::low = low;
 }
 
+template<class T>
+int Vertex<T>::getId() const {
+    return id;
+}
+
+template<class T>
+long Vertex<T>::getOutFlights() const {
+    return outFlights;
+}
+
+template<class T>
+long Vertex<T>::getInFlights() const {
+    return inFlights;
+}
+
+template<class T>
+long Vertex<T>::getNumAirlines() const {
+    return airlineFlights.size();
+}
+
+/*
+ * Auxiliary function to account for a flight added (delta = 1) or removed (delta = -1)
+ * from a vertex (this) to a destination vertex (dest).
+ */
+template<class T>
+void Vertex<T>::countFlight(Vertex<T> *dest, const Flight &flight, int delta) {
+    outFlights += delta;
+    dest->inFlights += delta;
+    auto it = airlineFlights.find(flight.getAirline());
+    if (it == airlineFlights.end())
+        it = airlineFlights.insert({flight.getAirline(), 0}).first;
+    it->second += delta;
+    if (it->second <= 0)
+        airlineFlights.erase(it);
+}
+
 template <class T>
 void Vertex<T>::setVisited(bool v) {
     Vertex::visited = v;
 }
 
 template<class T>
-const vector<Edge<T>> &Vertex<T>::getAdj() const {
+const typename Vertex<T>::EdgeList &Vertex<T>::getAdj() const {
     return adj;
 }
 
 template <class T>
 void Vertex<T>::setAdj(const vector<Edge<T>> &adj) {
-    Vertex::adj = adj;
+    for (auto &e : Vertex::adj)
+        e.dest->removeIncoming(this);
+    Vertex::adj.clear();
+    for (auto &e : adj) {
+        Vertex::adj.push_back(Edge<T>(e.dest, e.weight, arena));
+        Vertex::adj.back().flights.insert(e.flights.begin(), e.flights.end());
+        e.dest->incoming.push_back(this);
+    }
+}
+
+/*
+ * Returns the source vertex of every edge arriving at a vertex (this), once per edge,
+ * in no particular order.
+ */
+template<class T>
+const typename Vertex<T>::VertexList &Vertex<T>::getIncoming() const {
+    return incoming;
 }
 
 
@@ -249,7 +410,10 @@ template <class T>
 bool Graph<T>::addVertex(const T &in) {
     if ( findVertex(in) != NULL)
         return false;
-    vertexSet.push_back(new Vertex<T>(in));
+    auto v = new (arena->allocate(sizeof(Vertex<T>), (int) GraphMemory::Vertices)) Vertex<T>(in, arena.get());
+    v->id = vertexSet.size();
+    vertexSet.push_back(v);
+    vertexIndex[in] = v;
     return true;
 }
 
@@ -275,7 +439,8 @@ bool Graph<T>::addEdge(const T &sourc, const T &dest, double w) {
  */
 template <class T>
 void Vertex<T>::addEdge(Vertex<T> *d, double w) {
-    adj.push_back(Edge<T>(d, w));
+    adj.push_back(Edge<T>(d, w, arena));
+    d->incoming.push_back(this);
 }
 
 
@@ -290,7 +455,10 @@ bool Graph<T>::removeEdge(const T &sourc, const T &dest) {
     auto v2 = findVertex(dest);
     if (v1 == NULL || v2 == NULL)
         return false;
-    return v1->removeEdgeTo(v2);
+    long before = v1->outFlights;
+    bool removed = v1->removeEdgeTo(v2);
+    numFlights -= before - v1->outFlights;
+    return removed;
 }
 
 /*
@@ -302,31 +470,167 @@ template <class T>
 bool Vertex<T>::removeEdgeTo(Vertex<T> *d) {
     for (auto it = adj.begin(); it != adj.end(); it++)
         if (it->dest  == d) {
+            for (auto &flight : it->flights)
+                countFlight(d, flight, -1);
             adj.erase(it);
+            d->removeIncoming(this);
             return true;
         }
     return false;
 }
 
+/*
+ * Auxiliary function to remove one entry of a source vertex (s) from the incoming
+ * list of a vertex (this), after an edge from s to this was removed.
+ */
+template <class T>
+void Vertex<T>::removeIncoming(Vertex<T> *s) {
+    for (auto it = incoming.begin(); it != incoming.end(); it++)
+        if (*it == s) {
+            *it = incoming.back();
+            incoming.pop_back();
+            return;
+        }
+}
+
 /*
  *  Removes a vertex with a given content (in) from a graph (this), and
- *  all outgoing and incoming edges.
+ *  all outgoing and incoming edges, in time proportional to its degree.
+ *  The last vertex of the vertex set takes its place (and its id).
  *  Returns true if successful, and false if such vertex does not exist.
  */
 template <class T>
 bool Graph<T>::removeVertex(const T &in) {
-    for (auto it = vertexSet.begin(); it != vertexSet.end(); it++)
-        if ((*it)->info  == in) {
-            auto v = *it;
-            vertexSet.erase(it);
-            for (auto u : vertexSet)
-                u->removeEdgeTo(v);
-            delete v;
+    auto v = findVertex(in);
+    if (v == NULL)
+        return false;
+    for (auto &e : v->adj) {
+        numFlights -= e.flights.size();
+        for (auto &flight : e.flights)
+            v->countFlight(e.dest, flight, -1);
+        e.dest->removeIncoming(v);
+    }
+    v->adj.clear();
+    numFlights -= v->inFlights;
+    auto sources = v->incoming;
+    for (auto u : sources)
+        u->removeEdgeTo(v);
+
+    auto last = vertexSet.back();
+    vertexSet[v->id] = last;
+    last->id = v->id;
+    vertexSet.pop_back();
+    vertexIndex.erase(v->info);
+    destroyVertex(v);
+    return true;
+}
+
+/*
+ * Auxiliary function to destroy a vertex and return its memory to the arena.
+ */
+template <class T>
+void Graph<T>::destroyVertex(Vertex<T> *v) {
+    v->~Vertex<T>();
+    arena->deallocate(v, sizeof(Vertex<T>), (int) GraphMemory::Vertices);
+}
+
+
+/*
+ * Adds a flight to the edge between two vertices of a graph (this), creating the
+ * edge if needed, and updates the flight counters of the graph and of both vertices.
+ * Returns true if successful, and false if a vertex does not exist or the flight
+ * is already on the edge.
+ */
+template <class T>
+bool Graph<T>::addFlight(const T &sourc, const T &dest, const Flight &flight) {
+    auto v1 = findVertex(sourc);
+    auto v2 = findVertex(dest);
+    if (v1 == NULL || v2 == NULL)
+        return false;
+    Edge<T> *edge = NULL;
+    for (auto &e : v1->adj)
+        if (e.dest == v2) {
+            edge = &e;
+            break;
+        }
+    if (edge == NULL) {
+        v1->addEdge(v2, 0);
+        edge = &v1->adj.back();
+    }
+    if (!edge->addFlight(flight))
+        return false;
+    v1->countFlight(v2, flight, 1);
+    numFlights++;
+    return true;
+}
+
+/*
+ * Removes a flight from the edge between two vertices of a graph (this) and updates
+ * the flight counters. The edge itself is removed once it has no flights left.
+ * Returns true if successful, and false if there is no such flight.
+ */
+template <class T>
+bool Graph<T>::removeFlight(const T &sourc, const T &dest, const Flight &flight) {
+    auto v1 = findVertex(sourc);
+    auto v2 = findVertex(dest);
+    if (v1 == NULL || v2 == NULL)
+        return false;
+    for (auto it = v1->adj.begin(); it != v1->adj.end(); it++)
+        if (it->dest == v2) {
+            if (!it->removeFlight(flight))
+                return false;
+            v1->countFlight(v2, flight, -1);
+            numFlights--;
+            if (it->flights.empty()) {
+                v1->adj.erase(it);
+                v2->removeIncoming(v1);
+            }
             return true;
         }
     return false;
 }
 
+/*
+ * Returns the number of flights over all edges of a graph (this).
+ */
+template <class T>
+long Graph<T>::getNumFlights() const {
+    return numFlights;
+}
+
+/*
+ * Returns the arena the vertices, edges and flights of a graph (this) are allocated from.
+ */
+template <class T>
+const Arena &Graph<T>::getArena() const {
+    return *arena;
+}
+
+/*
+ * Returns the heap bytes of the vertex set and of the lookup index of a graph (this), which live
+ * outside the arena; the index's nodes are estimated as a next pointer, the entry and a cached hash.
+ */
+template <class T>
+size_t Graph<T>::getIndexBytes() const {
+    return vertexSet.capacity() * sizeof(Vertex<T> *) + vertexIndex.bucket_count() * sizeof(void *)
+           + vertexIndex.size() * (sizeof(void *) + sizeof(pair<const T, Vertex<T> *>) + sizeof(size_t));
+}
+
+/*
+ * Deletes every vertex (and so every edge) of a graph (this), leaving it empty,
+ * and frees the arena's memory. Pointers to its vertices become invalid.
+ */
+template <class T>
+void Graph<T>::clear() {
+    for (auto v : vertexSet) {
+        v->~Vertex<T>();
+    }
+    vertexSet.clear();
+    vertexIndex.clear();
+    numFlights = 0;
+    arena->release();
+}
+
 
 /****************** DFS ********************/
 /*
@@ -414,4 +718,83 @@ vector<T> Graph<T>::bfs(const T & source) const {
     return res;
 }
 
+
+/****************** SCCs ********************/
+/*
+ * Computes the strongly connected components of a graph (this) with an
+ * iterative version of Tarjan's algorithm over the dense vertex ids, so deep
+ * graphs cannot overflow the call stack.
+ * Returns a vector indexed by vertex id with the component of each vertex and
+ * sets numComponents. Components are numbered in the order Tarjan completes
+ * them, which is a reverse topological order of the condensation: every edge
+ * between two components goes from a higher to a lower component number.
+ */
+template <class T>
+vector<int> Graph<T>::sccIds(int &numComponents) const {
+    int n = vertexSet.size();
+    vector<int> index(n, -1), low(n, 0), comp(n, -1);
+    vector<char> onStack(n, false);
+    vector<int> sccStack;
+    vector<pair<int, size_t>> callStack;  // vertex id and next edge to explore
+    int counter = 0;
+    numComponents = 0;
+
+    for (int s = 0; s < n; s++) {
+        if (index[s] != -1)
+            continue;
+        index[s] = low[s] = counter++;
+        sccStack.push_back(s);
+        onStack[s] = true;
+        callStack.push_back({s, 0});
+
+        while (!callStack.empty()) {
+            int v = callStack.back().first;
+            const auto &adj = vertexSet[v]->adj;
+            if (callStack.back().second < adj.size()) {
+                int w = adj[callStack.back().second++].dest->id;
+                if (index[w] == -1) {
+                    index[w] = low[w] = counter++;
+                    sccStack.push_back(w);
+                    onStack[w] = true;
+                    callStack.push_back({w, 0});
+                } else if (onStack[w]) {
+                    low[v] = min(low[v], index[w]);
+                }
+                continue;
+            }
+
+            if (low[v] == index[v]) {
+                int w;
+                do {
+                    w = sccStack.back();
+                    sccStack.pop_back();
+                    onStack[w] = false;
+                    comp[w] = numComponents;
+                } while (w != v);
+                numComponents++;
+            }
+            callStack.pop_back();
+            if (!callStack.empty()) {
+                int u = callStack.back().first;
+                low[u] = min(low[u], low[v]);
+            }
+        }
+    }
+    return comp;
+}
+
+/*
+ * Computes the strongly connected components of a graph (this).
+ * Returns a list with the contents of the vertices of each component.
+ */
+template <class T>
+list<list<T>> Graph<T>::sccs() const {
+    int numComponents;
+    vector<int> comp = sccIds(numComponents);
+    vector<list<T>> components(numComponents);
+    for (auto v : vertexSet)
+        components[comp[v->id]].push_back(v->info);
+    return list<list<T>>(components.begin(), components.end());
+}
+
 #endif /* GRAPH_H_ */
@@ -0,0 +1,192 @@
+#include "HopLabels.h"
+#include "Instrumentation.h"
+#include "MemoryReport.h"
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+const int Far = 1 << 20;  // farther than any distance, and safe to add two of
+
+struct Entry {
+    int hub;
+    uint8_t dist;
+};
+
+using Labels = std::vector<std::vector<Entry>>;
+
+// BFS from the root labelled rank, over the routes in offsets/adjacent, adding the root to the labels of the airports
+// it reaches unless their labels and rootLabel already give a distance as short; false if a path is too long
+bool labelFrom(int root, int rank, const std::vector<Entry>& rootLabel, Labels& labels, const std::vector<int>& offsets,
+               const std::vector<int>& adjacent, std::vector<int>& hubDist, std::vector<int>& depth, std::vector<int>& queue) {
+    for (const Entry& entry : rootLabel) hubDist[entry.hub] = entry.dist;
+    queue.clear();
+    queue.push_back(root);
+    depth[root] = 0;
+    bool fits = true;
+    for (size_t head = 0; head < queue.size() && fits; head++) {
+        int v = queue[head], d = depth[v];
+        bool covered = false;
+        for (const Entry& entry : labels[v]) {
+            if (hubDist[entry.hub] + entry.dist <= d) {
+                covered = true;
+                break;
+            }
+        }
+        if (covered) continue;
+        if (d > HopLabels::MaxHops) {
+            fits = false;
+            break;
+        }
+        labels[v].push_back({rank, (uint8_t) d});
+        for (int e = offsets[v]; e < offsets[v + 1]; e++) {
+            int w = adjacent[e];
+            if (depth[w] < 0) {
+                depth[w] = d + 1;
+                queue.push_back(w);
+            }
+        }
+    }
+    for (int v : queue) depth[v] = -1;
+    for (const Entry& entry : rootLabel) hubDist[entry.hub] = Far;
+    return fits;
+}
+
+// Copies the labels into flat arrays, each label followed by the sentinel hub n
+void flatten(Labels& labels, std::vector<int>& offsets, std::vector<int>& hubs, std::vector<uint8_t>& dists) {
+    int n = labels.size();
+    offsets.assign(n + 1, 0);
+    for (int v = 0; v < n; v++) offsets[v + 1] = offsets[v] + labels[v].size() + 1;
+    hubs.resize(offsets[n]);
+    dists.resize(offsets[n]);
+    for (int v = 0; v < n; v++) {
+        int i = offsets[v];
+        for (const Entry& entry : labels[v]) {
+            hubs[i] = entry.hub;
+            dists[i++] = entry.dist;
+        }
+        hubs[i] = n;
+        dists[i] = 0;
+        std::vector<Entry>().swap(labels[v]);
+    }
+}
+
+}
+
+/**
+ * @brief Constructor: labels every airport of a graph.
+ * @param graph CSR view of the airport graph; every route counts one flight.
+ * @note Time complexity: O(V * L * (L + D)) in practice, where L is the average label size (a few dozen hubs on
+ *       airport networks, whose busiest airports cover most shortest paths) and D the average degree.
+ *       If some shortest path takes more than MaxHops flights, the labels are left empty.
+ */
+HopLabels::HopLabels(const DenseGraph& graph) {
+    INSTRUMENT_SCOPE(BuildHopLabels);
+    int n = numVertices = graph.getNumVertices();
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    auto degree = [&](int v) {
+        return graph.offsets[v + 1] - graph.offsets[v] + graph.reverseOffsets[v + 1] - graph.reverseOffsets[v];
+    };
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return degree(a) != degree(b) ? degree(a) > degree(b) : a < b;
+    });
+
+    Labels out(n), in(n);
+    std::vector<int> hubDist(n, Far), depth(n, -1), queue;
+    queue.reserve(n);
+    for (int rank = 0; rank < n; rank++) {
+        int root = order[rank];
+        // Forwards, the root joins the incoming labels; backwards, the outgoing ones
+        if (!labelFrom(root, rank, out[root], in, graph.offsets, graph.targets, hubDist, depth, queue)
+            || !labelFrom(root, rank, in[root], out, graph.reverseOffsets, graph.reverseSources, hubDist, depth, queue)) {
+            return;
+        }
+    }
+    flatten(out, outOffsets, outHubs, outDists);
+    flatten(in, inOffsets, inHubs, inDists);
+}
+
+/**
+ * @brief Checks whether there are no labels, because none were built or a path was too long.
+ * @return True if there are none.
+ */
+bool HopLabels::empty() const {
+    return outHubs.empty();
+}
+
+int HopLabels::getNumVertices() const {
+    return numVertices;
+}
+
+/**
+ * @brief Gets the number of label entries, outgoing and incoming, sentinels aside.
+ * @return Number of entries.
+ */
+size_t HopLabels::getNumEntries() const {
+    return empty() ? 0 : outHubs.size() + inHubs.size() - 2 * numVertices;
+}
+
+/**
+ * @brief Estimates the bytes held by the labels.
+ * @return The number of bytes.
+ */
+size_t HopLabels::getBytes() const {
+    return MemoryReport::bytesOf(outOffsets) + MemoryReport::bytesOf(outHubs) + MemoryReport::bytesOf(outDists)
+           + MemoryReport::bytesOf(inOffsets) + MemoryReport::bytesOf(inHubs) + MemoryReport::bytesOf(inDists);
+}
+
+/**
+ * @brief Gets the fewest flights from one airport to another.
+ * @param from Vertex id of the origin.
+ * @param to Vertex id of the destination.
+ * @return Number of flights (0 from an airport to itself), or Unreachable if there is no path or no labels.
+ * @note Time complexity: O(L) where L is the size of the two labels.
+ */
+int HopLabels::distance(int from, int to) const {
+    if (empty() || from < 0 || to < 0 || from >= numVertices || to >= numVertices) return Unreachable;
+    // Both labels end in the same sentinel, so the merge needs no bounds checks
+    int i = outOffsets[from], j = inOffsets[to], best = Far;
+    while (true) {
+        if (outHubs[i] == inHubs[j]) {
+            if (outHubs[i] == numVertices) break;
+            best = std::min(best, outDists[i++] + inDists[j++]);
+        } else if (outHubs[i] < inHubs[j]) {
+            i++;
+        } else {
+            j++;
+        }
+    }
+    return best == Far ? Unreachable : best;
+}
+
+/**
+ * @brief Finds a path with the fewest flights, following at every airport the first route to an airport one
+ *        flight closer to the destination; the labels rule out every other route without a search.
+ * @param graph The CSR view the labels were built from.
+ * @param from Vertex id of the origin.
+ * @param to Vertex id of the destination.
+ * @return Vertex ids of the path, both ends included; empty if there is none.
+ * @note Time complexity: O(H * D * L) where H is the number of flights, D the degree of the airports on the
+ *       path and L the size of the labels.
+ */
+std::vector<int> HopLabels::path(const DenseGraph& graph, int from, int to) const {
+    std::vector<int> result;
+    int remaining = distance(from, to);
+    if (remaining == Unreachable) return result;
+    result.push_back(from);
+    long scanned = 0;
+    for (int at = from; remaining > 0; remaining--) {
+        int next = remaining == 1 ? to : -1;
+        for (int e = graph.offsets[at]; e < graph.offsets[at + 1] && next < 0; e++) {
+            scanned++;
+            if (distance(graph.targets[e], to) == remaining - 1) next = graph.targets[e];
+        }
+        if (next < 0) return std::vector<int>();  // the graph changed since the labels were built
+        at = next;
+        result.push_back(at);
+    }
+    INSTRUMENT_COUNT(VerticesDequeued, result.size());
+    INSTRUMENT_COUNT(EdgesScanned, scanned);
+    return result;
+}
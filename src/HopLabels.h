@@ -0,0 +1,50 @@
+#ifndef HOPLABELS_H
+#define HOPLABELS_H
+
+#include "DenseGraph.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Pruned landmark labelling of the route graph, answering exact stop counts between airports
+ *        without a search.
+ *
+ * Every airport keeps two labels: the hubs it reaches, and the hubs that reach it, each with the
+ * number of flights. The distance from one airport to another is the smallest sum over the hubs
+ * the first one's outgoing label shares with the second one's incoming label.
+ *
+ * The labels come from one BFS per airport, forwards and backwards, busiest (most routes) first.
+ * Each BFS stops wherever the labels built so far already give a distance as short, so later
+ * airports add few entries. Hubs are numbered in that order, which keeps every label sorted, and
+ * all labels live in flat arrays of hubs and of distances, each ending in a sentinel. A query is
+ * therefore one merge of two short sorted arrays.
+ *
+ * Airports are vertex ids of the DenseGraph the labels were built from.
+ */
+class HopLabels {
+public:
+    static const int Unreachable = -1;
+    static const int MaxHops = 254;  // longer shortest paths than this leave the labels empty
+
+    HopLabels() = default;
+    explicit HopLabels(const DenseGraph& graph);
+
+    bool empty() const;
+    int getNumVertices() const;
+    size_t getNumEntries() const;
+    size_t getBytes() const;
+
+    int distance(int from, int to) const;
+    std::vector<int> path(const DenseGraph& graph, int from, int to) const;
+
+private:
+    int numVertices = 0;
+    std::vector<int> outOffsets;      // hubs v reaches: outHubs[outOffsets[v] .. outOffsets[v + 1]), the last a sentinel
+    std::vector<int> outHubs;         // by position in the order, increasing
+    std::vector<uint8_t> outDists;    // flights from v to the hub
+    std::vector<int> inOffsets;       // hubs that reach v, in the same layout
+    std::vector<int> inHubs;
+    std::vector<uint8_t> inDists;     // flights from the hub to v
+};
+
+#endif // HOPLABELS_H
@@ -0,0 +1,307 @@
+#include "Instrumentation.h"
+#include "Json.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+
+// Zero-initialised static storage: claiming a slot never allocates, so operator new can record into it
+Instrumentation::ThreadSlot Instrumentation::slots[Instrumentation::MaxThreads];
+Instrumentation::ThreadSlot Instrumentation::retired;
+std::atomic<int> Instrumentation::numSlots(0);
+
+namespace {
+
+const char* const operationNames[] = {
+        "read_airports", "read_airlines", "read_flights", "apply_flight_delta",
+        "find_best_flight", "filtered_search", "earliest_arrival", "journey_profile", "read_timetable",
+        "shortest_route", "build_hierarchy", "build_hop_labels",
+        "reachable", "longest_path", "top_k_airports", "essential_airports", "compute_all",
+        "reach_sketches", "betweenness", "pagerank",
+        "server_request",
+};
+
+const char* const counterNames[] = {
+        "rows_parsed", "vertices_dequeued", "edges_scanned", "flights_inspected", "connections_scanned", "allocations",
+        "allocated_bytes",
+};
+
+// Constructed before dumpAtExit() registers dumpReport(), so still alive when dumpReport() runs
+std::string dumpFilename;
+
+void dumpReport() {
+    std::ofstream file(dumpFilename);
+    file << Instrumentation::toJson() << std::endl;
+}
+
+}
+
+/**
+ * @brief Tells whether the instrumentation macros were compiled in.
+ * @return True when built with FLIGHT_INSTRUMENTATION.
+ */
+bool Instrumentation::isEnabled() {
+#ifdef FLIGHT_INSTRUMENTATION
+    return true;
+#else
+    return false;
+#endif
+}
+
+const char* Instrumentation::getName(Operation operation) {
+    return operationNames[(int) operation];
+}
+
+const char* Instrumentation::getName(Counter counter) {
+    return counterNames[(int) counter];
+}
+
+/**
+ * @brief Gets the slot of the calling thread, claiming one the first time the thread records anything.
+ * @return The slot of the calling thread.
+ * @note Time complexity: O(1), and O(T) for the claim, where T is MaxThreads.
+ */
+Instrumentation::ThreadSlot* Instrumentation::local() {
+    static thread_local ThreadSlot* slot = nullptr;
+    if (slot == nullptr) {
+        slot = claim();
+        static thread_local SlotLease lease;
+        lease.slot = &slot;
+    }
+    return slot;
+}
+
+/**
+ * @brief Claims the first free slot.
+ * @return The slot, or the retired totals, shared, if every slot is in use.
+ */
+Instrumentation::ThreadSlot* Instrumentation::claim() {
+    for (int t = 0; t < MaxThreads; t++) {
+        bool expected = false;
+        if (!slots[t].claimed.load(std::memory_order_relaxed)
+            && slots[t].claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            int used = numSlots.load(std::memory_order_relaxed);
+            while (used < t + 1 && !numSlots.compare_exchange_weak(used, t + 1, std::memory_order_relaxed)) {}
+            return &slots[t];
+        }
+    }
+    return &retired;
+}
+
+/**
+ * @brief Moves the counts of a slot into the retired totals and frees it. A report that runs concurrently
+ *        may miss the counts being moved.
+ * @param slot The slot of a thread that is exiting.
+ */
+void Instrumentation::release(ThreadSlot* slot) {
+    if (slot == &retired) return;
+    auto fold = [](std::atomic<uint64_t>& from, std::atomic<uint64_t>& to) {
+        uint64_t value = from.exchange(0, std::memory_order_relaxed);
+        if (value) to.fetch_add(value, std::memory_order_relaxed);
+    };
+    for (int c = 0; c < NumCounters; c++) fold(slot->counters[c], retired.counters[c]);
+    for (int op = 0; op < NumOperations; op++) {
+        for (int b = 0; b < Buckets; b++) fold(slot->histograms[op][b], retired.histograms[op][b]);
+        fold(slot->totalNs[op], retired.totalNs[op]);
+    }
+    slot->claimed.store(false, std::memory_order_release);
+}
+
+// Anything the thread records after this, while its other thread-locals are destroyed, goes to the retired totals
+Instrumentation::SlotLease::~SlotLease() {
+    if (slot == nullptr) return;
+    release(*slot);
+    *slot = &retired;
+}
+
+int Instrumentation::bucketOf(uint64_t nanoseconds) {
+    int bucket = 0;
+    while (nanoseconds > 0 && bucket < Buckets - 1) {
+        nanoseconds >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+/**
+ * @brief Adds to a counter of the calling thread.
+ * @param counter The counter.
+ * @param amount Amount to add.
+ * @note Time complexity: O(1).
+ */
+void Instrumentation::add(Counter counter, uint64_t amount) {
+    local()->counters[(int) counter].fetch_add(amount, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Records one run of an operation in the latency histogram of the calling thread.
+ * @param operation The operation.
+ * @param nanoseconds How long it took.
+ * @note Time complexity: O(log nanoseconds).
+ */
+void Instrumentation::record(Operation operation, uint64_t nanoseconds) {
+    ThreadSlot* slot = local();
+    slot->histograms[(int) operation][bucketOf(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    slot->totalNs[(int) operation].fetch_add(nanoseconds, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Sums a counter over every thread.
+ * @param counter The counter.
+ * @return Its total so far.
+ * @note Time complexity: O(T) where T is the largest number of threads that recorded something at once.
+ */
+uint64_t Instrumentation::total(Counter counter) {
+    uint64_t sum = retired.counters[(int) counter].load(std::memory_order_relaxed);
+    int used = numSlots.load();
+    for (int t = 0; t < used; t++) sum += slots[t].counters[(int) counter].load(std::memory_order_relaxed);
+    return sum;
+}
+
+/**
+ * @brief Merges the histograms of every thread into one summary per operation.
+ * @return The summary of every operation, in declaration order.
+ * @note Time complexity: O(T * O * B) for T slots ever claimed, O operations and B buckets.
+ */
+std::vector<Instrumentation::OperationStats> Instrumentation::operations() {
+    int used = numSlots.load();
+    std::vector<OperationStats> stats;
+    for (int op = 0; op < NumOperations; op++) {
+        uint64_t histogram[Buckets] = {};
+        uint64_t count = 0, totalNs = 0;
+        for (int t = -1; t < used; t++) {
+            const ThreadSlot& slot = t < 0 ? retired : slots[t];
+            for (int b = 0; b < Buckets; b++) histogram[b] += slot.histograms[op][b].load(std::memory_order_relaxed);
+            totalNs += slot.totalNs[op].load(std::memory_order_relaxed);
+        }
+        for (uint64_t n : histogram) count += n;
+
+        // Bucket b holds latencies below 2^b ns
+        auto upperUs = [](int bucket) { return (double) (1ULL << bucket) / 1000.0; };
+        auto percentile = [&](double fraction) {
+            uint64_t rank = (uint64_t) (fraction * (count - 1)), seen = 0;
+            for (int b = 0; b < Buckets; b++) {
+                seen += histogram[b];
+                if (seen > rank) return upperUs(b);
+            }
+            return upperUs(Buckets - 1);
+        };
+        OperationStats operation = {getName((Operation) op), count, totalNs / 1e6, 0, 0, 0, 0};
+        if (count > 0) {
+            int highest = Buckets - 1;
+            while (histogram[highest] == 0) highest--;
+            operation.meanUs = totalNs / 1000.0 / count;
+            operation.p50Us = percentile(0.5);
+            operation.p99Us = percentile(0.99);
+            operation.maxUs = upperUs(highest);
+        }
+        stats.push_back(operation);
+    }
+    return stats;
+}
+
+/**
+ * @brief Serialises every counter and every operation summary.
+ * @return A JSON object.
+ */
+std::string Instrumentation::toJson() {
+    JsonObject counters;
+    for (int c = 0; c < NumCounters; c++) counters.add(getName((Counter) c), total((Counter) c));
+    JsonArray operationsJson;
+    for (const auto& operation : operations()) {
+        operationsJson.pushRaw(JsonObject()
+                                       .add("name", operation.name)
+                                       .add("count", operation.count)
+                                       .add("total_ms", operation.totalMs)
+                                       .add("mean_us", operation.meanUs)
+                                       .add("p50_us", operation.p50Us)
+                                       .add("p99_us", operation.p99Us)
+                                       .add("max_us", operation.maxUs)
+                                       .str());
+    }
+    return JsonObject()
+            .add("enabled", isEnabled())
+            .addRaw("counters", counters.str())
+            .addRaw("operations", operationsJson.str())
+            .str();
+}
+
+/**
+ * @brief Clears every counter and histogram. Recording that runs concurrently may be partly lost.
+ */
+void Instrumentation::reset() {
+    int used = numSlots.load();
+    for (int t = -1; t < used; t++) {
+        ThreadSlot& slot = t < 0 ? retired : slots[t];
+        for (auto& counter : slot.counters) counter.store(0, std::memory_order_relaxed);
+        for (auto& histogram : slot.histograms) {
+            for (auto& bucket : histogram) bucket.store(0, std::memory_order_relaxed);
+        }
+        for (auto& total : slot.totalNs) total.store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Writes toJson() to a file when the program exits normally.
+ * @param filename File to write; a later call replaces it.
+ */
+void Instrumentation::dumpAtExit(const std::string& filename) {
+    if (dumpFilename.empty()) std::atexit(dumpReport);
+    dumpFilename = filename;
+}
+
+#ifdef FLIGHT_INSTRUMENTATION
+// Counting every allocation of the program. Every form of operator new and delete is replaced, so that
+// all of them pair malloc with free
+namespace {
+
+void* allocate(std::size_t size) noexcept {
+    Instrumentation::add(Instrumentation::Counter::Allocations, 1);
+    Instrumentation::add(Instrumentation::Counter::AllocatedBytes, size);
+    return std::malloc(size ? size : 1);
+}
+
+}
+
+void* operator new(std::size_t size) {
+    if (void* p = allocate(size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    if (void* p = allocate(size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+#endif
@@ -0,0 +1,121 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Per-operation latency histograms and work counters for the hot paths.
+ *
+ * Every thread records into its own slot (claimed once, without locks), so recording is a
+ * relaxed atomic add on a cache line no other thread writes; totals are only summed when a
+ * report is asked for. A thread that exits folds its counts into the retired totals and hands
+ * its slot back for the next thread. Latencies go into power-of-two nanosecond buckets.
+ *
+ * The INSTRUMENT_* macros compile to nothing unless FLIGHT_INSTRUMENTATION is defined (the
+ * CMake option of the same name), and so does the allocation counting.
+ */
+class Instrumentation {
+public:
+    enum class Operation {
+        ReadAirports, ReadAirlines, ReadFlights, ApplyFlightDelta,
+        FindBestFlight, FilteredSearch, EarliestArrival, JourneyProfile, ReadTimetable,
+        ShortestRoute, BuildHierarchy, BuildHopLabels,
+        Reachable, LongestPath, TopKAirports, EssentialAirports, ComputeAll,
+        ReachSketches, Betweenness, PageRank,
+        ServerRequest,
+        Count
+    };
+
+    enum class Counter {
+        RowsParsed, VerticesDequeued, EdgesScanned, FlightsInspected, ConnectionsScanned, Allocations, AllocatedBytes,
+        Count
+    };
+
+    struct OperationStats {
+        std::string name;
+        uint64_t count;
+        double totalMs;
+        double meanUs;
+        double p50Us;   // upper bound of the histogram bucket holding the median
+        double p99Us;   // upper bound of the histogram bucket holding the 99th percentile
+        double maxUs;   // upper bound of the highest non-empty bucket
+    };
+
+    static const int Buckets = 64;
+
+    static bool isEnabled();
+    static const char* getName(Operation operation);
+    static const char* getName(Counter counter);
+
+    static void add(Counter counter, uint64_t amount);
+    static void record(Operation operation, uint64_t nanoseconds);
+
+    static uint64_t total(Counter counter);
+    static std::vector<OperationStats> operations();
+    static std::string toJson();
+    static void reset();
+    static void dumpAtExit(const std::string& filename);
+
+    /**
+     * @brief Records the time between its construction and its destruction under an operation.
+     */
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(Operation operation) : operation(operation), start(std::chrono::steady_clock::now()) {}
+        ~ScopedTimer() {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            record(operation, (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        }
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        Operation operation;
+        std::chrono::steady_clock::time_point start;
+    };
+
+private:
+    static const int NumOperations = (int) Operation::Count;
+    static const int NumCounters = (int) Counter::Count;
+
+    struct alignas(64) ThreadSlot {
+        std::atomic<uint64_t> counters[NumCounters];
+        std::atomic<uint64_t> histograms[NumOperations][Buckets];
+        std::atomic<uint64_t> totalNs[NumOperations];
+        std::atomic<bool> claimed;
+    };
+
+    // Hands the slot of its thread back when the thread exits
+    struct SlotLease {
+        ThreadSlot** slot = nullptr;
+        ~SlotLease();
+    };
+
+    static const int MaxThreads = 256;  // threads alive at once beyond this record into the retired totals
+    static ThreadSlot slots[MaxThreads];
+    static ThreadSlot retired;          // counts of the threads that exited
+    static std::atomic<int> numSlots;   // slots ever claimed: [0, numSlots) may hold counts
+
+    static ThreadSlot* local();
+    static ThreadSlot* claim();
+    static void release(ThreadSlot* slot);
+    static int bucketOf(uint64_t nanoseconds);
+};
+
+#ifdef FLIGHT_INSTRUMENTATION
+#define INSTRUMENT_CONCAT_(a, b) a##b
+#define INSTRUMENT_CONCAT(a, b) INSTRUMENT_CONCAT_(a, b)
+#define INSTRUMENT_SCOPE(operation) \
+    Instrumentation::ScopedTimer INSTRUMENT_CONCAT(instrumentTimer, __LINE__)(Instrumentation::Operation::operation)
+#define INSTRUMENT_COUNT(counter, amount) \
+    Instrumentation::add(Instrumentation::Counter::counter, (uint64_t) (amount))
+#else
+#define INSTRUMENT_SCOPE(operation) ((void) 0)
+#define INSTRUMENT_COUNT(counter, amount) ((void) 0)
+#endif
+
+#endif // INSTRUMENTATION_H
@@ -0,0 +1,262 @@
+#include "Json.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+
+/**
+ * @brief Quotes and escapes a string.
+ * @param value The string.
+ * @return The JSON string literal.
+ * @note Time complexity: O(N) where N is the length of the string.
+ */
+std::string Json::quote(const std::string& value) {
+    std::string out = "\"";
+    for (char c : value) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if ((unsigned char) c < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    out += buffer;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out + "\"";
+}
+
+/**
+ * @brief Formats a number, writing null for values JSON cannot represent (NaN, infinity).
+ * @param value The number.
+ * @return The JSON number.
+ */
+std::string Json::number(double value) {
+    if (!std::isfinite(value)) return "null";
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.10g", value);
+    return buffer;
+}
+
+/**
+ * @brief Parses an object whose members are null, booleans, numbers, strings or arrays of those.
+ *
+ * Nested objects are not supported: queries never need them.
+ *
+ * @param text The JSON text.
+ * @param members Filled with the members of the object; a repeated key keeps its last value.
+ * @param error Set to what went wrong when parsing fails.
+ * @return True if the text is such an object.
+ * @note Time complexity: O(N) where N is the length of the text.
+ */
+bool Json::parseObject(const std::string& text, std::map<std::string, JsonValue>& members, std::string& error) {
+    size_t pos = 0;
+    skipSpaces(text, pos);
+    if (pos >= text.size() || text[pos] != '{') {
+        error = "expected an object";
+        return false;
+    }
+    pos++;
+    skipSpaces(text, pos);
+    if (pos < text.size() && text[pos] == '}') {
+        pos++;
+    } else {
+        while (true) {
+            std::string key;
+            JsonValue value;
+            skipSpaces(text, pos);
+            if (!parseString(text, pos, key, error)) return false;
+            skipSpaces(text, pos);
+            if (pos >= text.size() || text[pos] != ':') {
+                error = "expected ':' after \"" + key + "\"";
+                return false;
+            }
+            pos++;
+            if (!parseValue(text, pos, value, error)) return false;
+            members[key] = value;
+            skipSpaces(text, pos);
+            if (pos < text.size() && text[pos] == ',') {
+                pos++;
+            } else if (pos < text.size() && text[pos] == '}') {
+                pos++;
+                break;
+            } else {
+                error = "expected ',' or '}'";
+                return false;
+            }
+        }
+    }
+    skipSpaces(text, pos);
+    if (pos != text.size()) {
+        error = "unexpected text after the object";
+        return false;
+    }
+    return true;
+}
+
+bool Json::parseValue(const std::string& text, size_t& pos, JsonValue& value, std::string& error) {
+    skipSpaces(text, pos);
+    if (pos >= text.size()) {
+        error = "unexpected end of input";
+        return false;
+    }
+    char c = text[pos];
+    if (c == '"') {
+        value.type = JsonValue::String;
+        return parseString(text, pos, value.text, error);
+    }
+    if (c == '[') {
+        value.type = JsonValue::Array;
+        pos++;
+        skipSpaces(text, pos);
+        if (pos < text.size() && text[pos] == ']') {
+            pos++;
+            return true;
+        }
+        while (true) {
+            JsonValue item;
+            if (!parseValue(text, pos, item, error)) return false;
+            value.items.push_back(item);
+            skipSpaces(text, pos);
+            if (pos < text.size() && text[pos] == ',') {
+                pos++;
+            } else if (pos < text.size() && text[pos] == ']') {
+                pos++;
+                return true;
+            } else {
+                error = "expected ',' or ']'";
+                return false;
+            }
+        }
+    }
+    for (const char* literal : {"true", "false", "null"}) {
+        if (text.compare(pos, strlen(literal), literal) == 0) {
+            pos += strlen(literal);
+            value.type = literal[0] == 'n' ? JsonValue::Null : JsonValue::Bool;
+            value.boolean = literal[0] == 't';
+            return true;
+        }
+    }
+    const char* start = text.c_str() + pos;
+    char* end = nullptr;
+    value.number = std::strtod(start, &end);
+    if (end == start || c == '{') {
+        error = c == '{' ? "nested objects are not supported" : "unexpected character '" + std::string(1, c) + "'";
+        return false;
+    }
+    value.type = JsonValue::Number;
+    pos += end - start;
+    return true;
+}
+
+bool Json::parseString(const std::string& text, size_t& pos, std::string& value, std::string& error) {
+    if (pos >= text.size() || text[pos] != '"') {
+        error = "expected a string";
+        return false;
+    }
+    for (pos++; pos < text.size(); pos++) {
+        char c = text[pos];
+        if (c == '"') {
+            pos++;
+            return true;
+        }
+        if (c != '\\') {
+            value += c;
+            continue;
+        }
+        if (++pos >= text.size()) break;
+        switch (text[pos]) {
+            case 'n': value += '\n'; break;
+            case 'r': value += '\r'; break;
+            case 't': value += '\t'; break;
+            case 'b': value += '\b'; break;
+            case 'f': value += '\f'; break;
+            case 'u': {
+                // Code points are written back as UTF-8
+                if (pos + 4 >= text.size()) break;
+                unsigned code = (unsigned) std::strtoul(text.substr(pos + 1, 4).c_str(), nullptr, 16);
+                pos += 4;
+                if (code < 0x80) {
+                    value += (char) code;
+                } else if (code < 0x800) {
+                    value += (char) (0xC0 | (code >> 6));
+                    value += (char) (0x80 | (code & 0x3F));
+                } else {
+                    value += (char) (0xE0 | (code >> 12));
+                    value += (char) (0x80 | ((code >> 6) & 0x3F));
+                    value += (char) (0x80 | (code & 0x3F));
+                }
+                break;
+            }
+            default: value += text[pos];
+        }
+    }
+    error = "unterminated string";
+    return false;
+}
+
+void Json::skipSpaces(const std::string& text, size_t& pos) {
+    while (pos < text.size() && isspace((unsigned char) text[pos])) pos++;
+}
+
+JsonObject& JsonObject::add(const std::string& key, const std::string& value) {
+    return addRaw(key, Json::quote(value));
+}
+
+JsonObject& JsonObject::add(const std::string& key, const char* value) {
+    return addRaw(key, Json::quote(value));
+}
+
+JsonObject& JsonObject::add(const std::string& key, double value) {
+    return addRaw(key, Json::number(value));
+}
+
+JsonObject& JsonObject::add(const std::string& key, bool value) {
+    return addRaw(key, value ? "true" : "false");
+}
+
+/**
+ * @brief Adds a member whose value is already valid JSON (e.g. a nested object or array).
+ * @param key Member name.
+ * @param json Member value.
+ * @return This object.
+ */
+JsonObject& JsonObject::addRaw(const std::string& key, const std::string& json) {
+    if (!members.empty()) members += ",";
+    members += Json::quote(key) + ":" + json;
+    return *this;
+}
+
+std::string JsonObject::str() const {
+    return "{" + members + "}";
+}
+
+JsonArray& JsonArray::push(const std::string& value) {
+    return pushRaw(Json::quote(value));
+}
+
+JsonArray& JsonArray::push(double value) {
+    return pushRaw(Json::number(value));
+}
+
+/**
+ * @brief Adds an element that is already valid JSON (e.g. a nested object or array).
+ * @param json The element.
+ * @return This array.
+ */
+JsonArray& JsonArray::pushRaw(const std::string& json) {
+    if (!elements.empty()) elements += ",";
+    elements += json;
+    return *this;
+}
+
+std::string JsonArray::str() const {
+    return "[" + elements + "]";
+}
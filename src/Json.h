@@ -0,0 +1,80 @@
+#ifndef JSON_H
+#define JSON_H
+
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief A parsed JSON value: null, a boolean, a number, a string or an array of values.
+ */
+struct JsonValue {
+    enum Type { Null, Bool, Number, String, Array };
+
+    Type type = Null;
+    bool boolean = false;
+    double number = 0;
+    std::string text;
+    std::vector<JsonValue> items;
+};
+
+/**
+ * @brief Helpers to write JSON values, and to read the flat objects used as queries.
+ */
+class Json {
+public:
+    static std::string quote(const std::string& value);
+    static std::string number(double value);
+
+    static bool parseObject(const std::string& text, std::map<std::string, JsonValue>& members, std::string& error);
+
+private:
+    static bool parseValue(const std::string& text, size_t& pos, JsonValue& value, std::string& error);
+    static bool parseString(const std::string& text, size_t& pos, std::string& value, std::string& error);
+    static void skipSpaces(const std::string& text, size_t& pos);
+};
+
+/**
+ * @brief Builds a JSON object one member at a time.
+ */
+class JsonObject {
+public:
+    JsonObject& add(const std::string& key, const std::string& value);
+    JsonObject& add(const std::string& key, const char* value);
+    JsonObject& add(const std::string& key, double value);
+    JsonObject& add(const std::string& key, bool value);
+    JsonObject& addRaw(const std::string& key, const std::string& json);
+
+    template <class T, class = typename std::enable_if<std::is_integral<T>::value>::type>
+    JsonObject& add(const std::string& key, T value) {
+        return addRaw(key, std::to_string(value));
+    }
+
+    std::string str() const;
+
+private:
+    std::string members;
+};
+
+/**
+ * @brief Builds a JSON array one element at a time.
+ */
+class JsonArray {
+public:
+    JsonArray& push(const std::string& value);
+    JsonArray& push(double value);
+    JsonArray& pushRaw(const std::string& json);
+
+    template <class T, class = typename std::enable_if<std::is_integral<T>::value>::type>
+    JsonArray& push(T value) {
+        return pushRaw(std::to_string(value));
+    }
+
+    std::string str() const;
+
+private:
+    std::string elements;
+};
+
+#endif // JSON_H
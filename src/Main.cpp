@@ -1,7 +1,175 @@
 #include "UserInterface.h"
+#include "BatchRunner.h"
+#include "Server.h"
+#include <cstdlib>
+#include <csignal>
+#include <cstring>
+#include <fstream>
 
-int main() {
-    UserInterface ui;
-    ui.run();
-    return 0;
+/**
+ * @brief Prints the command-line options.
+ */
+static void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [--dataset DIR] [QUERY... | (--serve SOCKET | --port N) [--workers N] [--watch MS]]\n"
+              << "Without queries, starts the interactive menu. Each query prints one JSON line:\n"
+              << "  --search SOURCE DESTINATION\n"
+              << "  --filtered SOURCE DESTINATION [--airlines CODE,CODE] [--minimize-changes]\n"
+              << "  --suggest TEXT [--limit N] [--edits N]   airports, cities, countries and airlines named like TEXT\n"
+              << "  --shortest SOURCE DESTINATION   fewest kilometres, each route by great-circle distance\n"
+              << "  --earliest SOURCE DESTINATION [--depart TIME]   earliest arrival on the timetable\n"
+              << "  --profile SOURCE DESTINATION [--depart TIME] [--until TIME]   every useful departure of a window\n"
+              << "  --stat NAME [--airport CODE] [--city NAME] [--country NAME] [--stops N] [--k N]\n"
+              << "              [--metric NAME] [--pivots N] [--bucket-km KM]\n"
+              << "  --queries FILE    one JSON query object per line ('-' reads stdin)\n"
+              << "--serve and --port answer the same queries, as length-prefixed JSON frames, until interrupted;\n"
+              << "{\"type\": \"reload\"} loads the dataset again without pausing them, and --watch reloads it\n"
+              << "whenever its files change, checking every MS milliseconds.\n"
+              << "Times are minutes or HH:MM, with +D on the D-th day of the timetable after the first (08:30+1).\n"
+              << "Options after a query apply to it. Statistics:";
+    for (const auto& name : BatchRunner::getStatisticNames()) std::cout << ' ' << name;
+    std::cout << std::endl;
+}
+
+static Server* runningServer = nullptr;
+
+static void stopServer(int) {
+    if (runningServer) runningServer->stop();
+}
+
+static JsonValue stringValue(const std::string& text) {
+    JsonValue value;
+    value.type = JsonValue::String;
+    value.text = text;
+    return value;
+}
+
+int main(int argc, char* argv[]) {
+    // FLIGHT_INSTRUMENTATION_JSON=file writes the instrumentation report to file on exit
+    if (const char* report = std::getenv("FLIGHT_INSTRUMENTATION_JSON")) {
+        Instrumentation::dumpAtExit(report);
+    }
+
+    std::string datasetPath = "../dataset/";
+    std::vector<std::map<std::string, JsonValue>> queries;  // from the command line, in order
+    std::vector<std::string> queryFiles;                     // processed after them
+    std::string socketPath;
+    int port = 0, workers = 0, watchMs = 0;
+    // Options that take a value and are copied into the last query
+    const std::pair<const char*, const char*> queryOptions[] = {
+            {"--airlines", "airlines"}, {"--airport", "airport"}, {"--city", "city"}, {"--country", "country"},
+            {"--stops", "stops"}, {"--k", "k"}, {"--metric", "metric"}, {"--pivots", "pivots"}, {"--bucket-km", "bucket_km"},
+            {"--limit", "limit"}, {"--edits", "edits"}, {"--depart", "depart"}, {"--until", "until"},
+    };
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto needs = [&](int values) {
+            if (i + values < argc) return true;
+            std::cerr << arg << " needs " << values << (values == 1 ? " value" : " values") << std::endl;
+            std::exit(2);
+        };
+        bool handled = false;
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "--dataset" && needs(1)) {
+            datasetPath = argv[++i];
+            if (datasetPath.back() != '/') datasetPath += '/';
+            handled = true;
+        } else if ((arg == "--search" || arg == "--filtered" || arg == "--shortest" || arg == "--earliest" || arg == "--profile") && needs(2)) {
+            std::map<std::string, JsonValue> query;
+            query["type"] = stringValue(arg.substr(2));
+            query["source"] = stringValue(argv[++i]);
+            query["destination"] = stringValue(argv[++i]);
+            queries.push_back(query);
+            handled = true;
+        } else if (arg == "--stat" && needs(1)) {
+            std::map<std::string, JsonValue> query;
+            query["type"] = stringValue("stat");
+            query["name"] = stringValue(argv[++i]);
+            queries.push_back(query);
+            handled = true;
+        } else if (arg == "--suggest" && needs(1)) {
+            std::map<std::string, JsonValue> query;
+            query["type"] = stringValue("suggest");
+            query["text"] = stringValue(argv[++i]);
+            queries.push_back(query);
+            handled = true;
+        } else if (arg == "--serve" && needs(1)) {
+            socketPath = argv[++i];
+            handled = true;
+        } else if ((arg == "--port" || arg == "--workers" || arg == "--watch") && needs(1)) {
+            (arg == "--port" ? port : arg == "--workers" ? workers : watchMs) = std::atoi(argv[++i]);
+            handled = true;
+        } else if (arg == "--queries" && needs(1)) {
+            queryFiles.push_back(argv[++i]);
+            handled = true;
+        } else if (arg == "--minimize-changes" && !queries.empty()) {
+            queries.back()["minimize_changes"] = stringValue("true");
+            handled = true;
+        }
+        for (const auto& option : queryOptions) {
+            if (!handled && arg == option.first && needs(1)) {
+                if (queries.empty()) {
+                    std::cerr << arg << " must follow --search, --filtered, --shortest, --suggest, --earliest, --profile or --stat" << std::endl;
+                    return 2;
+                }
+                queries.back()[option.second] = stringValue(argv[++i]);
+                handled = true;
+            }
+        }
+        if (!handled) {
+            std::cerr << "Unknown option " << arg << " (see --help)" << std::endl;
+            return 2;
+        }
+    }
+
+    if (!socketPath.empty() || port > 0) {
+        BatchRunner runner(datasetPath);
+        Server server(runner, workers);
+        if (socketPath.empty() ? !server.listenTcp(port) : !server.listenUnix(socketPath)) {
+            std::cerr << "Cannot listen on " << (socketPath.empty() ? "port " + std::to_string(port) : socketPath) << std::endl;
+            return 1;
+        }
+        runningServer = &server;
+        signal(SIGINT, stopServer);
+        signal(SIGTERM, stopServer);
+        std::cerr << runner.getLoadReport() << std::endl;
+        runner.startWatching(watchMs);
+        server.serve();
+        std::cerr << "Served " << server.getRequestsServed() << " requests" << std::endl;
+        runningServer = nullptr;
+        return 0;
+    }
+
+    if (queries.empty() && queryFiles.empty()) {
+        UserInterface ui(datasetPath);
+        ui.run();
+        return 0;
+    }
+
+    // Batch mode: load once, answer every query, one JSON line each
+    BatchRunner runner(datasetPath);
+    std::cout << runner.getLoadReport() << '\n';
+    long failed = 0;
+    for (const auto& query : queries) {
+        bool ok;
+        std::cout << runner.run(query, &ok) << '\n';
+        if (!ok) failed++;
+    }
+    for (const auto& file : queryFiles) {
+        if (file == "-") {
+            failed += runner.runAll(std::cin, std::cout);
+            continue;
+        }
+        std::ifstream in(file);
+        if (!in) {
+            std::cout << JsonObject().add("ok", false).add("error", "cannot open query file " + file).str() << '\n';
+            failed++;
+            continue;
+        }
+        failed += runner.runAll(in, std::cout);
+    }
+    std::cout.flush();
+    return failed == 0 ? 0 : 1;
 }
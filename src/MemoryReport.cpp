@@ -0,0 +1,69 @@
+#include "MemoryReport.h"
+#include "Json.h"
+
+/**
+ * @brief Adds a component to the report.
+ * @param name Dotted name, the owner first (graph.flights, engine.geo_index, ...).
+ * @param bytes Bytes it holds.
+ * @param items Number of things it holds.
+ * @param counted Whether the bytes were read from an allocator rather than estimated.
+ */
+void MemoryReport::add(const std::string& name, size_t bytes, size_t items, bool counted) {
+    components.push_back({name, bytes, items, counted});
+}
+
+const std::vector<MemoryReport::Component>& MemoryReport::getComponents() const {
+    return components;
+}
+
+/**
+ * @brief Sums the bytes of every component.
+ * @return The total number of bytes.
+ */
+size_t MemoryReport::getTotalBytes() const {
+    size_t total = 0;
+    for (const auto& component : components) total += component.bytes;
+    return total;
+}
+
+/**
+ * @brief Serialises the report.
+ * @return A JSON object with the total and every component, in the order they were added.
+ */
+std::string MemoryReport::toJson() const {
+    JsonArray array;
+    for (const auto& component : components) {
+        array.pushRaw(JsonObject()
+                              .add("name", component.name)
+                              .add("bytes", component.bytes)
+                              .add("items", component.items)
+                              .add("counted", component.counted)
+                              .str());
+    }
+    return JsonObject().add("total_bytes", getTotalBytes()).addRaw("components", array.str()).str();
+}
+
+/**
+ * @brief Gets the heap bytes of a string: none while it fits in the buffer inside the string object.
+ * @param value The string.
+ * @return Its capacity plus the terminator if it overflowed to the heap, otherwise 0.
+ * @note Time complexity: O(1)
+ */
+size_t MemoryReport::bytesOf(const std::string& value) {
+    const char* data = value.data();
+    const char* object = reinterpret_cast<const char*>(&value);
+    bool inside = data >= object && data < object + sizeof(std::string);
+    return inside ? 0 : value.capacity() + 1;
+}
+
+/**
+ * @brief Gets the heap bytes of a vector of strings: its buffer and every string's own.
+ * @param values The strings.
+ * @return The number of bytes.
+ * @note Time complexity: O(N) where N is the number of strings.
+ */
+size_t MemoryReport::bytesOf(const std::vector<std::string>& values) {
+    size_t bytes = values.capacity() * sizeof(std::string);
+    for (const auto& value : values) bytes += bytesOf(value);
+    return bytes;
+}
@@ -0,0 +1,62 @@
+#ifndef MEMORYREPORT_H
+#define MEMORYREPORT_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Bytes held by every component of a loaded dataset, so that representation changes can be
+ *        judged by numbers.
+ *
+ * A component is either counted, read from the allocator that handed its memory out (the graph's
+ * arena, the string pool), or estimated by walking its containers: vectors by their capacity,
+ * strings by their heap buffer, hash tables by their bucket array plus one node per entry (a next
+ * pointer, the entry and a cached hash) and ordered trees by one node per entry (three pointers and
+ * a colour). Estimates ignore the malloc headers and rounding around every block.
+ */
+class MemoryReport {
+public:
+    struct Component {
+        std::string name;
+        size_t bytes;
+        size_t items;  // vertices, flights, strings, ... whatever the component holds
+        bool counted;  // read from an allocator rather than estimated
+    };
+
+    void add(const std::string& name, size_t bytes, size_t items, bool counted = false);
+    const std::vector<Component>& getComponents() const;
+    size_t getTotalBytes() const;
+    std::string toJson() const;
+
+    static size_t bytesOf(const std::string& value);
+    static size_t bytesOf(const std::vector<std::string>& values);
+
+    template <class T>
+    static size_t bytesOf(const std::vector<T>& values) {
+        return values.capacity() * sizeof(T);
+    }
+
+    template <class T>
+    static size_t bytesOf(const std::vector<std::vector<T>>& values) {
+        size_t bytes = values.capacity() * sizeof(std::vector<T>);
+        for (const auto& inner : values) bytes += bytesOf(inner);
+        return bytes;
+    }
+
+    template <class Table>
+    static size_t hashTableBytes(const Table& table) {
+        return table.bucket_count() * sizeof(void*)
+               + table.size() * (sizeof(void*) + sizeof(typename Table::value_type) + sizeof(size_t));
+    }
+
+    template <class Tree>
+    static size_t treeBytes(const Tree& tree) {
+        return tree.size() * (3 * sizeof(void*) + sizeof(int) + sizeof(typename Tree::value_type));
+    }
+
+private:
+    std::vector<Component> components;
+};
+
+#endif // MEMORYREPORT_H
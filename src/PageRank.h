@@ -0,0 +1,33 @@
+#ifndef PAGERANK_H
+#define PAGERANK_H
+
+#include "DenseGraph.h"
+#include <vector>
+
+/**
+ * @brief Flight-weighted PageRank of the airports.
+ *
+ * A random traveller takes a route with probability proportional to its number of flights,
+ * and with probability 1 - damping (or from an airport with no departures) jumps to an airport
+ * drawn from the teleport distribution: uniform for the global ranking, or a single airport
+ * for the personalised one.
+ */
+class PageRank {
+public:
+    struct Result {
+        std::vector<double> scores;  // vertex id -> probability, summing to 1
+        int iterations;
+        double residual;             // L1 change in the last iteration
+    };
+
+    static Result compute(const DenseGraph& graph, double damping = 0.85, double tolerance = 1e-10,
+                          int maxIterations = 200, int threads = 0);
+    static Result personalized(const DenseGraph& graph, int source, double damping = 0.85, double tolerance = 1e-10,
+                               int maxIterations = 200, int threads = 0);
+
+private:
+    static Result run(const DenseGraph& graph, const std::vector<double>& teleport, double damping,
+                      double tolerance, int maxIterations, int threads);
+};
+
+#endif // PAGERANK_H
@@ -0,0 +1,167 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+/**
+ * @brief Helpers to split loops over a range of indexes across threads.
+ *
+ * The threads come from a pool kept for the life of the process, which grows to the largest number
+ * of threads any loop asked for; a loop therefore costs a wake-up rather than creating threads.
+ * The pool runs one loop at a time: a loop started while it is busy, by another thread or from
+ * inside a loop, runs all of its chunks on the calling thread.
+ */
+class Parallel {
+public:
+    /**
+     * @brief Gets the number of threads to use when the caller does not choose one.
+     * @return The number of hardware threads, or 1 if it is unknown.
+     */
+    static int defaultThreads() {
+        unsigned n = std::thread::hardware_concurrency();
+        return n == 0 ? 1 : (int) n;
+    }
+
+    /**
+     * @brief Runs fn(begin, end, thread) over contiguous chunks of [0, n), one chunk per thread.
+     *
+     * The calling thread runs the first chunk, so a single thread never involves the pool. If the pool
+     * is busy, the calling thread runs every chunk in turn, each still with its own thread index.
+     *
+     * @param n Number of indexes.
+     * @param threads Number of threads (values below 1 use defaultThreads()).
+     * @param fn Function called with the chunk bounds and the index of the thread running it.
+     * @return The number of threads actually used, which is never more than n.
+     */
+    template <class F>
+    static int forRange(size_t n, int threads, F fn) {
+        if (threads < 1) threads = defaultThreads();
+        threads = (int) std::max<size_t>(1, std::min<size_t>(threads, n));
+        size_t chunk = (n + threads - 1) / threads;
+
+        std::function<void(int)> part = [&fn, n, chunk](int t) {
+            size_t begin = std::min(n, t * chunk);
+            fn(begin, std::min(n, begin + chunk), t);
+        };
+        if (threads == 1 || !pool().run(threads, part)) {
+            for (int t = 0; t < threads; t++) part(t);
+        }
+        return threads;
+    }
+
+    /**
+     * @brief Runs fn(i, thread) for every i in [0, n), handing indexes out one at a time.
+     *
+     * Suited to loops where the cost of each index varies a lot, such as one search per source.
+     *
+     * @param n Number of indexes.
+     * @param threads Number of threads (values below 1 use defaultThreads()).
+     * @param fn Function called with each index and the index of the thread running it.
+     * @return The number of threads actually used.
+     */
+    template <class F>
+    static int forEach(size_t n, int threads, F fn) {
+        if (threads < 1) threads = defaultThreads();
+        std::atomic<size_t> next(0);
+        return forRange(std::min<size_t>(threads, n), threads, [&](size_t, size_t, int thread) {
+            for (size_t i = next++; i < n; i = next++) {
+                fn(i, thread);
+            }
+        });
+    }
+
+private:
+    // Worker threads waiting for the next loop; worker i runs part i of it
+    class Pool {
+    public:
+        Pool() = default;
+        Pool(const Pool&) = delete;
+        Pool& operator=(const Pool&) = delete;
+
+        ~Pool() {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (auto& worker : workers) worker.join();
+        }
+
+        // Runs part(0) on the calling thread and part(1 .. parts - 1) on workers; false if the pool is busy
+        bool run(int parts, const std::function<void(int)>& part) {
+            bool& running = inLoop();
+            if (running) return false;
+            std::unique_lock<std::mutex> owner(busy, std::try_to_lock);
+            if (!owner.owns_lock()) return false;
+
+            std::unique_lock<std::mutex> guard(lock);
+            while ((int) workers.size() < parts - 1) {
+                workers.emplace_back(&Pool::work, this, (int) workers.size() + 1);
+            }
+            task = &part;
+            numParts = parts;
+            pending = parts - 1;
+            generation++;
+            guard.unlock();
+            wake.notify_all();
+
+            running = true;
+            part(0);
+            running = false;
+
+            guard.lock();
+            done.wait(guard, [this]() { return pending == 0; });
+            task = nullptr;
+            return true;
+        }
+
+    private:
+        std::mutex busy;  // held by the thread whose loop the pool is running
+        std::mutex lock;  // guards everything below
+        std::condition_variable wake, done;
+        std::vector<std::thread> workers;
+        const std::function<void(int)>* task = nullptr;
+        int numParts = 0;
+        int pending = 0;  // parts still running on workers
+        long generation = 0;
+        bool stopping = false;
+
+        void work(int index) {
+            inLoop() = true;  // loops started by a part run on its thread
+            long seen = 0;
+            std::unique_lock<std::mutex> guard(lock);
+            while (true) {
+                wake.wait(guard, [&]() { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                if (index < numParts) {
+                    const std::function<void(int)>* job = task;
+                    guard.unlock();
+                    (*job)(index);
+                    guard.lock();
+                    if (--pending == 0) done.notify_one();
+                }
+            }
+        }
+    };
+
+    static Pool& pool() {
+        static Pool instance;
+        return instance;
+    }
+
+    // Whether the current thread is running a part of a loop
+    static bool& inLoop() {
+        static thread_local bool value = false;
+        return value;
+    }
+};
+
+#endif // PARALLEL_H
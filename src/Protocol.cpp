@@ -0,0 +1,176 @@
+#include "Protocol.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0  // macOS: the server ignores SIGPIPE instead
+#endif
+
+/**
+ * @brief Reads one frame.
+ * @param fd Connected socket.
+ * @param payload Set to the JSON payload.
+ * @param timeoutMs Time the whole frame must arrive in, however it is split; negative to wait as long as it takes.
+ * @return False if the peer closed the connection, on a read error, if the frame is larger than MaxFrameBytes
+ *         or if it did not arrive in time.
+ */
+bool Protocol::readFrame(int fd, std::string& payload, int timeoutMs) {
+    Deadline deadline = deadlineAfter(timeoutMs);
+    unsigned char header[4];
+    if (!readFully(fd, (char*) header, sizeof(header), deadline)) return false;
+    uint32_t size = (uint32_t) header[0] << 24 | (uint32_t) header[1] << 16 | (uint32_t) header[2] << 8 | header[3];
+    if (size > MaxFrameBytes) return false;
+    payload.resize(size);
+    return size == 0 || readFully(fd, &payload[0], size, deadline);
+}
+
+/**
+ * @brief Writes one frame.
+ * @param fd Connected socket.
+ * @param payload The JSON payload.
+ * @param timeoutMs Time the peer must take the whole frame in; negative to wait as long as it takes.
+ * @return False on a write error (e.g. the peer went away), if the payload is larger than MaxFrameBytes
+ *         or if the peer did not take it in time.
+ */
+bool Protocol::writeFrame(int fd, const std::string& payload, int timeoutMs) {
+    if (payload.size() > MaxFrameBytes) return false;
+    uint32_t size = (uint32_t) payload.size();
+    // Header and payload in one buffer, so small frames go out in a single send
+    std::string frame(4, '\0');
+    frame[0] = (char) (size >> 24);
+    frame[1] = (char) (size >> 16);
+    frame[2] = (char) (size >> 8);
+    frame[3] = (char) size;
+    frame += payload;
+    return writeFully(fd, frame.data(), frame.size(), deadlineAfter(timeoutMs));
+}
+
+/**
+ * @brief Listens on a Unix domain socket, replacing a stale socket file at the same path.
+ * @param path Path of the socket file.
+ * @return The listening socket, or -1 on error.
+ */
+int Protocol::listenUnix(const std::string& path) {
+    sockaddr_un address = {};
+    if (path.size() >= sizeof(address.sun_path)) return -1;
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    unlink(path.c_str());
+    if (bind(fd, (sockaddr*) &address, sizeof(address)) < 0 || listen(fd, 128) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Listens on a TCP port of the loopback interface only.
+ * @param port The port.
+ * @return The listening socket, or -1 on error.
+ */
+int Protocol::listenTcp(int port) {
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons((uint16_t) port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (bind(fd, (sockaddr*) &address, sizeof(address)) < 0 || listen(fd, 128) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Connects to a server listening on a Unix domain socket.
+ * @param path Path of the socket file.
+ * @return The connected socket, or -1 on error.
+ */
+int Protocol::connectUnix(const std::string& path) {
+    sockaddr_un address = {};
+    if (path.size() >= sizeof(address.sun_path)) return -1;
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (sockaddr*) &address, sizeof(address)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Connects to a server listening on a loopback TCP port.
+ * @param port The port.
+ * @return The connected socket, or -1 on error.
+ */
+int Protocol::connectTcp(int port) {
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons((uint16_t) port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (sockaddr*) &address, sizeof(address)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+Protocol::Deadline Protocol::deadlineAfter(int timeoutMs) {
+    return timeoutMs < 0 ? Deadline::max() : std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+}
+
+// Waits until the socket is ready for events; false once the deadline passes first (never, for Deadline::max())
+bool Protocol::waitUntil(int fd, short events, Deadline deadline) {
+    if (deadline == Deadline::max()) return true;
+    while (true) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) return false;
+        pollfd polled = {fd, events, 0};
+        int ready = poll(&polled, 1, (int) remaining.count());
+        if (ready < 0 && errno == EINTR) continue;
+        return ready > 0;
+    }
+}
+
+bool Protocol::readFully(int fd, char* data, size_t size, Deadline deadline) {
+    while (size > 0) {
+        if (!waitUntil(fd, POLLIN, deadline)) return false;
+        ssize_t n = recv(fd, data, size, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+bool Protocol::writeFully(int fd, const char* data, size_t size, Deadline deadline) {
+    while (size > 0) {
+        if (!waitUntil(fd, POLLOUT, deadline)) return false;
+        ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        size -= n;
+    }
+    return true;
+}
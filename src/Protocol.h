@@ -0,0 +1,35 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Framing and sockets shared by the query server and its client.
+ *
+ * Every request and every response is one frame: a 4-byte big-endian payload length followed
+ * by that many bytes of JSON. Requests are BatchRunner query objects, responses its answers.
+ */
+class Protocol {
+public:
+    static const uint32_t MaxFrameBytes = 16 * 1024 * 1024;
+
+    static bool readFrame(int fd, std::string& payload, int timeoutMs = -1);
+    static bool writeFrame(int fd, const std::string& payload, int timeoutMs = -1);
+
+    static int listenUnix(const std::string& path);
+    static int listenTcp(int port);
+    static int connectUnix(const std::string& path);
+    static int connectTcp(int port);
+
+private:
+    using Deadline = std::chrono::steady_clock::time_point;
+
+    static Deadline deadlineAfter(int timeoutMs);
+    static bool waitUntil(int fd, short events, Deadline deadline);
+    static bool readFully(int fd, char* data, size_t size, Deadline deadline);
+    static bool writeFully(int fd, const char* data, size_t size, Deadline deadline);
+};
+
+#endif // PROTOCOL_H
@@ -0,0 +1,370 @@
+#include "QueryEngine.h"
+#include "Haversine.h"
+#include "Aggregation.h"
+#include "StringPool.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Kilometres per radian of latitude, the lower bound Haversine::haversineDistance gives for a latitude difference
+constexpr double KM_PER_RADIAN = 6371.0;
+
+/**
+ * @brief Builds every index of a loaded graph: the condensation, the live ranking of the metrics read
+ *        from the graph's counters, the flight table, the GeoIndex, the CSR arrays, the latitude list
+ *        and the autocomplete index. The timetable starts empty.
+ * @param graph Reference to the graph of airports, with its flights.
+ * @param airlines Set of airlines.
+ * @note Time complexity: O(V * N / 64 + F + E log E) where V is the number of airports, N the number of
+ *       countries, F the number of flights and E the number of routes.
+ */
+QueryEngine::QueryEngine(Graph<Airport>& graph, std::unordered_set<Airline>& airlines)
+        : graph(graph), airlines(airlines), condensation(graph), ranking(graph), flightTable(graph),
+          geoIndex(graph, flightTable), denseGraph(graph), timetable(graph) {
+    for (auto metric : {RankingMetric::OutgoingFlights, RankingMetric::IncomingFlights,
+                        RankingMetric::DistinctRoutes, RankingMetric::DistinctAirlines}) {
+        ranking.track(metric);
+    }
+    byLatitude.reserve(graph.getNumVertex());
+    for (const auto* vertex : graph.getVertexSet()) {
+        byLatitude.push_back({vertex->getInfo().getLatitude(), vertex->getInfo().getLongitude(), vertex});
+    }
+    std::sort(byLatitude.begin(), byLatitude.end(), [](const Located& a, const Located& b) {
+        return a.latitude < b.latitude;
+    });
+    buildAutocomplete();
+}
+
+Graph<Airport>& QueryEngine::getGraph() {
+    return graph;
+}
+
+const Graph<Airport>& QueryEngine::getGraph() const {
+    return graph;
+}
+
+std::unordered_set<Airline>& QueryEngine::getAirlines() {
+    return airlines;
+}
+
+const std::unordered_set<Airline>& QueryEngine::getAirlines() const {
+    return airlines;
+}
+
+const Condensation& QueryEngine::getCondensation() const {
+    return condensation;
+}
+
+const Ranking& QueryEngine::getRanking() const {
+    return ranking;
+}
+
+const FlightTable& QueryEngine::getFlightTable() const {
+    return flightTable;
+}
+
+const GeoIndex& QueryEngine::getGeoIndex() const {
+    return geoIndex;
+}
+
+/**
+ * @brief Gets the CSR arrays, rebuilding them first if routes changed since they were built.
+ * @return The CSR view of the graph.
+ * @note Time complexity: O(1), or O(V + E) for the rebuild.
+ */
+const DenseGraph& QueryEngine::getDenseGraph() const {
+    std::lock_guard<std::mutex> lock(rebuildLock);
+    return currentDenseGraph();
+}
+
+/**
+ * @brief Gets the contraction hierarchy, building it first if there is none or routes changed since it was built.
+ * @return The hierarchy. It stays valid until the next flight delta that adds or removes a route.
+ * @note Time complexity: O(1), or that of contracting the graph (see ContractionHierarchy) for the build.
+ */
+const ContractionHierarchy& QueryEngine::getHierarchy() const {
+    std::lock_guard<std::mutex> lock(rebuildLock);
+    if (hierarchyStale || hierarchy.getNumVertices() != graph.getNumVertex()) {
+        hierarchy = ContractionHierarchy(currentDenseGraph());
+        hierarchyStale = false;
+    }
+    return hierarchy;
+}
+
+/**
+ * @brief Reads the contraction hierarchy from a file written by ContractionHierarchy::save().
+ * @param filename The file.
+ * @return False if it could not be read or was built for other airports or routes; the hierarchy is then built
+ *         by buildRouteIndexes() or on first use.
+ * @note Time complexity: O(V + E + A) where A is the number of arcs of the hierarchy.
+ */
+bool QueryEngine::loadHierarchy(const std::string& filename) {
+    std::lock_guard<std::mutex> lock(rebuildLock);
+    if (!hierarchy.load(currentDenseGraph(), filename)) return false;
+    hierarchyStale = false;
+    return true;
+}
+
+/**
+ * @brief Gets the hop labels, building them first if there are none or routes changed since they were built.
+ * @return The labels. They stay valid until the next flight delta that adds or removes a route.
+ * @note Time complexity: O(1), or that of labelling the graph (see HopLabels) for the build.
+ */
+const HopLabels& QueryEngine::getHopLabels() const {
+    std::lock_guard<std::mutex> lock(rebuildLock);
+    if (hopLabelsStale || hopLabels.getNumVertices() != graph.getNumVertex()) {
+        hopLabels = HopLabels(currentDenseGraph());
+        hopLabelsStale = false;
+    }
+    return hopLabels;
+}
+
+/**
+ * @brief Builds the contraction hierarchy, unless loadHierarchy() read it, and the hop labels, so that the first
+ *        shortest route and best flight queries do not wait for them.
+ * @note Time complexity: that of contracting and labelling the graph (see ContractionHierarchy and HopLabels).
+ */
+void QueryEngine::buildRouteIndexes() {
+    getHierarchy();
+    getHopLabels();
+}
+
+const Autocomplete& QueryEngine::getAutocomplete() const {
+    return autocomplete;
+}
+
+Timetable& QueryEngine::getTimetable() {
+    return timetable;
+}
+
+const Timetable& QueryEngine::getTimetable() const {
+    return timetable;
+}
+
+/**
+ * @brief Finds an airport by its code.
+ * @param code The airport code.
+ * @return Its vertex, or nullptr if there is no such airport.
+ * @note Time complexity: O(1) on average.
+ */
+const Vertex<Airport>* QueryEngine::findAirport(const std::string& code) const {
+    return graph.findVertex(Airport(code));
+}
+
+/**
+ * @brief Finds the airports of a city.
+ * @param city The city name.
+ * @return Their vertices, in vertex id order; empty if no airport is in that city.
+ * @note Time complexity: O(L + A) where L is the length of the name and A the number of airports found.
+ */
+std::vector<const Vertex<Airport>*> QueryEngine::findAirportsInCity(const std::string& city) const {
+    std::vector<const Vertex<Airport>*> airports;
+    int cityId = flightTable.cities.find(city);
+    if (cityId < 0) return airports;
+    for (int airport : geoIndex.getAirportsInCity(cityId)) {
+        airports.push_back(graph.getVertexSet()[airport]);
+    }
+    return airports;
+}
+
+/**
+ * @brief Finds the airport nearest to some coordinates, walking the latitude list outwards from
+ *        the given latitude until the latitude difference alone is farther than the best airport.
+ * @param lat Latitude.
+ * @param lon Longitude.
+ * @return The nearest airport's vertex, or nullptr if there are no airports.
+ * @note Time complexity: O(log V + K) where K is the number of airports within the band of
+ *       latitudes as close as the nearest one; O(V) in the worst case.
+ */
+const Vertex<Airport>* QueryEngine::findNearestAirport(double lat, double lon) const {
+    const Vertex<Airport>* nearest = nullptr;
+    double minDistance = std::numeric_limits<double>::max();
+    auto within = [&](const Located& airport) {
+        return KM_PER_RADIAN * std::abs(airport.latitude - lat) * M_PI / 180.0 < minDistance;
+    };
+    auto visit = [&](const Located& airport) {
+        double distance = Haversine::haversineDistance(lat, lon, airport.latitude, airport.longitude);
+        if (distance < minDistance) {
+            minDistance = distance;
+            nearest = airport.vertex;
+        }
+    };
+
+    auto split = std::lower_bound(byLatitude.begin(), byLatitude.end(), lat, [](const Located& airport, double latitude) {
+        return airport.latitude < latitude;
+    });
+    auto up = split, down = split;
+    while (up != byLatitude.end() || down != byLatitude.begin()) {
+        if (up != byLatitude.end()) {
+            if (within(*up)) visit(*up++);
+            else up = byLatitude.end();
+        }
+        if (down != byLatitude.begin()) {
+            if (within(*(down - 1))) visit(*--down);
+            else down = byLatitude.begin();
+        }
+    }
+    return nearest;
+}
+
+/**
+ * @brief Updates the indexes after a flight was added to the graph.
+ * @param source Source vertex of the flight.
+ * @param destination Destination vertex of the flight.
+ * @param flight The flight.
+ * @param newRoute Whether the flight created the route between the two airports.
+ * @note Time complexity: O(D + N / 64 + M log V) where D is the number of routes of the two airports, N the number
+ *       of countries and M the number of tracked ranking metrics. A new route makes the next centrality, PageRank or
+ *       reach sketch query rebuild the CSR arrays first, the next shortest route query the contraction hierarchy
+ *       and the next best flight query the hop labels (or buildRouteIndexes() all three), and may leave the
+ *       condensation to refreshCondensation().
+ */
+void QueryEngine::onFlightAdded(const Vertex<Airport>* source, const Vertex<Airport>* destination, const Flight& flight, bool newRoute) {
+    ranking.onFlightAdded(source->getInfo(), destination->getInfo());
+    flightTable.addFlight(source, destination, flight.getAirline());
+    if (newRoute) {
+        if (!condensationStale) condensationStale = !condensation.addRoute(source, destination);
+        geoIndex.updateAirport(source, flightTable);
+        denseGraphStale = true;
+        hierarchyStale = true;
+        hopLabelsStale = true;
+    } else {
+        updateRouteWeight(source, destination);
+    }
+}
+
+/**
+ * @brief Updates the indexes after a flight was removed from the graph.
+ * @param source Source vertex of the flight.
+ * @param destination Destination vertex of the flight.
+ * @param flight The flight.
+ * @param routeRemoved Whether it was the last flight of its route, so the route was removed too.
+ * @note Time complexity: as onFlightAdded(), plus indexing the flight table on the first removal.
+ *       The condensation is left as it is: a removed route can only make it report paths that no
+ *       longer exist, which searches then fail to find.
+ */
+void QueryEngine::onFlightRemoved(const Vertex<Airport>* source, const Vertex<Airport>* destination, const Flight& flight, bool routeRemoved) {
+    ranking.onFlightRemoved(source->getInfo(), destination->getInfo());
+    flightTable.removeFlight(source, destination, flight.getAirline());
+    if (routeRemoved) {
+        geoIndex.updateAirport(source, flightTable);
+        denseGraphStale = true;
+        hierarchyStale = true;
+        hopLabelsStale = true;
+    } else {
+        updateRouteWeight(source, destination);
+    }
+}
+
+/**
+ * @brief Rebuilds the condensation if a route added since the last call could not be patched into it.
+ * @return True if it was rebuilt.
+ * @note Time complexity: O(1), or O(V + E log E) for the rebuild.
+ */
+bool QueryEngine::refreshCondensation() {
+    if (!condensationStale) return false;
+    condensation = Condensation(graph);
+    condensationStale = false;
+    return true;
+}
+
+/**
+ * @brief Reports the bytes held by the graph, the strings, the airlines and every index. The graph's vertices,
+ *        edge lists, incoming lists, flight sets and airline counters are counted by its arena, as is the part
+ *        of the arena's chunks not handed out; the rest is estimated by walking the containers (see MemoryReport).
+ * @return The report.
+ * @note Time complexity: O(V + F + S) where S is the number of strings held by the indexes.
+ */
+MemoryReport QueryEngine::memoryReport() const {
+    MemoryReport report;
+    const Arena& arena = graph.getArena();
+    long airlineCounts = 0;
+    size_t routes = 0, stringHeap = 0;
+    for (const auto* vertex : graph.getVertexSet()) {
+        airlineCounts += vertex->getNumAirlines();
+        routes += vertex->getAdj().size();
+        for (const auto& edge : vertex->getAdj()) {
+            for (const auto& flight : edge.getFlights()) stringHeap += flight.getHeapBytes();
+        }
+    }
+    auto account = [&](GraphMemory memory) { return arena.getBytesInUse((int) memory); };
+    report.add("graph.vertices", account(GraphMemory::Vertices), graph.getNumVertex(), true);
+    report.add("graph.edges", account(GraphMemory::Edges), routes, true);
+    report.add("graph.incoming", account(GraphMemory::Incoming), routes, true);
+    report.add("graph.flights", account(GraphMemory::Flights), graph.getNumFlights(), true);
+    report.add("graph.airline_counts", account(GraphMemory::AirlineCounts), airlineCounts, true);
+    report.add("graph.arena_unused", arena.getBytesReserved() - arena.getBytesInUse(), arena.getNumChunks(), true);
+    report.add("graph.index", graph.getIndexBytes(), graph.getNumVertex());
+    report.add("graph.string_heap", stringHeap, graph.getNumFlights());
+    report.add("strings.pool", StringPool::global().getBytes(), StringPool::global().size(), true);
+
+    size_t airlineBytes = MemoryReport::hashTableBytes(airlines);
+    for (const auto& airline : airlines) airlineBytes += airline.getHeapBytes();
+    report.add("airlines", airlineBytes, airlines.size());
+
+    report.add("engine.condensation", condensation.getBytes(), condensation.getNumComponents());
+    report.add("engine.ranking", ranking.getBytes(), graph.getNumVertex());
+    report.add("engine.flight_table", flightTable.getBytes(), flightTable.size());
+    report.add("engine.geo_index", geoIndex.getBytes(), flightTable.cities.size() + flightTable.countries.size());
+    // A query on another thread may be rebuilding the CSR arrays, the hierarchy or the labels
+    std::lock_guard<std::mutex> lock(rebuildLock);
+    report.add("engine.dense_graph", denseGraph.getBytes(), denseGraph.getNumEdges());
+    report.add("engine.latitude_list", MemoryReport::bytesOf(byLatitude), byLatitude.size());
+    report.add("engine.autocomplete", autocomplete.getBytes(), autocomplete.size());
+    report.add("engine.timetable", timetable.getBytes(), timetable.size());
+    report.add("engine.contraction_hierarchy", hierarchy.getBytes(), hierarchy.getNumArcs());
+    report.add("engine.hop_labels", hopLabels.getBytes(), hopLabels.getNumEntries());
+    return report;
+}
+
+/**
+ * @brief Indexes the names of the airports (with their codes), cities, countries and airlines (with their codes),
+ *        weighted by their flights in and out; an airline's are the flights it operates.
+ * @note Time complexity: O(V + F + A + T log T) where A is the number of airlines and T the number of words of all names.
+ */
+void QueryEngine::buildAutocomplete() {
+    std::vector<long> cityFlights(flightTable.cities.size(), 0), countryFlights(flightTable.countries.size(), 0);
+    for (const auto* vertex : graph.getVertexSet()) {
+        const Airport& airport = vertex->getInfo();
+        long flights = vertex->getOutFlights() + vertex->getInFlights();
+        autocomplete.add(Autocomplete::Kind::Airport, airport.getName(), airport.getCode(), flights);
+        cityFlights[flightTable.airportCity[vertex->getId()]] += flights;
+        countryFlights[flightTable.airportCountry[vertex->getId()]] += flights;
+    }
+    for (int city = 0; city < flightTable.cities.size(); city++) {
+        autocomplete.add(Autocomplete::Kind::City, flightTable.cities.get(city), "", cityFlights[city]);
+    }
+    for (int country = 0; country < flightTable.countries.size(); country++) {
+        autocomplete.add(Autocomplete::Kind::Country, flightTable.countries.get(country), "", countryFlights[country]);
+    }
+    std::vector<long> airlineFlights = Aggregation::countBy(flightTable.airline, flightTable.airlines.size());
+    for (const auto& airline : airlines) {
+        int id = flightTable.airlines.find(airline.getCode());
+        autocomplete.add(Autocomplete::Kind::Airline, airline.getName(), airline.getCode(), id < 0 ? 0 : airlineFlights[id]);
+    }
+    autocomplete.build();
+}
+
+/**
+ * @brief Gets the CSR arrays, rebuilding them first if routes changed since they were built; rebuildLock must be held.
+ * @return The CSR view of the graph.
+ */
+const DenseGraph& QueryEngine::currentDenseGraph() const {
+    if (denseGraphStale) {
+        denseGraph = DenseGraph(graph);
+        denseGraphStale = false;
+    }
+    return denseGraph;
+}
+
+/**
+ * @brief Copies the number of flights of a route into its CSR weight, unless the CSR arrays will be rebuilt anyway.
+ */
+void QueryEngine::updateRouteWeight(const Vertex<Airport>* source, const Vertex<Airport>* destination) {
+    if (denseGraphStale) return;
+    for (const auto& edge : source->getAdj()) {
+        if (edge.getDest() == destination) {
+            denseGraph.setWeight(source->getId(), destination->getId(), edge.getFlights().size());
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef QUERYENGINE_H
+#define QUERYENGINE_H
+
+#include "Graph.h"
+#include "Airport.h"
+#include "Airline.h"
+#include "Flight.h"
+#include "Condensation.h"
+#include "Ranking.h"
+#include "FlightTable.h"
+#include "GeoIndex.h"
+#include "DenseGraph.h"
+#include "Autocomplete.h"
+#include "MemoryReport.h"
+#include "Timetable.h"
+#include "ContractionHierarchy.h"
+#include "HopLabels.h"
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @brief Every lookup index of a loaded dataset, built once and shared by the Search and
+ *        Statistics views over it, which therefore cost nothing to construct.
+ *
+ * Airports are found by code through the graph's own index, by city and country through the
+ * flight table's dictionaries and the GeoIndex, by position through a list sorted by latitude,
+ * and by partial or misspelt names through the autocomplete index; airlines through the flight
+ * table's dictionary. The condensation, the live ranking and the CSR arrays complete it.
+ * FlightDelta keeps all of them in sync with the graph; other changes to the graph's airports
+ * require a new engine. The timetable starts empty and is filled by whoever loads one; it is
+ * a schedule of its own, which flight deltas do not touch. The contraction hierarchy is read from
+ * a file by loadHierarchy(), and buildRouteIndexes() builds it (unless it was read) and the hop
+ * labels up front; whichever is missing or outdated after a delta that adds or removes a route
+ * is rebuilt by the next query that needs it. One lock guards these rebuilds and the CSR arrays
+ * they start from.
+ */
+class QueryEngine {
+public:
+    QueryEngine(Graph<Airport>& graph, std::unordered_set<Airline>& airlines);
+    QueryEngine(const QueryEngine&) = delete;
+    QueryEngine& operator=(const QueryEngine&) = delete;
+
+    Graph<Airport>& getGraph();
+    const Graph<Airport>& getGraph() const;
+    std::unordered_set<Airline>& getAirlines();
+    const std::unordered_set<Airline>& getAirlines() const;
+    const Condensation& getCondensation() const;
+    const Ranking& getRanking() const;
+    const FlightTable& getFlightTable() const;
+    const GeoIndex& getGeoIndex() const;
+    const DenseGraph& getDenseGraph() const;
+    const Autocomplete& getAutocomplete() const;
+    Timetable& getTimetable();
+    const Timetable& getTimetable() const;
+    const ContractionHierarchy& getHierarchy() const;
+    bool loadHierarchy(const std::string& filename);
+    const HopLabels& getHopLabels() const;
+    void buildRouteIndexes();
+
+    const Vertex<Airport>* findAirport(const std::string& code) const;
+    std::vector<const Vertex<Airport>*> findAirportsInCity(const std::string& city) const;
+    const Vertex<Airport>* findNearestAirport(double lat, double lon) const;
+
+    void onFlightAdded(const Vertex<Airport>* source, const Vertex<Airport>* destination, const Flight& flight, bool newRoute);
+    void onFlightRemoved(const Vertex<Airport>* source, const Vertex<Airport>* destination, const Flight& flight, bool routeRemoved);
+    bool refreshCondensation();
+
+    MemoryReport memoryReport() const;
+
+private:
+    struct Located {
+        double latitude;
+        double longitude;
+        const Vertex<Airport>* vertex;
+    };
+
+    Graph<Airport>& graph;
+    std::unordered_set<Airline>& airlines;
+    Condensation condensation;
+    bool condensationStale = false;        // a new route could not be patched into the condensation
+    Ranking ranking;
+    FlightTable flightTable;
+    GeoIndex geoIndex;
+    mutable DenseGraph denseGraph;
+    mutable bool denseGraphStale = false;  // routes were added or removed since denseGraph was built
+    std::vector<Located> byLatitude;       // every airport, sorted by latitude
+    Autocomplete autocomplete;             // weighted by the flights at load time
+    Timetable timetable;
+    mutable ContractionHierarchy hierarchy;
+    mutable bool hierarchyStale = false;   // routes were added or removed since the hierarchy was built
+    mutable HopLabels hopLabels;
+    mutable bool hopLabelsStale = false;   // routes were added or removed since the labels were built
+    mutable std::mutex rebuildLock;        // queries on several threads may rebuild denseGraph, hierarchy or hopLabels
+
+    void buildAutocomplete();
+    const DenseGraph& currentDenseGraph() const;
+    void updateRouteWeight(const Vertex<Airport>* source, const Vertex<Airport>* destination);
+};
+
+#endif // QUERYENGINE_H
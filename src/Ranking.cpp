@@ -0,0 +1,253 @@
+#include "Ranking.h"
+#include "Parallel.h"
+#include "MemoryReport.h"
+#include <algorithm>
+
+/**
+ * @brief Constructs a ranking over the airports of a graph, with no metric tracked live yet.
+ * @param graph Reference to the graph of airports.
+ */
+Ranking::Ranking(const Graph<Airport>& graph) : graph(graph) {}
+
+/**
+ * @brief Gets a human readable name for a metric.
+ * @param metric The metric.
+ * @return The name.
+ */
+std::string Ranking::getName(RankingMetric metric) {
+    switch (metric) {
+        case RankingMetric::OutgoingFlights: return "Outgoing flights";
+        case RankingMetric::IncomingFlights: return "Incoming flights";
+        case RankingMetric::DistinctRoutes: return "Distinct routes";
+        case RankingMetric::DistinctAirlines: return "Distinct airlines";
+        case RankingMetric::ReachWithinStops: return "Airports reachable";
+    }
+    return "";
+}
+
+/**
+ * @brief Checks whether a metric is read from the graph's counters and can be tracked live.
+ * @param metric The metric.
+ * @return True for every metric except the reach, which needs a search per airport.
+ */
+bool Ranking::isLive(RankingMetric metric) {
+    return metric != RankingMetric::ReachWithinStops;
+}
+
+/**
+ * @brief Scores an airport for a counter metric.
+ * @param vertex The airport's vertex.
+ * @param metric The metric (must be a live metric).
+ * @return The score.
+ * @note Time complexity: O(1)
+ */
+long Ranking::score(const Vertex<Airport>* vertex, RankingMetric metric) {
+    switch (metric) {
+        case RankingMetric::OutgoingFlights: return vertex->getOutFlights();
+        case RankingMetric::IncomingFlights: return vertex->getInFlights();
+        case RankingMetric::DistinctRoutes: return vertex->getAdj().size();
+        case RankingMetric::DistinctAirlines: return vertex->getNumAirlines();
+        default: return 0;
+    }
+}
+
+/**
+ * @brief Orders entries by decreasing score, breaking ties by airport code.
+ */
+bool Ranking::Entry::operator<(const Entry& other) const {
+    if (score != other.score) return score > other.score;
+    return vertex->getInfo().getCodeKey() < other.vertex->getInfo().getCodeKey();
+}
+
+/**
+ * @brief Finds the top-k airports for a metric by scoring every airport.
+ * @param metric The metric.
+ * @param k The number of airports (clamped to [0, number of airports]).
+ * @param maxStops Maximum number of stops, only used by the reach metric.
+ * @return The top-k airports with their scores, best first.
+ * @note Time complexity: O(V + k log k) for counter metrics, O(V * (V + E) / T) for the reach with T threads.
+ */
+std::vector<std::pair<Airport, long>> Ranking::topK(RankingMetric metric, int k, int maxStops) const {
+    const auto& vertices = graph.getVertexSet();
+    std::vector<Entry> entries;
+    entries.reserve(vertices.size());
+
+    if (metric == RankingMetric::ReachWithinStops) {
+        std::vector<long> scores = reachScores(maxStops);
+        for (const auto* vertex : vertices) entries.push_back({scores[vertex->getId()], vertex});
+    } else {
+        for (const auto* vertex : vertices) entries.push_back({score(vertex, metric), vertex});
+    }
+
+    size_t count = std::min<size_t>(std::max(k, 0), entries.size());
+    std::nth_element(entries.begin(), entries.begin() + count, entries.end());
+    std::sort(entries.begin(), entries.begin() + count);
+
+    std::vector<std::pair<Airport, long>> top;
+    for (size_t i = 0; i < count; i++) {
+        top.emplace_back(entries[i].vertex->getInfo(), entries[i].score);
+    }
+    return top;
+}
+
+/**
+ * @brief Counts, for every airport, the airports reachable within a number of stops (itself included).
+ * @param maxStops Maximum number of stops, with the same meaning as in Statistics::getReachableAirports().
+ * @return A vector indexed by vertex id with the number of reachable airports.
+ * @note Time complexity: O(V * (V + E) / T) where T is the number of threads.
+ */
+std::vector<long> Ranking::reachScores(int maxStops) const {
+    const auto& vertices = graph.getVertexSet();
+    std::vector<long> scores(vertices.size(), 0);
+
+    Parallel::forRange(vertices.size(), 0, [&](size_t begin, size_t end, int) {
+        std::vector<int> seen(vertices.size(), -1);  // source that last reached each vertex
+        std::vector<std::pair<const Vertex<Airport>*, int>> queue;
+        for (size_t s = begin; s < end; s++) {
+            queue.clear();
+            queue.push_back({vertices[s], 0});
+            seen[s] = s;
+            for (size_t head = 0; head < queue.size(); head++) {
+                const Vertex<Airport>* v = queue[head].first;
+                int stops = queue[head].second;
+                if (stops >= maxStops) continue;
+                for (const auto& edge : v->getAdj()) {
+                    int w = edge.getDest()->getId();
+                    if (seen[w] != (int) s) {
+                        seen[w] = s;
+                        queue.push_back({edge.getDest(), stops + 1});
+                    }
+                }
+            }
+            scores[s] = queue.size();
+        }
+    });
+    return scores;
+}
+
+/**
+ * @brief Starts tracking a counter metric live, scoring every airport once.
+ * @param metric The metric (the reach cannot be tracked live and is ignored).
+ * @note Time complexity: O(V log V)
+ */
+void Ranking::track(RankingMetric metric) {
+    if (!isLive(metric)) return;
+    LiveTopK& ranking = live[(int) metric];
+    ranking.ordered.clear();
+    ranking.scores.clear();
+    for (const auto* vertex : graph.getVertexSet()) {
+        updateEntry(ranking, vertex, score(vertex, metric));
+    }
+}
+
+/**
+ * @brief Checks whether a metric is tracked live.
+ * @param metric The metric.
+ * @return True if track() was called for it.
+ */
+bool Ranking::isTracked(RankingMetric metric) const {
+    return live.count((int) metric) > 0;
+}
+
+/**
+ * @brief Re-scores an airport in every live metric, e.g. after its flights changed.
+ * @param airport The airport.
+ * @note Time complexity: O(M log V) where M is the number of tracked metrics.
+ */
+void Ranking::update(const Airport& airport) {
+    const Vertex<Airport>* vertex = graph.findVertex(airport);
+    if (!vertex) return;
+    for (auto& entry : live) {
+        updateEntry(entry.second, vertex, score(vertex, (RankingMetric) entry.first));
+    }
+}
+
+/**
+ * @brief Removes an airport from every live metric; must be called before the airport is removed from the graph.
+ * @param airport The airport.
+ * @note Time complexity: O(M log V) where M is the number of tracked metrics.
+ */
+void Ranking::forget(const Airport& airport) {
+    const Vertex<Airport>* vertex = graph.findVertex(airport);
+    if (!vertex) return;
+    for (auto& entry : live) {
+        auto it = entry.second.scores.find(vertex);
+        if (it != entry.second.scores.end()) {
+            entry.second.ordered.erase({it->second, vertex});
+            entry.second.scores.erase(it);
+        }
+    }
+}
+
+/**
+ * @brief Updates the live metrics after a flight was added to the graph.
+ * @param source Source airport of the flight.
+ * @param destination Destination airport of the flight.
+ * @note Time complexity: O(M log V) where M is the number of tracked metrics.
+ */
+void Ranking::onFlightAdded(const Airport& source, const Airport& destination) {
+    update(source);
+    update(destination);
+}
+
+/**
+ * @brief Updates the live metrics after a flight was removed from the graph.
+ * @param source Source airport of the flight.
+ * @param destination Destination airport of the flight.
+ * @note Time complexity: O(M log V) where M is the number of tracked metrics.
+ */
+void Ranking::onFlightRemoved(const Airport& source, const Airport& destination) {
+    update(source);
+    update(destination);
+}
+
+/**
+ * @brief Reads the top-k airports of a live metric.
+ * @param metric The metric, which must be tracked (otherwise the result is empty).
+ * @param k The number of airports.
+ * @return The top-k airports with their scores, best first.
+ * @note Time complexity: O(k)
+ */
+std::vector<std::pair<Airport, long>> Ranking::liveTopK(RankingMetric metric, int k) const {
+    std::vector<std::pair<Airport, long>> top;
+    auto it = live.find((int) metric);
+    if (it == live.end()) return top;
+
+    for (const auto& entry : it->second.ordered) {
+        if ((int) top.size() >= k) break;
+        top.emplace_back(entry.vertex->getInfo(), entry.score);
+    }
+    return top;
+}
+
+/**
+ * @brief Estimates the heap bytes of the live rankings: the ordered entries and the score of every airport.
+ * @return The number of bytes.
+ * @note Time complexity: O(M) where M is the number of tracked metrics.
+ */
+size_t Ranking::getBytes() const {
+    size_t bytes = MemoryReport::hashTableBytes(live);
+    for (const auto& pair : live) {
+        bytes += MemoryReport::treeBytes(pair.second.ordered) + MemoryReport::hashTableBytes(pair.second.scores);
+    }
+    return bytes;
+}
+
+/**
+ * @brief Sets the score of an airport in a live ranking, moving it to its new position.
+ * @param ranking The live ranking.
+ * @param vertex The airport's vertex.
+ * @param score The new score.
+ * @note Time complexity: O(log V)
+ */
+void Ranking::updateEntry(LiveTopK& ranking, const Vertex<Airport>* vertex, long score) {
+    auto it = ranking.scores.find(vertex);
+    if (it != ranking.scores.end()) {
+        if (it->second == score) return;
+        ranking.ordered.erase({it->second, vertex});
+        it->second = score;
+    } else {
+        ranking.scores.emplace(vertex, score);
+    }
+    ranking.ordered.insert({score, vertex});
+}
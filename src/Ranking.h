@@ -0,0 +1,65 @@
+#ifndef RANKING_H
+#define RANKING_H
+
+#include "Graph.h"
+#include "Airport.h"
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <string>
+
+enum class RankingMetric {
+    OutgoingFlights,
+    IncomingFlights,
+    DistinctRoutes,
+    DistinctAirlines,
+    ReachWithinStops
+};
+
+/**
+ * @brief Ranks airports by several metrics.
+ *
+ * One-off queries score every airport and select the top k with nth_element. Metrics read from
+ * the graph's counters can also be tracked live: the ranking keeps them ordered and is updated
+ * as flights are ingested, so reading the top k does not look at the other airports.
+ */
+class Ranking {
+public:
+    explicit Ranking(const Graph<Airport>& graph);
+
+    static std::string getName(RankingMetric metric);
+    static bool isLive(RankingMetric metric);
+    static long score(const Vertex<Airport>* vertex, RankingMetric metric);
+
+    std::vector<std::pair<Airport, long>> topK(RankingMetric metric, int k, int maxStops = 1) const;
+
+    void track(RankingMetric metric);
+    bool isTracked(RankingMetric metric) const;
+    void update(const Airport& airport);
+    void forget(const Airport& airport);
+    void onFlightAdded(const Airport& source, const Airport& destination);
+    void onFlightRemoved(const Airport& source, const Airport& destination);
+    std::vector<std::pair<Airport, long>> liveTopK(RankingMetric metric, int k) const;
+
+    size_t getBytes() const;
+
+private:
+    struct Entry {
+        long score;
+        const Vertex<Airport>* vertex;
+        bool operator<(const Entry& other) const;  // highest score first, ties by airport code
+    };
+
+    struct LiveTopK {
+        std::set<Entry> ordered;
+        std::unordered_map<const Vertex<Airport>*, long> scores;
+    };
+
+    const Graph<Airport>& graph;
+    std::unordered_map<int, LiveTopK> live;  // by metric
+
+    std::vector<long> reachScores(int maxStops) const;
+    static void updateEntry(LiveTopK& ranking, const Vertex<Airport>* vertex, long score);
+};
+
+#endif // RANKING_H
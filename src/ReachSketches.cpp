@@ -0,0 +1,129 @@
+#include "ReachSketches.h"
+#include "Parallel.h"
+#include <atomic>
+#include <cmath>
+#include <algorithm>
+
+/**
+ * @brief Builds the sketches of every airport by propagating them along the routes for maxStops rounds, or fewer
+ *        once the registers stop changing.
+ * @param graph CSR view of the airport graph.
+ * @param table Flight table built from the same graph, for the city and country of each airport.
+ * @param maxStops Number of rounds, with the same meaning as in Statistics::getReachableAirports().
+ * @param precision Number of register index bits (4 to 16); the standard error is about 1.04 / sqrt(2^precision).
+ * @param threads Number of threads (values below 1 use all hardware threads).
+ * @note Time complexity: O(k * (V + E) * m / T) for k = min(maxStops, V - 1) rounds at most, m registers and T threads.
+ *       Memory: 3 * V * m bytes for the sketches, plus V * m while building.
+ */
+ReachSketches::ReachSketches(const DenseGraph& graph, const FlightTable& table, int maxStops, int precision, int threads)
+        : precision(std::max(4, std::min(16, precision))), maxStops(maxStops) {
+    registers = 1 << this->precision;
+    int n = graph.getNumVertices();
+
+    for (int kind = 0; kind < 3; kind++) {
+        std::vector<uint8_t>& current = sketches[kind];
+        current.assign((size_t) n * registers, 0);
+        for (int v = 0; v < n; v++) {
+            uint64_t item = kind == Airports ? v : kind == Cities ? table.airportCity[v] : table.airportCountry[v];
+            add(current, v, item * 3 + kind);
+        }
+
+        // Every airport is reached within n - 1 rounds, and a round that changes no register leaves the
+        // next ones nothing to change either, so large stop counts stop early
+        std::vector<uint8_t> next(current.size());
+        std::atomic<bool> changed(true);
+        for (int round = 0; round < std::min(maxStops, n - 1) && changed.load(); round++) {
+            changed.store(false);
+            Parallel::forRange(n, threads, [&](size_t begin, size_t end, int) {
+                bool grew = false;
+                for (size_t v = begin; v < end; v++) {
+                    uint8_t* out = &next[v * registers];
+                    std::copy(&current[v * registers], &current[v * registers] + registers, out);
+                    for (int i = graph.offsets[v]; i < graph.offsets[v + 1]; i++) {
+                        const uint8_t* in = &current[(size_t) graph.targets[i] * registers];
+                        for (int r = 0; r < registers; r++) {
+                            if (in[r] > out[r]) {
+                                out[r] = in[r];
+                                grew = true;
+                            }
+                        }
+                    }
+                }
+                if (grew) changed.store(true);
+            });
+            current.swap(next);
+        }
+    }
+}
+
+/**
+ * @brief Estimates how many distinct airports, cities or countries an airport reaches within maxStops.
+ * @param airport Airport (vertex) id.
+ * @param kind What to count.
+ * @return The estimated count (the airport itself, its city and its country are included).
+ * @note Time complexity: O(m) where m is the number of registers.
+ */
+double ReachSketches::estimate(int airport, Kind kind) const {
+    const uint8_t* sketch = &sketches[kind][(size_t) airport * registers];
+    double sum = 0;
+    int zeros = 0;
+    for (int r = 0; r < registers; r++) {
+        sum += std::ldexp(1.0, -sketch[r]);
+        if (sketch[r] == 0) zeros++;
+    }
+
+    double m = registers;
+    double alpha = registers == 16 ? 0.673 : registers == 32 ? 0.697 : registers == 64 ? 0.709 : 0.7213 / (1 + 1.079 / m);
+    double raw = alpha * m * m / sum;
+    if (raw <= 2.5 * m && zeros > 0) {
+        return m * std::log(m / zeros);  // linear counting for small cardinalities
+    }
+    return raw;
+}
+
+/**
+ * @brief Gets the number of stops the sketches were built for.
+ * @return Number of stops.
+ */
+int ReachSketches::getMaxStops() const {
+    return maxStops;
+}
+
+/**
+ * @brief Gets the expected relative standard error of the estimates.
+ * @return 1.04 / sqrt(m).
+ */
+double ReachSketches::getStandardError() const {
+    return 1.04 / std::sqrt((double) registers);
+}
+
+/**
+ * @brief Mixes the bits of a value (splitmix64 finalizer) so items spread evenly over the registers.
+ * @param value The value.
+ * @return The hash.
+ */
+uint64_t ReachSketches::hash(uint64_t value) {
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+/**
+ * @brief Adds an item to the sketch of an airport.
+ * @param sketch Registers of every airport for one kind.
+ * @param airport Airport (vertex) id.
+ * @param item The item.
+ */
+void ReachSketches::add(std::vector<uint8_t>& sketch, int airport, uint64_t item) const {
+    uint64_t h = hash(item);
+    int index = h >> (64 - precision);
+    uint64_t rest = h << precision;
+    uint8_t rank = 1;
+    while (rank <= 64 - precision && !(rest & (uint64_t(1) << 63))) {
+        rest <<= 1;
+        rank++;
+    }
+    uint8_t& reg = sketch[(size_t) airport * registers + index];
+    reg = std::max(reg, rank);
+}
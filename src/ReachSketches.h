@@ -0,0 +1,36 @@
+#ifndef REACHSKETCHES_H
+#define REACHSKETCHES_H
+
+#include "DenseGraph.h"
+#include "FlightTable.h"
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief HyperLogLog estimates of how many airports, cities and countries every airport can reach within k stops.
+ *
+ * Each airport starts with sketches holding itself, its city and its country. Every round
+ * merges (register-wise max) the sketches of the airport's direct destinations into its own,
+ * so after k rounds each sketch summarizes the airport's k-hop neighbourhood.
+ */
+class ReachSketches {
+public:
+    enum Kind { Airports = 0, Cities = 1, Countries = 2 };
+
+    ReachSketches(const DenseGraph& graph, const FlightTable& table, int maxStops, int precision = 10, int threads = 0);
+
+    double estimate(int airport, Kind kind) const;
+    int getMaxStops() const;
+    double getStandardError() const;
+
+private:
+    int registers;                        // m = 2^precision registers per sketch
+    int precision;
+    int maxStops;
+    std::vector<uint8_t> sketches[3];     // per kind: airport id -> m registers
+
+    static uint64_t hash(uint64_t value);
+    void add(std::vector<uint8_t>& sketch, int airport, uint64_t item) const;
+};
+
+#endif // REACHSKETCHES_H
@@ -2,6 +2,8 @@
 #include "Airport.h"
 #include "Airline.h"
 #include "Flight.h"
+#include "Timetable.h"
+#include "Instrumentation.h"
 #include <fstream>
 #include <sstream>
 
@@ -13,11 +15,13 @@
  * @note Time complexity: O(N) where N is the number of lines in the file.
  */
 void Read::readAirlines(std::unordered_set<Airline>& airlines, const std::string& filename) {
+    INSTRUMENT_SCOPE(ReadAirlines);
     std::ifstream file(filename);
     std::string line;
     getline(file, line); // Skip header
 
     while (getline(file, line)) {
+        INSTRUMENT_COUNT(RowsParsed, 1);
         std::stringstream ss(line);
         std::string code, name, callsign, country;
         getline(ss, code, ',');
@@ -31,17 +35,20 @@ void Read::readAirlines(std::unordered_set<Airline>& airlines, const std::string
 }
 
 /**
- * @brief Reads airport data from a file and adds it to a graph.
+ * @brief Reads airport data from a file and adds it to a graph. Rows whose code is longer than
+ *        Airport::MaxCodeLength are skipped.
  * @param airportGraph Reference to the graph where airports will be added.
  * @param filename The name of the file containing airport data.
  * @note Time complexity: O(N) where N is the number of lines in the file.
  */
 void Read::readAirports(Graph<Airport>& airportGraph, const std::string& filename) {
+    INSTRUMENT_SCOPE(ReadAirports);
     std::ifstream file(filename);
     std::string line;
     getline(file, line); // Skip header
 
     while (getline(file, line)) {
+        INSTRUMENT_COUNT(RowsParsed, 1);
         std::stringstream ss(line);
         std::string code, name, city, country, lat, lon;
         getline(ss, code, ',');
@@ -50,6 +57,7 @@ void Read::readAirports(Graph<Airport>& airportGraph, const std::string& filenam
         getline(ss, country, ',');
         getline(ss, lat, ',');
         getline(ss, lon);
+        if (code.size() > Airport::MaxCodeLength) continue;
 
         Airport airport(code, name, city, country, stod(lat), stod(lon));
         airportGraph.addVertex(airport);
@@ -57,39 +65,118 @@ void Read::readAirports(Graph<Airport>& airportGraph, const std::string& filenam
 }
 
 /**
- * @brief Reads flight data from a file and adds it to the edges of a graph.
+ * @brief Reads flight data from a file and adds it to the edges of a graph. Columns after the
+ *        airline (the departure and arrival times of a timetable) are ignored.
  * @param airportGraph Reference to the graph where flights will be added.
  * @param filename The name of the file containing flight data.
- * @note Time complexity: O(N) where N is the number of lines in the file.
- *       Additional complexity depends on the implementation of graph operations.
+ * @note Time complexity: O(N * D) where N is the number of lines in the file and D is the
+ *       number of routes leaving the source airport (to find the route the flight belongs to).
  */
 
 void Read::readFlights(Graph<Airport>& airportGraph, const std::string& filename) {
+    INSTRUMENT_SCOPE(ReadFlights);
     std::ifstream file(filename);
     std::string line;
     getline(file, line); // Skip header
 
     while (getline(file, line)) {
+        INSTRUMENT_COUNT(RowsParsed, 1);
         std::stringstream ss(line);
         std::string sourceCode, targetCode, airline;
         getline(ss, sourceCode, ',');
         getline(ss, targetCode, ',');
-        getline(ss, airline);
+        getline(ss, airline, ',');
 
         Flight flight(sourceCode, targetCode, airline);
+        airportGraph.addFlight(Airport(sourceCode), Airport(targetCode), flight);
+    }
+}
+
+/**
+ * @brief Reads a flight delta file: a header, then one "Op,Source,Target,Airline" row per change,
+ *        where Op is '+' (or "add") to add the flight and '-' (or "remove") to remove it.
+ * @param changes Vector the changes are appended to, in file order. Rows with another Op are skipped.
+ * @param filename The name of the delta file.
+ * @return False if the file could not be opened.
+ * @note Time complexity: O(N) where N is the number of lines in the file.
+ */
+bool Read::readFlightDelta(std::vector<FlightChange>& changes, const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file) return false;
+    std::string line;
+    getline(file, line); // Skip header
+
+    while (getline(file, line)) {
+        INSTRUMENT_COUNT(RowsParsed, 1);
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        std::stringstream ss(line);
+        std::string op, sourceCode, targetCode, airline;
+        getline(ss, op, ',');
+        getline(ss, sourceCode, ',');
+        getline(ss, targetCode, ',');
+        getline(ss, airline);
+
+        bool removal = op == "-" || op == "remove";
+        if (!removal && op != "+" && op != "add") continue;
+        changes.push_back({removal, Flight(sourceCode, targetCode, airline)});
+    }
+    return true;
+}
+
+/**
+ * @brief Reads a timetable: a header, then one "Source,Target,Airline,Departure,Arrival" row per scheduled
+ *        departure, the columns of flights.csv followed by the times (see Timetable::parseTime), and sorts it.
+ *        Rows with an unknown airport or invalid times are skipped.
+ * @param timetable The timetable the departures are added to.
+ * @param filename The name of the timetable file.
+ * @return False if the file could not be opened.
+ * @note Time complexity: O(N log N) where N is the number of lines in the file.
+ */
+bool Read::readTimetable(Timetable& timetable, const std::string& filename) {
+    INSTRUMENT_SCOPE(ReadTimetable);
+    std::ifstream file(filename);
+    if (!file) return false;
+    std::string line;
+    getline(file, line); // Skip header
+
+    while (getline(file, line)) {
+        INSTRUMENT_COUNT(RowsParsed, 1);
+        std::stringstream ss(line);
+        std::string sourceCode, targetCode, airline, departure, arrival;
+        getline(ss, sourceCode, ',');
+        getline(ss, targetCode, ',');
+        getline(ss, airline, ',');
+        getline(ss, departure, ',');
+        getline(ss, arrival, ',');
+        timetable.addConnection(sourceCode, targetCode, airline, Timetable::parseTime(departure), Timetable::parseTime(arrival));
+    }
+    timetable.build();
+    return true;
+}
 
-        auto sourceVertex = airportGraph.findVertex(Airport(sourceCode));
-        auto targetVertex = airportGraph.findVertex(Airport(targetCode));
-
-        if (sourceVertex && targetVertex) {
-            Edge<Airport>* edge = airportGraph.getEdge(Airport(sourceCode), Airport(targetCode));
-            if (edge) {
-                edge->addFlight(flight);
-            } else {
-                airportGraph.addEdge(Airport(sourceCode), Airport(targetCode), 1);
-                edge = airportGraph.getEdge(Airport(sourceCode), Airport(targetCode));
-                edge->addFlight(flight);
-            }
-        }
+/**
+ * @brief Reads the minimum connection times: a header, then one "Airport,Minutes" row per airport.
+ *        A "*" airport sets the time of every airport not listed.
+ * @param timetable The timetable the times are set on.
+ * @param filename The name of the file.
+ * @return False if the file could not be opened.
+ * @note Time complexity: O(N) where N is the number of lines in the file.
+ */
+bool Read::readMinConnectionTimes(Timetable& timetable, const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file) return false;
+    std::string line;
+    getline(file, line); // Skip header
+
+    while (getline(file, line)) {
+        INSTRUMENT_COUNT(RowsParsed, 1);
+        std::stringstream ss(line);
+        std::string code, minutes;
+        getline(ss, code, ',');
+        getline(ss, minutes, ',');
+        int value = Timetable::parseTime(minutes);
+        if (code == "*") timetable.setDefaultMinConnectionTime(value);
+        else timetable.setMinConnectionTime(code, value);
     }
-}
\ No newline at end of file
+    return true;
+}
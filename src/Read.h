@@ -4,10 +4,13 @@
 #include "Graph.h"
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 class Airport;
 class Airline;
 class Flight;
+class Timetable;
+struct FlightChange;
 
 class Read {
 public:
@@ -16,6 +19,9 @@ public:
     void readAirports(Graph<Airport>& airportGraph, const std::string& filename);
     void readAirlines(std::unordered_set<Airline>& airlines, const std::string& filename);
     void readFlights(Graph<Airport>& airportGraph,  const std::string& filename);
+    bool readFlightDelta(std::vector<FlightChange>& changes, const std::string& filename);
+    bool readTimetable(Timetable& timetable, const std::string& filename);
+    bool readMinConnectionTimes(Timetable& timetable, const std::string& filename);
 };
 
 #endif // READ_H
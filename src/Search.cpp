@@ -2,24 +2,45 @@
 
 /**
  * @brief Constructs a new Search object.
- * @param graph Reference to the graph of airports.
+ * @param engine Query engine of the graph of airports; its condensation DAG is used to reject impossible routes without a search.
  */
-Search::Search(const Graph<Airport>& graph) : graph(graph) {
-    for (const auto& vertex : graph.getVertexSet()) {
-        const Airport& airport = vertex->getInfo();
-        airportsByCode[airport.getCode()] = airport;
-        airportsByCity[airport.getCity()].push_back(airport);
-    }
-}
+Search::Search(const QueryEngine& engine) : engine(engine), graph(engine.getGraph()), condensation(&engine.getCondensation()) {}
 
 /**
  * @brief Finds the best flight path from the source to the destination.
  * @param source The source location, which can be an airport code, city name, or coordinates.
  * @param destination The destination location, similar to source.
  * @return A vector of Airports representing the best flight path. Empty if no path is found.
- * @note Time complexity: O(V + E) where V is the number of vertices (airports) and E is the number of edges (flights) in the graph.
+ * @note Time complexity: O(P * L + H * D * L) with the hop labels, where P is the number of source and destination
+ *       pairs, L the size of their labels, H the number of flights of the path and D the degree of its airports
+ *       (see HopLabels::path()); plus building the labels on first use. Without labels, O(V + E) per pair, where
+ *       V is the number of vertices (airports) and E is the number of edges (flights) in the graph, and pairs in
+ *       different strongly connected components with no path in the condensation are rejected without a BFS.
  */
-std::vector<Airport> Search::findBestFlight(const std::string& source, const std::string& destination) {
+std::vector<Airport> Search::findBestFlight(const std::string& source, const std::string& destination) const {
+    INSTRUMENT_SCOPE(FindBestFlight);
+    const HopLabels& labels = engine.getHopLabels();
+    if (!labels.empty()) {
+        // The labels give the stops of every pair; only the first pair with the fewest is walked
+        int bestSource = -1, bestDestination = -1, minFlights = std::numeric_limits<int>::max();
+        std::vector<int> destinationIds = resolveIds(destination);
+        for (int sourceId : resolveIds(source)) {
+            for (int destinationId : destinationIds) {
+                int flights = labels.distance(sourceId, destinationId);
+                if (flights != HopLabels::Unreachable && flights < minFlights) {
+                    bestSource = sourceId;
+                    bestDestination = destinationId;
+                    minFlights = flights;
+                }
+            }
+        }
+        std::vector<Airport> shortestPath;
+        if (bestSource < 0) return shortestPath;
+        const DenseGraph& dense = engine.getDenseGraph();
+        for (int id : labels.path(dense, bestSource, bestDestination)) shortestPath.push_back(dense.vertices[id]->getInfo());
+        return shortestPath;
+    }
+
     // Resolve source and destination to actual airports
     std::vector<Airport> sourceAirports = resolveInput(source);
     std::vector<Airport> destinationAirports = resolveInput(destination);
@@ -29,7 +50,13 @@ std::vector<Airport> Search::findBestFlight(const std::string& source, const std
 
     for (const auto& srcAirport : sourceAirports) {
         for (const auto& destAirport : destinationAirports) {
+            if (condensation && !condensation->routeExists(srcAirport, destAirport)) {
+                continue;
+            }
             auto path = bfsFindPath(srcAirport, destAirport);
+            if (path.empty()) {
+                continue;
+            }
             int stops = path.size() - 1; // Num of stops is one less than the num of airports in the path
 
             if (stops < minStops) {
@@ -49,7 +76,7 @@ std::vector<Airport> Search::findBestFlight(const std::string& source, const std
  * @return A vector of Airports representing the path from src to dest. Empty if no path is found.
  * @note Time complexity: O(E) where E is the number of edges in the graph.
  */
-std::vector<Airport> Search::bfsFindPath(const Airport& src, const Airport& dest) {
+std::vector<Airport> Search::bfsFindPath(const Airport& src, const Airport& dest) const {
     std::queue<Airport> queue;
     std::unordered_map<Airport, Airport, AirportHash, AirportEqual> predecessors;
     std::unordered_set<Airport, AirportHash, AirportEqual> visited;
@@ -60,12 +87,15 @@ std::vector<Airport> Search::bfsFindPath(const Airport& src, const Airport& dest
     while (!queue.empty()) {
         Airport current = queue.front();
         queue.pop();
+        INSTRUMENT_COUNT(VerticesDequeued, 1);
 
         if (current == dest) {
             return reconstructPath(predecessors, src, dest);
         }
 
-        for (const auto& edge : graph.findVertex(current)->getAdj()) {
+        const auto& adj = graph.findVertex(current)->getAdj();
+        INSTRUMENT_COUNT(EdgesScanned, adj.size());
+        for (const auto& edge : adj) {
             Airport neighbor = edge.getDest()->getInfo();
             if (visited.find(neighbor) == visited.end()) {
                 visited.insert(neighbor);
@@ -86,7 +116,7 @@ std::vector<Airport> Search::bfsFindPath(const Airport& src, const Airport& dest
  * @return A vector of Airports representing the path from src to dest.
  */
 std::vector<Airport> Search::reconstructPath(const std::unordered_map<Airport, Airport, AirportHash, AirportEqual>& predecessors,
-                                             const Airport& src, const Airport& dest) {
+                                             const Airport& src, const Airport& dest) const {
     std::vector<Airport> path;
     for (Airport at = dest; !(at == src); at = predecessors.at(at)) {
         path.push_back(at);
@@ -96,30 +126,93 @@ std::vector<Airport> Search::reconstructPath(const std::unordered_map<Airport, A
     return path;
 }
 
+/**
+ * @brief Suggests airports, cities, countries and airlines whose names start like some text, allowing typos.
+ * @param text What was typed so far.
+ * @param limit Largest number of suggestions.
+ * @param maxEdits Typos allowed; by default, more for longer text (see Autocomplete::complete()).
+ * @return The suggestions, closest and then busiest first.
+ * @note Time complexity: see Autocomplete::complete().
+ */
+std::vector<Autocomplete::Suggestion> Search::suggest(const std::string& text, int limit, int maxEdits) const {
+    return engine.getAutocomplete().complete(text, limit, maxEdits);
+}
+
+/**
+ * @brief Finds the journey on the timetable that arrives earliest, leaving no earlier than a given time.
+ * @param source The source location, which can be an airport code, city name, or coordinates.
+ * @param destination The destination location, similar to source.
+ * @param departAfter Earliest departure, in minutes from the start of the timetable.
+ * @return The journey; no legs if there is no timetable or the destination cannot be reached.
+ * @note Time complexity: that of Timetable::earliestArrival().
+ */
+Timetable::Journey Search::findEarliestArrival(const std::string& source, const std::string& destination, int departAfter) const {
+    return engine.getTimetable().earliestArrival(resolveIds(source), resolveIds(destination), departAfter);
+}
+
+/**
+ * @brief Finds the journeys on the timetable for every departure of a window that no later departure beats.
+ * @param source The source location, which can be an airport code, city name, or coordinates.
+ * @param destination The destination location, similar to source.
+ * @param from Earliest departure, in minutes from the start of the timetable.
+ * @param until Latest departure.
+ * @return The journeys by increasing departure.
+ * @note Time complexity: that of Timetable::profile().
+ */
+std::vector<Timetable::Journey> Search::findJourneys(const std::string& source, const std::string& destination, int from, int until) const {
+    return engine.getTimetable().profile(resolveIds(source), resolveIds(destination), from, until);
+}
+
+/**
+ * @brief Finds the shortest route in kilometres, each route counting its great-circle distance.
+ * @param source The source location, which can be an airport code, city name, or coordinates.
+ * @param destination The destination location, similar to source.
+ * @return The route; no vertices if the destination cannot be reached.
+ * @note Time complexity: that of ContractionHierarchy::shortestRoute(), plus building the hierarchy on first use.
+ */
+ContractionHierarchy::Route Search::findShortestRoute(const std::string& source, const std::string& destination) const {
+    return engine.getHierarchy().shortestRoute(resolveIds(source), resolveIds(destination));
+}
+
 /**
  * @brief Resolves the user input to a list of corresponding airports.
- * @param input User input which can be an airport code, a city name, or geographical coordinates.
+ * @param input User input which can be an airport code, a city name, or geographical coordinates. Codes and names
+ *        that only match once normalised (case, punctuation and spacing aside), airport names included, resolve too.
  * @return A vector of Airports corresponding to the input.
- * @note Time complexity: O(N) where N is the number of airports (for city names or coordinates).
+ * @note Time complexity: O(L + A) for codes and city names, where L is the length of the input and A the number
+ *       of airports found; see QueryEngine::findNearestAirport() for coordinates and Autocomplete::match() for the rest.
  */
-std::vector<Airport> Search::resolveInput(const std::string& input) {
+std::vector<Airport> Search::resolveInput(const std::string& input) const {
     std::vector<Airport> airports;
 
     // CHECK IF INPUT IS AIRPORTCODE
-    if (airportsByCode.find(input) != airportsByCode.end()) {
-        airports.push_back(airportsByCode[input]);
+    if (const Vertex<Airport>* airport = engine.findAirport(input)) {
+        airports.push_back(airport->getInfo());
+        return airports;
+    }
+    // CHECK IF INPUT IS CITY NAME
+    for (const Vertex<Airport>* airport : engine.findAirportsInCity(input)) {
+        airports.push_back(airport->getInfo());
     }
-        // CHECK IF INPUT IS CITY NAME
-    else if (airportsByCity.find(input) != airportsByCity.end()) {
-        airports.insert(airports.end(), airportsByCity[input].begin(), airportsByCity[input].end());
+    // HANDLE COORDINATES INPUT
+    double inputLat, inputLon;
+    if (airports.empty() && parseCoordinates(input, inputLat, inputLon)) {
+        if (const Vertex<Airport>* nearest = engine.findNearestAirport(inputLat, inputLon)) {
+            airports.push_back(nearest->getInfo());
+        }
+        return airports;
     }
-        // HANDLE COORDINATES INPUT
-    else {
-        double inputLat, inputLon;
-        if (parseCoordinates(input, inputLat, inputLon)) {
-            Airport nearestAirport = findNearestAirport(inputLat, inputLon);
-            if (!nearestAirport.getCode().empty()) {
-                airports.push_back(nearestAirport);
+    // NORMALISED AIRPORT CODE, AIRPORT NAME OR CITY NAME
+    if (airports.empty()) {
+        std::unordered_set<uint64_t> seen;
+        auto addAirport = [&](const Vertex<Airport>* airport) {
+            if (airport && seen.insert(airport->getInfo().getCodeKey()).second) airports.push_back(airport->getInfo());
+        };
+        for (const auto& match : engine.getAutocomplete().match(input)) {
+            if (match.kind == Autocomplete::Kind::Airport) {
+                addAirport(engine.findAirport(match.code));
+            } else if (match.kind == Autocomplete::Kind::City) {
+                for (const Vertex<Airport>* airport : engine.findAirportsInCity(match.name)) addAirport(airport);
             }
         }
     }
@@ -127,28 +220,13 @@ std::vector<Airport> Search::resolveInput(const std::string& input) {
     return airports;
 }
 
-/**
- * @brief Finds the nearest airport to the given geographical coordinates.
- * @param lat Latitude.
- * @param lon Longitude.
- * @return The nearest Airport object. Empty if none found.
- * @note Time complexity: O(N) where N is the number of airports.
- */
-Airport Search::findNearestAirport(double lat, double lon) {
-    double minDistance = std::numeric_limits<double>::max();
-    Airport nearestAirport;
-
-    for (const auto& pair : airportsByCode) {
-        const Airport& airport = pair.second;
-        double distance = Haversine::haversineDistance(lat, lon, airport.getLatitude(), airport.getLongitude());
-
-        if (distance < minDistance) {
-            minDistance = distance;
-            nearestAirport = airport;
-        }
+// Vertex ids of the airports an input resolves to
+std::vector<int> Search::resolveIds(const std::string& input) const {
+    std::vector<int> ids;
+    for (const auto& airport : resolveInput(input)) {
+        if (const auto* vertex = graph.findVertex(airport)) ids.push_back(vertex->getId());
     }
-
-    return nearestAirport;
+    return ids;
 }
 
 /**
@@ -158,7 +236,7 @@ Airport Search::findNearestAirport(double lat, double lon) {
  * @param lon Reference to store longitude.
  * @return True if parsing is successful, false otherwise.
  */
-bool Search::parseCoordinates(const std::string& input, double& lat, double& lon) {
+bool Search::parseCoordinates(const std::string& input, double& lat, double& lon) const {
     std::istringstream iss(input);
     char delimiter;
 
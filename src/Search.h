@@ -1,5 +1,10 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
 #include "Graph.h"
 #include "Airport.h"
+#include "Condensation.h"
+#include "QueryEngine.h"
 #include <unordered_map>
 #include <unordered_set>
 #include <queue>
@@ -9,40 +14,49 @@
 #include <cmath>
 #include <algorithm>
 #include "Haversine.h"
+#include "Instrumentation.h"
 #include <string>
 #include <sstream>
 
+/**
+ * @brief Flight searches over a QueryEngine, whose indexes resolve the endpoints; constructing one costs nothing.
+ */
 class Search {
 public:
-    Search(const Graph<Airport>& graph);
+    explicit Search(const QueryEngine& engine);
 
-    std::vector<Airport> findBestFlight(const std::string& source, const std::string& destination);
+    std::vector<Airport> findBestFlight(const std::string& source, const std::string& destination) const;
 
     std::vector<std::pair<Airport, std::string>> findBestFlight(
             const std::string& source,
             const std::string& destination,
             const std::unordered_set<std::string>& preferredAirlines,
-            bool minimizeAirlineChanges);
+            bool minimizeAirlineChanges) const;
+
+    std::vector<Autocomplete::Suggestion> suggest(const std::string& text, int limit = 10, int maxEdits = -1) const;
 
+    Timetable::Journey findEarliestArrival(const std::string& source, const std::string& destination, int departAfter) const;
+    std::vector<Timetable::Journey> findJourneys(const std::string& source, const std::string& destination, int from, int until) const;
+    ContractionHierarchy::Route findShortestRoute(const std::string& source, const std::string& destination) const;
 
 private:
+    const QueryEngine& engine;
     const Graph<Airport>& graph;
-    std::unordered_map<std::string, Airport> airportsByCode;
-    std::unordered_map<std::string, std::vector<Airport>> airportsByCity;
+    const Condensation* condensation;
 
     //AUX
-    std::vector<Airport> bfsFindPath(const Airport& src, const Airport& dest);
+    std::vector<Airport> bfsFindPath(const Airport& src, const Airport& dest) const;
     std::vector<Airport> reconstructPath(const std::unordered_map<Airport, Airport, AirportHash, AirportEqual>& predecessors,
-                                                 const Airport& src, const Airport& dest);
-    std::vector<Airport> resolveInput(const std::string& input);
-    Airport findNearestAirport(double lat, double lon);
-    bool parseCoordinates(const std::string& input, double& lat, double& lon);
+                                                 const Airport& src, const Airport& dest) const;
+    std::vector<Airport> resolveInput(const std::string& input) const;
+    std::vector<int> resolveIds(const std::string& input) const;
+    bool parseCoordinates(const std::string& input, double& lat, double& lon) const;
     std::vector<std::pair<Airport, std::string>> bfsFindPathWithFilters(
             const Airport& src,
             const Airport& dest,
             const std::unordered_set<std::string>& preferredAirlines,
-            bool minimizeAirlineChanges);
+            bool minimizeAirlineChanges) const;
 
 };
 
-
+#endif // SEARCH_H
@@ -0,0 +1,171 @@
+#include "Server.h"
+#include "Protocol.h"
+#include "Parallel.h"
+#include "Instrumentation.h"
+#include <chrono>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// How often blocked calls wake up to notice stop()
+const int STOP_POLL_MS = 200;
+
+/**
+ * @brief Constructor.
+ * @param runner Answers the queries; shared by every worker.
+ * @param workers Number of worker threads (values below 1 use Parallel::defaultThreads()).
+ */
+Server::Server(BatchRunner& runner, int workers)
+        : runner(runner), workers(workers < 1 ? Parallel::defaultThreads() : workers), stopping(false), requestsServed(0) {}
+
+Server::~Server() {
+    if (listenFd >= 0) close(listenFd);
+    if (!socketPath.empty()) unlink(socketPath.c_str());
+}
+
+/**
+ * @brief Listens on a Unix domain socket; the socket file is removed when the server is destroyed.
+ * @param path Path of the socket file.
+ * @return False if the socket could not be created.
+ */
+bool Server::listenUnix(const std::string& path) {
+    listenFd = Protocol::listenUnix(path);
+    if (listenFd >= 0) socketPath = path;
+    return listenFd >= 0;
+}
+
+/**
+ * @brief Listens on a TCP port of the loopback interface.
+ * @param port The port.
+ * @return False if the socket could not be created.
+ */
+bool Server::listenTcp(int port) {
+    listenFd = Protocol::listenTcp(port);
+    return listenFd >= 0;
+}
+
+/**
+ * @brief Accepts connections and serves their requests until stop() is called, then waits for the workers.
+ */
+void Server::serve() {
+    // A client closing early must not kill the server
+    signal(SIGPIPE, SIG_IGN);
+    if (pipe(wakeFds) < 0) return;
+    fcntl(wakeFds[1], F_SETFL, O_NONBLOCK);
+
+    std::vector<std::thread> pool;
+    for (int i = 0; i < workers; i++) pool.emplace_back(&Server::work, this);
+
+    std::vector<int> connections;  // waiting for their next request
+    std::vector<pollfd> polled;
+    while (!stopping.load()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            connections.insert(connections.end(), returned.begin(), returned.end());
+            returned.clear();
+        }
+        polled.assign({{listenFd, POLLIN, 0}, {wakeFds[0], POLLIN, 0}});
+        for (int fd : connections) polled.push_back({fd, POLLIN, 0});
+        if (poll(polled.data(), polled.size(), STOP_POLL_MS) <= 0) continue;
+
+        if (polled[1].revents) {
+            char drained[64];
+            ssize_t ignored = read(wakeFds[0], drained, sizeof(drained));
+            (void) ignored;
+        }
+        // A connection with something to read (or closed) is taken out of the poll set until a worker returns it
+        std::vector<int> still;
+        for (size_t i = 2; i < polled.size(); i++) {
+            if (polled[i].revents) {
+                std::lock_guard<std::mutex> lock(mutex);
+                pending.push_back(polled[i].fd);
+                ready.notify_one();
+            } else {
+                still.push_back(polled[i].fd);
+            }
+        }
+        connections.swap(still);
+        if (polled[0].revents) {
+            int fd = accept(listenFd, nullptr, nullptr);
+            if (fd >= 0) connections.push_back(fd);
+        }
+    }
+
+    ready.notify_all();
+    for (auto& worker : pool) worker.join();
+    for (int fd : connections) close(fd);
+    for (int fd : pending) close(fd);
+    for (int fd : returned) close(fd);
+    pending.clear();
+    returned.clear();
+    close(wakeFds[0]);
+    close(wakeFds[1]);
+    wakeFds[0] = wakeFds[1] = -1;
+}
+
+/**
+ * @brief Asks serve() to return; connections being served are closed after their current request.
+ * @note Only stores an atomic flag, so it may be called from a signal handler.
+ */
+void Server::stop() {
+    stopping.store(true);
+}
+
+long Server::getRequestsServed() const {
+    return requestsServed.load();
+}
+
+void Server::work() {
+    while (true) {
+        int fd;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ready.wait(lock, [this]() { return stopping.load() || !pending.empty(); });
+            if (pending.empty()) return;
+            fd = pending.front();
+            pending.pop_front();
+        }
+        if (!handle(fd)) {
+            close(fd);
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        returned.push_back(fd);
+        ssize_t ignored = write(wakeFds[1], "", 1);  // fails only if the pipe is full, which already wakes the poll
+        (void) ignored;
+    }
+}
+
+/**
+ * @brief Answers the request waiting on a connection. Answers larger than a frame can hold are replaced by an error.
+ * @param fd Connected socket with a request to read.
+ * @return False if the connection should be closed: the client closed it, a read or write failed or timed out,
+ *         or the server is stopping.
+ */
+bool Server::handle(int fd) {
+    std::string request;
+    if (stopping.load() || !Protocol::readFrame(fd, request, FrameTimeoutMs)) return false;
+
+    auto start = std::chrono::steady_clock::now();
+    std::string answer;
+    {
+        INSTRUMENT_SCOPE(ServerRequest);
+        answer = runner.runLine(request);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // Leaves room for the latency member
+    if (answer.size() > Protocol::MaxFrameBytes - 64) {
+        answer = JsonObject().add("ok", false).add("error", "the answer (" + std::to_string(answer.size())
+                + " bytes) is larger than a frame can hold (" + std::to_string(Protocol::MaxFrameBytes) + " bytes)").str();
+    }
+    // Every answer is a non-empty JSON object, so the latency is added as its first member
+    double latencyUs = std::chrono::duration<double, std::micro>(elapsed).count();
+    answer = "{\"latency_us\":" + Json::number(latencyUs) + "," + answer.substr(1);
+    requestsServed++;
+    return Protocol::writeFrame(fd, answer, FrameTimeoutMs);
+}
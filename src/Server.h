@@ -0,0 +1,58 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "BatchRunner.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+
+/**
+ * @brief Long-running query server over a Unix domain socket or a loopback TCP port.
+ *
+ * One thread accepts connections and polls every open one; when a request (a frame, see
+ * Protocol) arrives on a connection, the connection goes to a fixed pool of worker threads,
+ * one of which answers that request and hands the connection back to be polled. Idle
+ * connections therefore hold no worker, and the requests of a connection are answered in
+ * order. A request must arrive whole within FrameTimeoutMs of a worker starting to read it,
+ * and the client must take the whole answer within as long, or the connection is closed, so
+ * a client trickling bytes holds a worker for FrameTimeoutMs at most. Every worker queries the same BatchRunner, so the dataset and indexes
+ * are loaded once. Each response gets a "latency_us" member: the time from reading the request
+ * to having the answer, including any wait for the graph.
+ */
+class Server {
+public:
+    static const int FrameTimeoutMs = 10000;
+
+    Server(BatchRunner& runner, int workers);
+    ~Server();
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    bool listenUnix(const std::string& path);
+    bool listenTcp(int port);
+    void serve();
+    void stop();
+
+    long getRequestsServed() const;
+
+private:
+    BatchRunner& runner;
+    int workers;
+    int listenFd = -1;
+    std::string socketPath;
+    std::atomic<bool> stopping;
+    std::atomic<long> requestsServed;
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<int> pending;   // connections with a request no worker has taken yet
+    std::deque<int> returned;  // connections answered by a worker, to be polled again
+    int wakeFds[2] = {-1, -1}; // pipe that wakes the polling thread when a connection is returned
+
+    void work();
+    bool handle(int fd);
+};
+
+#endif // SERVER_H
@@ -1,15 +1,67 @@
 #include "Statistics.h"
+#include "Parallel.h"
+#include "Instrumentation.h"
+#include "StringPool.h"
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+// Largest number of (key, key) groups a thread accumulates in a dense array
+constexpr size_t MAX_DENSE_PAIR_GROUPS = 1 << 22;
 
 /**
- * @brief Constructs a Statistics object.
- * @param airportGraph Reference to the graph of airports.
- * @param airlines Set of airlines.
+ * @brief Thread-local counts of (key, key) groups.
+ *
+ * Dense when the key space is small compared to the rows the thread will see, since
+ * every dense cell has to be allocated and merged; hashed otherwise.
  */
-Statistics::Statistics(Graph<Airport>& airportGraph, std::unordered_set<Airline>& airlines )
-        : airportGraph(airportGraph), airlines(airlines) {}
+struct PairHistogram {
+    size_t secondCardinality;
+    std::vector<long> dense;
+    std::unordered_map<uint64_t, long> sparse;
+
+    PairHistogram(size_t firstCardinality, size_t secondCardinality, size_t rows) : secondCardinality(secondCardinality) {
+        size_t groups = firstCardinality * secondCardinality;
+        if (groups <= MAX_DENSE_PAIR_GROUPS && groups <= 4 * rows) {
+            dense.assign(firstCardinality * secondCardinality, 0);
+        }
+    }
 
+    void add(int first, int second) {
+        if (!dense.empty()) dense[first * secondCardinality + second]++;
+        else sparse[((uint64_t) first << 32) | (uint32_t) second]++;
+    }
 
+    void merge(const PairHistogram& other) {
+        for (size_t k = 0; k < other.dense.size(); k++) dense[k] += other.dense[k];
+        for (const auto& entry : other.sparse) sparse[entry.first] += entry.second;
+    }
 
+    std::vector<Aggregation::PairCount> groups() const {
+        std::vector<Aggregation::PairCount> result;
+        for (size_t k = 0; k < dense.size(); k++) {
+            if (dense[k]) result.push_back({(int) (k / secondCardinality), (int) (k % secondCardinality), dense[k]});
+        }
+        for (const auto& entry : sparse) {
+            result.push_back({(int) (entry.first >> 32), (int) (entry.first & 0xffffffffu), entry.second});
+        }
+        std::sort(result.begin(), result.end(), [](const Aggregation::PairCount& a, const Aggregation::PairCount& b) {
+            return a.first != b.first ? a.first < b.first : a.second < b.second;
+        });
+        return result;
+    }
+};
+
+/**
+ * @brief Constructs a Statistics object.
+ * @param engine Query engine of the graph of airports, whose flight table the per-city/airline/country
+ *        reports are computed on, whose city/country indexes serve the country-diversity queries and
+ *        whose live ranking serves the top-k queries it tracks.
+ * @note Time complexity: O(1)
+ */
+Statistics::Statistics(const QueryEngine& engine)
+        : engine(engine), airportGraph(engine.getGraph()), airlines(engine.getAirlines()), flightTable(engine.getFlightTable()),
+          geoIndex(engine.getGeoIndex()), liveRanking(&engine.getRanking()) {}
 
 /**
  * @brief Gets the total number of airports in the graph.
@@ -21,20 +73,12 @@ int Statistics::getTotalNumberOfAirports() const {
 }
 
 /**
- * @brief Calculates the total number of flights across all airports.
+ * @brief Gets the total number of flights across all airports.
  * @return Total number of flights.
- * @note Time complexity: O(V + E) where V is the number of vertices (airports) and E is the number of edges (flights).
+ * @note Time complexity: O(1), the graph keeps the count up to date as flights are added or removed.
  */
 int Statistics::getTotalNumberOfFlights() const {
-    int totalFlights = 0;
-
-    for (const auto* vertex : airportGraph.getVertexSet()) {
-        for (const auto& edge : vertex->getAdj()) {
-            totalFlights += edge.getFlights().size();
-        }
-    }
-
-    return totalFlights;
+    return airportGraph.getNumFlights();
 }
 
 
@@ -44,36 +88,71 @@ int Statistics::getTotalNumberOfFlights() const {
  * @brief Gets the number of unique airlines operating from a given airport.
  * @param airportCode The airport code.
  * @return The number of unique airlines.
- * @note Time complexity: O(E) where E is the number of edges (flights) from the given airport.
+ * @note Time complexity: O(1), read from the per-airport airline counters.
  */
 long Statistics::getNumberOfUniqueAirlinesFromAirport(const std::string &airportCode) const {
     const auto *airportVertex = airportGraph.findVertex(Airport(airportCode));
     if (!airportVertex) return -1;
-
-    std::unordered_set<std::string> uniqueAirlines;
-    for (const auto &edge: airportVertex->getAdj()) {
-        for (const auto &flight: edge.getFlights()) {
-            uniqueAirlines.insert(flight.getAirline());
-        }
-    }
-    return uniqueAirlines.size();
+    return airportVertex->getNumAirlines();
 }
 
 /**
  * @brief Gets the number of flights departing from a given airport.
  * @param airportCode The airport code.
  * @return The number of flights from the airport.
- * @note Time complexity: O(E) where E is the number of edges (flights) from the given airport.
+ * @note Time complexity: O(1), read from the per-airport flight counters.
  */
 long Statistics::getNumberOfFlightsFromAirport(const std::string &airportCode) const {
     const auto *airportVertex = airportGraph.findVertex(Airport(airportCode));
     if (!airportVertex) return -1;
+    return airportVertex->getOutFlights();
+}
+
+/**
+ * @brief Gets the number of flights arriving at a given airport.
+ * @param airportCode The airport code.
+ * @return The number of flights to the airport.
+ * @note Time complexity: O(1), read from the per-airport flight counters.
+ */
+long Statistics::getNumberOfFlightsToAirport(const std::string &airportCode) const {
+    const auto *airportVertex = airportGraph.findVertex(Airport(airportCode));
+    if (!airportVertex) return -1;
+    return airportVertex->getInFlights();
+}
 
-    long count = 0;
-    for (const auto &edge: airportVertex->getAdj()) {
-        count += edge.getFlights().size();
+/**
+ * @brief Gets the number of unique airlines flying into a given airport.
+ * @param airportCode The airport code.
+ * @return The number of unique airlines.
+ * @note Time complexity: O(S) where S is the number of routes leaving the airports with flights to it.
+ */
+long Statistics::getNumberOfUniqueAirlinesToAirport(const std::string &airportCode) const {
+    const auto *airportVertex = airportGraph.findVertex(Airport(airportCode));
+    if (!airportVertex) return -1;
+    std::unordered_set<std::string> arrivingAirlines;
+    for (const auto* source : airportVertex->getIncoming()) {
+        for (const auto& edge : source->getAdj()) {
+            if (edge.getDest() != airportVertex) continue;
+            for (const auto& flight : edge.getFlights()) arrivingAirlines.insert(flight.getAirline());
+        }
     }
-    return count;
+    return arrivingAirlines.size();
+}
+
+/**
+ * @brief Gets the airports with direct flights to a given airport.
+ * @param airportCode The airport code.
+ * @return The codes of the origin airports, sorted. Empty if the airport does not exist.
+ * @note Time complexity: O(I log I) where I is the number of routes arriving at the airport.
+ */
+std::vector<std::string> Statistics::getAirportsWithFlightsTo(const std::string &airportCode) const {
+    std::vector<std::string> origins;
+    const auto *airportVertex = airportGraph.findVertex(Airport(airportCode));
+    if (!airportVertex) return origins;
+    for (const auto* source : airportVertex->getIncoming()) origins.push_back(source->getInfo().getCode());
+    std::sort(origins.begin(), origins.end());
+    origins.erase(std::unique(origins.begin(), origins.end()), origins.end());
+    return origins;
 }
 
 
@@ -83,20 +162,14 @@ long Statistics::getNumberOfFlightsFromAirport(const std::string &airportCode) c
 /**
  * @brief Gets the number of flights per city and per airline.
  * @return A map where the key is a pair of city and airline, and the value is the number of flights.
- * @note Time complexity: O(V * E) where V is the number of vertices (airports) and E is the number of edges (flights).
+ * @note Time complexity: O(F + C * A) where F is the number of flights, C the number of cities and A the number of airlines.
  */
 std::map<std::pair<std::string, std::string>, long> Statistics::getNumberOfFlightsPerCityAirline() const {
     std::map<std::pair<std::string, std::string>, long> cityAirlineFlights;
 
-    for (const auto* vertex : airportGraph.getVertexSet()) {
-        std::string city = vertex->getInfo().getCity();
-        for (const auto& edge : vertex->getAdj()) {
-            for (const auto& flight : edge.getFlights()) {
-                std::string airline = flight.getAirline();
-                std::pair<std::string, std::string> cityAirlinePair = std::make_pair(city, airline);
-                cityAirlineFlights[cityAirlinePair]++;
-            }
-        }
+    for (const auto& group : Aggregation::countBy(flightTable.sourceCity, flightTable.cities.size(),
+                                                  flightTable.airline, flightTable.airlines.size())) {
+        cityAirlineFlights[{flightTable.cities.get(group.first), flightTable.airlines.get(group.second)}] = group.count;
     }
 
     return cityAirlineFlights;
@@ -105,17 +178,15 @@ std::map<std::pair<std::string, std::string>, long> Statistics::getNumberOfFligh
 /**
  * @brief Gets the number of flights per city.
  * @return A map where the key is the city name and the value is the number of flights.
- * @note Time complexity: O(V * E) where V is the number of vertices (airports) and E is the number of edges (flights).
+ * @note Time complexity: O(F + C log C) where F is the number of flights and C the number of cities.
  */
 std::map<std::string, long> Statistics::getNumberOfFlightsPerCity() const {
     std::map<std::string, long> cityFlights;
 
-    for (const auto* vertex : airportGraph.getVertexSet()) {
-        std::string city = vertex->getInfo().getCity();
-        for (const auto& edge : vertex->getAdj()) {
-            for (const auto& flight : edge.getFlights()) {
-                cityFlights[city]++;
-            }
+    auto counts = Aggregation::countBy(flightTable.sourceCity, flightTable.cities.size());
+    for (size_t city = 0; city < counts.size(); city++) {
+        if (counts[city]) {
+            cityFlights[flightTable.cities.get(city)] = counts[city];
         }
     }
 
@@ -124,68 +195,123 @@ std::map<std::string, long> Statistics::getNumberOfFlightsPerCity() const {
 
 /**
  * @brief Calculates the number of flights per airline in the airport graph.
- *
- * This function iterates through the airport graph's edges and flights to count the number of flights operated by each airline.
- *
- * @return A map associating airline names with the number of flights they operate.
- * @note This function assumes that the airport graph has been properly constructed.
- *       Time complexity: O(V*E*F) where V is the number of vertices, E is the number of edges, and F is the average number of flights per edge.
+ * @return A map associating airline codes with the number of flights they operate.
+ * @note Time complexity: O(F + A log A) where F is the number of flights and A the number of airlines.
  */
 std::map<std::string, long> Statistics::getNumberOfFlightsPerAirline() const {
     std::map<std::string, long> airlineFlights;
 
-    for (const auto* vertex : airportGraph.getVertexSet()) {
-        for (const auto& edge : vertex->getAdj()) {
-            for (const auto& flight : edge.getFlights()) {
-                std::string airline = flight.getAirline();
-                airlineFlights[airline]++;
-            }
+    auto counts = Aggregation::countBy(flightTable.airline, flightTable.airlines.size());
+    for (size_t airline = 0; airline < counts.size(); airline++) {
+        if (counts[airline]) {
+            airlineFlights[flightTable.airlines.get(airline)] = counts[airline];
         }
     }
 
     return airlineFlights;
 }
 
+/**
+ * @brief Gets the number of flights per departure country and per airline.
+ * @return A map where the key is a pair of country and airline, and the value is the number of flights.
+ * @note Time complexity: O(F + N * A) where F is the number of flights, N the number of countries and A the number of airlines.
+ */
+std::map<std::pair<std::string, std::string>, long> Statistics::getNumberOfFlightsPerCountryAirline() const {
+    std::map<std::pair<std::string, std::string>, long> countryAirlineFlights;
+
+    for (const auto& group : Aggregation::countBy(flightTable.sourceCountry, flightTable.countries.size(),
+                                                  flightTable.airline, flightTable.airlines.size())) {
+        countryAirlineFlights[{flightTable.countries.get(group.first), flightTable.airlines.get(group.second)}] = group.count;
+    }
+
+    return countryAirlineFlights;
+}
+
+/**
+ * @brief Gets the number of flights per route distance.
+ * @param bucketKm Width of each distance bucket, in kilometers; at least MinBucketKm.
+ * @return A map where the key is the lower bound of a bucket (in km) and the value is the number of flights in it.
+ *         Empty if the width is too small or not a number.
+ * @note Time complexity: O(F + B) where F is the number of flights and B the number of buckets.
+ */
+std::map<double, long> Statistics::getNumberOfFlightsPerDistance(double bucketKm) const {
+    std::map<double, long> distanceFlights;
+    if (!(bucketKm >= MinBucketKm) || !std::isfinite(bucketKm)) return distanceFlights;
+
+    auto buckets = Aggregation::bucketize(flightTable.distance, bucketKm);
+    int numBuckets = buckets.empty() ? 0 : *std::max_element(buckets.begin(), buckets.end()) + 1;
+    auto counts = Aggregation::countBy(buckets, numBuckets);
+    for (int bucket = 0; bucket < numBuckets; bucket++) {
+        if (counts[bucket]) {
+            distanceFlights[bucket * bucketKm] = counts[bucket];
+        }
+    }
+
+    return distanceFlights;
+}
+
 
 
 /**
  * @brief Gets the number of different countries reachable from a given airport.
  * @param airportCode The airport code.
  * @return The number of different countries.
- * @note Time complexity: O(E) where E is the number of edges (flights) from the given airport.
+ * @note Time complexity: O(N / 64) where N is the number of countries, a popcount of the airport's destination-country bitset.
  */
 long Statistics::getNumberOfDiffCountriesByAirport(const std::string& airportCode) const{
-
     const auto* airportVertex = airportGraph.findVertex(Airport(airportCode));
     if (!airportVertex) return -1;
+    return geoIndex.countDestinationCountriesOfAirport(airportVertex->getId());
+}
 
-    std::unordered_set<std::string> uniqueCountries;
-    for (const auto& edge : airportVertex->getAdj()) {
-        const auto* destAirportVertex = edge.getDest();
-        uniqueCountries.insert(destAirportVertex->getInfo().getCountry());
+/**
+ * @brief Gets the number of different countries with direct flights to a given airport.
+ * @param airportCode The airport code.
+ * @return The number of different origin countries.
+ * @note Time complexity: O(I) where I is the number of routes arriving at the airport.
+ */
+long Statistics::getNumberOfDiffCountriesToAirport(const std::string& airportCode) const {
+    const auto* airportVertex = airportGraph.findVertex(Airport(airportCode));
+    if (!airportVertex) return -1;
+    std::vector<char> seen(flightTable.countries.size(), false);
+    long countries = 0;
+    for (const auto* source : airportVertex->getIncoming()) {
+        int country = flightTable.airportCountry[source->getId()];
+        if (!seen[country]) {
+            seen[country] = true;
+            countries++;
+        }
     }
-
-    return uniqueCountries.size();
+    return countries;
 }
 
 /**
  * @brief Gets the number of different countries reachable from a given city.
  * @param city The name of the city.
  * @return The number of different countries.
- * @note Time complexity: O(E) where E is the number of edges (flights) from the given city.
+ * @note Time complexity: O(A * N / 64) where A is the number of airports in the city and N the number of countries.
  */
 long Statistics::getNumberOfDiffCountriesByCity(const std::string& city) const{
-    std::unordered_set<std::string> uniqueCountries;
-    for(const auto* airportVertex : airportGraph.getVertexSet()){
-        if(airportVertex->getInfo().getCity()==city){
-            for (const auto& edge : airportVertex->getAdj()) {
-                const auto* destAirportVertex = edge.getDest();
-                uniqueCountries.insert(destAirportVertex->getInfo().getCountry());
-            }
-        }
+    int cityId = flightTable.cities.find(city);
+    if (cityId == -1) return 0;
+    return geoIndex.countDestinationCountriesOfCity(cityId);
+}
 
+/**
+ * @brief Gets the countries with direct flights from any airport of a given country.
+ * @param country The name of the country.
+ * @return The names of the destination countries (including the country itself if it has domestic flights).
+ * @note Time complexity: O(A * N / 64 + N) where A is the number of airports in the country and N the number of countries.
+ */
+std::vector<std::string> Statistics::getCountriesReachableFromCountry(const std::string& country) const {
+    std::vector<std::string> countries;
+    int countryId = flightTable.countries.find(country);
+    if (countryId == -1) return countries;
+
+    for (int destination : geoIndex.getDestinationCountriesOfCountry(countryId)) {
+        countries.push_back(flightTable.countries.get(destination));
     }
-    return uniqueCountries.size();
+    return countries;
 }
 
 
@@ -199,6 +325,7 @@ long Statistics::getNumberOfDiffCountriesByCity(const std::string& city) const{
  * @note Time complexity: O(V + E) where V is the number of vertices (airports) and E is the number of edges (flights).
  */
 std::unordered_set<std::string> Statistics::getReachableAirports(const std::string& airportCode, int maxStops) const {
+    INSTRUMENT_SCOPE(Reachable);
     std::unordered_set<std::string> reachableAirports;
     std::queue<std::pair<Vertex<Airport>*, int>> q;
     std::unordered_set<Vertex<Airport>*> visited;
@@ -211,10 +338,12 @@ std::unordered_set<std::string> Statistics::getReachableAirports(const std::stri
         while (!q.empty()) {
             auto [v, stops] = q.front();
             q.pop();
+            INSTRUMENT_COUNT(VerticesDequeued, 1);
 
             if (stops <= maxStops) {
                 reachableAirports.insert(v->getInfo().getCode());
 
+                INSTRUMENT_COUNT(EdgesScanned, v->getAdj().size());
                 for (const auto& e : v->getAdj()) {
                     Vertex<Airport>* w = e.getDest();
                     if (visited.find(w) == visited.end()) {
@@ -241,7 +370,8 @@ std::unordered_set<std::string> Statistics::getReachableAirports(const std::stri
  *       Time complexity: O(V*(V+E)) where V is the number of vertices and E is the number of edges.
  */
 std::unordered_set<std::string> Statistics::getReachableCities(const std::string& airportCode, int maxStops) const {
-    std::unordered_set<std::string> reachableCities;
+    INSTRUMENT_SCOPE(Reachable);
+    std::unordered_set<uint32_t> cityIds;  // StringPool ids, named once at the end
     std::queue<std::pair<Vertex<Airport>*, int>> q;
     std::unordered_set<Vertex<Airport>*> visited;
 
@@ -253,10 +383,12 @@ std::unordered_set<std::string> Statistics::getReachableCities(const std::string
         while (!q.empty()) {
             auto [v, stops] = q.front();
             q.pop();
+            INSTRUMENT_COUNT(VerticesDequeued, 1);
 
             if (stops <= maxStops) {
-                reachableCities.insert(v->getInfo().getCity());
+                cityIds.insert(v->getInfo().getCityId());
 
+                INSTRUMENT_COUNT(EdgesScanned, v->getAdj().size());
                 for (const auto& e : v->getAdj()) {
                     Vertex<Airport>* w = e.getDest();
                     if (visited.find(w) == visited.end()) {
@@ -268,6 +400,8 @@ std::unordered_set<std::string> Statistics::getReachableCities(const std::string
         }
     }
 
+    std::unordered_set<std::string> reachableCities;
+    for (uint32_t id : cityIds) reachableCities.insert(StringPool::global().get(id));
     return reachableCities;
 }
 
@@ -283,7 +417,8 @@ std::unordered_set<std::string> Statistics::getReachableCities(const std::string
  *       Time complexity: O(V*(V+E)) where V is the number of vertices and E is the number of edges.
  */
 std::unordered_set<std::string> Statistics::getReachableCountries(const std::string& airportCode, int maxStops) const {
-    std::unordered_set<std::string> reachableCountries;
+    INSTRUMENT_SCOPE(Reachable);
+    std::unordered_set<uint32_t> countryIds;  // StringPool ids, named once at the end
     std::queue<std::pair<Vertex<Airport>*, int>> q;
     std::unordered_set<Vertex<Airport>*> visited;
 
@@ -295,10 +430,12 @@ std::unordered_set<std::string> Statistics::getReachableCountries(const std::str
         while (!q.empty()) {
             auto [v, stops] = q.front();
             q.pop();
+            INSTRUMENT_COUNT(VerticesDequeued, 1);
 
             if (stops <= maxStops) {
-                reachableCountries.insert(v->getInfo().getCountry());
+                countryIds.insert(v->getInfo().getCountryId());
 
+                INSTRUMENT_COUNT(EdgesScanned, v->getAdj().size());
                 for (const auto& e : v->getAdj()) {
                     Vertex<Airport>* w = e.getDest();
                     if (visited.find(w) == visited.end()) {
@@ -310,32 +447,118 @@ std::unordered_set<std::string> Statistics::getReachableCountries(const std::str
         }
     }
 
+    std::unordered_set<std::string> reachableCountries;
+    for (uint32_t id : countryIds) reachableCountries.insert(StringPool::global().get(id));
     return reachableCountries;
 }
 
+/**
+ * @brief Finds every airport from which a given airport can be reached within a maximum number of stops,
+ *        by a breadth-first search over the incoming routes.
+ * @param airportCode The destination airport code.
+ * @param maxStops The maximum number of layovers/stops.
+ * @return The airports' vertices, the destination included; empty if it does not exist.
+ * @note Time complexity: O(V + E) in the worst case, but only the airports found and their incoming routes are visited.
+ */
+std::vector<const Vertex<Airport>*> Statistics::findAirportsReaching(const std::string& airportCode, int maxStops) const {
+    INSTRUMENT_SCOPE(Reachable);
+    std::vector<const Vertex<Airport>*> found;
+    const Vertex<Airport>* target = airportGraph.findVertex(Airport(airportCode));
+    if (!target) return found;
+
+    std::vector<char> visited(airportGraph.getNumVertex(), false);
+    visited[target->getId()] = true;
+    found.push_back(target);
+    // found doubles as the queue; level boundaries count the stops
+    size_t levelStart = 0;
+    for (int stops = 0; stops < maxStops && levelStart < found.size(); stops++) {
+        size_t levelEnd = found.size();
+        for (size_t i = levelStart; i < levelEnd; i++) {
+            INSTRUMENT_COUNT(VerticesDequeued, 1);
+            INSTRUMENT_COUNT(EdgesScanned, found[i]->getIncoming().size());
+            for (const auto* source : found[i]->getIncoming()) {
+                if (!visited[source->getId()]) {
+                    visited[source->getId()] = true;
+                    found.push_back(source);
+                }
+            }
+        }
+        levelStart = levelEnd;
+    }
+    return found;
+}
+
+/**
+ * @brief Finds all airports from which a given airport can be reached within a maximum number of stops.
+ * @param airportCode The destination airport code.
+ * @param maxStops The maximum number of layovers/stops.
+ * @return A set of airport codes, the destination included.
+ * @note Time complexity: see findAirportsReaching().
+ */
+std::unordered_set<std::string> Statistics::getAirportsReaching(const std::string& airportCode, int maxStops) const {
+    std::unordered_set<std::string> airports;
+    for (const auto* vertex : findAirportsReaching(airportCode, maxStops)) airports.insert(vertex->getInfo().getCode());
+    return airports;
+}
+
+/**
+ * @brief Finds all cities from which a given airport can be reached within a maximum number of stops.
+ * @param airportCode The destination airport code.
+ * @param maxStops The maximum number of layovers/stops.
+ * @return A set of city names, the destination's included.
+ * @note Time complexity: see findAirportsReaching().
+ */
+std::unordered_set<std::string> Statistics::getCitiesReaching(const std::string& airportCode, int maxStops) const {
+    std::unordered_set<uint32_t> ids;
+    for (const auto* vertex : findAirportsReaching(airportCode, maxStops)) ids.insert(vertex->getInfo().getCityId());
+    std::unordered_set<std::string> cities;
+    for (uint32_t id : ids) cities.insert(StringPool::global().get(id));
+    return cities;
+}
+
+/**
+ * @brief Finds all countries from which a given airport can be reached within a maximum number of stops.
+ * @param airportCode The destination airport code.
+ * @param maxStops The maximum number of layovers/stops.
+ * @return A set of country names, the destination's included.
+ * @note Time complexity: see findAirportsReaching().
+ */
+std::unordered_set<std::string> Statistics::getCountriesReaching(const std::string& airportCode, int maxStops) const {
+    std::unordered_set<uint32_t> ids;
+    for (const auto* vertex : findAirportsReaching(airportCode, maxStops)) ids.insert(vertex->getInfo().getCountryId());
+    std::unordered_set<std::string> countries;
+    for (uint32_t id : ids) countries.insert(StringPool::global().get(id));
+    return countries;
+}
+
 
 
 
 /**
  * @brief Performs a depth-first search to identify the longest path in the graph.
  * @param vertex The current vertex being explored in the DFS.
- * @param visited A set to track visited airports during the DFS.
+ * @param visited The airports already entered by an earlier step of the search.
+ * @param onPath The airports on the path being explored.
  * @param path The current path being explored.
  * @param longestPaths A reference to store all the longest paths found.
  * @param maxLength The length of the longest path found so far.
- * @note This is a helper function for findLongestPath().
+ * @note This is a helper function for findLongestPath(). It keeps its marks in visited and onPath rather than
+ *       on the vertices, so the graph stays read-only and concurrent queries can share it.
  *       Time complexity: O(V*(V+E)) where V is the number of vertices and E is the number of edges.
  */
-void Statistics::dfs(Vertex<Airport>* vertex, std::unordered_set<std::string>& visited, std::vector<Airport>& path, std::vector<std::vector<Airport>>& longestPaths, int& maxLength) {
-    vertex->setProcessing(true);
+void Statistics::dfs(const Vertex<Airport>* vertex, std::unordered_set<const Vertex<Airport>*>& visited,
+                     std::unordered_set<const Vertex<Airport>*>& onPath, std::vector<Airport>& path,
+                     std::vector<std::vector<Airport>>& longestPaths, int& maxLength) const {
+    onPath.insert(vertex);
     path.push_back(vertex->getInfo());
 
     bool isEndpoint = true;
     for (const auto& edge : vertex->getAdj()) {
-        if (!edge.getDest()->isVisited() && !edge.getDest()->isProcessing()) {
+        const Vertex<Airport>* dest = edge.getDest();
+        if (!visited.count(dest) && !onPath.count(dest)) {
             isEndpoint = false;
-            edge.getDest()->setVisited(true);
-            dfs(edge.getDest(), visited, path, longestPaths, maxLength);
+            visited.insert(dest);
+            dfs(dest, visited, onPath, path, longestPaths, maxLength);
         }
     }
 
@@ -350,19 +573,7 @@ void Statistics::dfs(Vertex<Airport>* vertex, std::unordered_set<std::string>& v
     }
 
     path.pop_back();
-    vertex->setProcessing(false);
-}
-
-/**
- * @brief Resets the visited status of all vertices in a graph.
- * @param graph The graph whose vertices will have their visited status reset.
- * @note Time complexity: O(V) where V is the number of vertices.
- */
-void Statistics::resetVisited(Graph<Airport>& graph) {
-    for (auto* vertex : graph.getVertexSet()) {
-        vertex->setVisited(false);
-        vertex->setProcessing(false);
-    }
+    onPath.erase(vertex);
 }
 
 /**
@@ -370,15 +581,15 @@ void Statistics::resetVisited(Graph<Airport>& graph) {
  * @return A vector of vectors, each representing a path with the maximum length.
  * @note Time complexity: O(V*(V+E)) where V is the number of vertices and E is the number of edges.
  */
-std::vector<std::vector<Airport>> Statistics::findLongestPath() {
+std::vector<std::vector<Airport>> Statistics::findLongestPath() const {
+    INSTRUMENT_SCOPE(LongestPath);
     std::vector<std::vector<Airport>> longestPaths;
     int maxLength = 0;
-    std::unordered_set<std::string> visited;
+    std::unordered_set<const Vertex<Airport>*> visited, onPath;
 
-    for (auto* vertex : airportGraph.getVertexSet()) {
+    for (const auto* vertex : airportGraph.getVertexSet()) {
         std::vector<Airport> path;
-        visited.clear();
-        dfs(vertex, visited, path, longestPaths, maxLength);
+        dfs(vertex, visited, onPath, path, longestPaths, maxLength);
     }
 
     return longestPaths;
@@ -387,29 +598,34 @@ std::vector<std::vector<Airport>> Statistics::findLongestPath() {
 
 
 /**
- * @brief Finds the top-k airports based on the number of flights.
+ * @brief Finds the top-k airports based on the number of departing flights.
  * @param k The number of top airports to identify.
  * @return A vector of pairs (Airport, int), where each pair contains an airport and its flight count.
- * @note Time complexity: O(V log V + E) where V is the number of vertices (airports) and E is the number of edges (flights).
+ * @note Time complexity: see getTopKAirports().
  */
-std::vector<std::pair<Airport, int>> Statistics::getTopKAirportsByFlights(int k) {
-    std::vector<std::pair<Airport, int>> airportFlightCounts;
-
-    for (auto* vertex : airportGraph.getVertexSet()) {
-        int flightCount = vertex->getAdj().size();
-        airportFlightCounts.emplace_back(vertex->getInfo(), flightCount);
+std::vector<std::pair<Airport, int>> Statistics::getTopKAirportsByFlights(int k) const {
+    std::vector<std::pair<Airport, int>> topKAirports;
+    for (const auto& pair : getTopKAirports(RankingMetric::OutgoingFlights, k)) {
+        topKAirports.emplace_back(pair.first, pair.second);
     }
+    return topKAirports;
+}
 
-    std::sort(airportFlightCounts.begin(), airportFlightCounts.end(), [](const auto& a, const auto& b) {
-        return a.second > b.second;
-    });
-
-    if (k > airportFlightCounts.size()) {
-        k = airportFlightCounts.size();
+/**
+ * @brief Finds the top-k airports for a ranking metric.
+ * @param metric The metric to rank by.
+ * @param k The number of top airports to identify (clamped to the number of airports).
+ * @param maxStops Maximum number of stops, only used when ranking by reach.
+ * @return A vector of pairs (Airport, score), best first.
+ * @note Time complexity: O(k) when the metric is tracked by the live ranking, O(V + k log k) otherwise,
+ *       and O(V * (V + E)) for the reach.
+ */
+std::vector<std::pair<Airport, long>> Statistics::getTopKAirports(RankingMetric metric, int k, int maxStops) const {
+    INSTRUMENT_SCOPE(TopKAirports);
+    if (liveRanking && liveRanking->isTracked(metric)) {
+        return liveRanking->liveTopK(metric, k);
     }
-
-    std::vector<std::pair<Airport, int>> topKAirports(airportFlightCounts.begin(), airportFlightCounts.begin() + k);
-    return topKAirports;
+    return Ranking(airportGraph).topK(metric, k, maxStops);
 }
 
 
@@ -428,7 +644,7 @@ void Statistics::findArticulationPoints(Vertex<Airport>* v, int& time,
                                         std::unordered_map<Airport, int, AirportHash, AirportEqual>& disc,
                                         std::unordered_map<Airport, int, AirportHash, AirportEqual>& low,
                                         std::unordered_map<Airport, Vertex<Airport>*, AirportHash, AirportEqual>& parent,
-                                        std::unordered_set<Airport, AirportHash, AirportEqual>& articulationPoints) {
+                                        std::unordered_set<Airport, AirportHash, AirportEqual>& articulationPoints) const {
     int children = 0;
     v->setVisited(true);
     disc[v->getInfo()] = low[v->getInfo()] = ++time;
@@ -460,7 +676,8 @@ void Statistics::findArticulationPoints(Vertex<Airport>* v, int& time,
  * @return A set of essential airports.
  * @note Time complexity: O(V + E) where V is the number of vertices and E is the number of edges.
  */
-std::unordered_set<Airport, AirportHash, AirportEqual> Statistics::findEssentialAirports() {
+std::unordered_set<Airport, AirportHash, AirportEqual> Statistics::findEssentialAirports() const {
+    INSTRUMENT_SCOPE(EssentialAirports);
     Graph<Airport> undirectedGraph = createUndirectedCopy(airportGraph);
     std::unordered_set<Airport, AirportHash, AirportEqual> articulationPoints;
     std::unordered_map<Airport, int, AirportHash, AirportEqual> disc, low;
@@ -491,7 +708,7 @@ std::unordered_set<Airport, AirportHash, AirportEqual> Statistics::findEssential
  * @return An undirected copy of the input graph.
  * @note Time complexity: O(V + E) where V is the number of vertices and E is the number of edges.
  */
-Graph<Airport> Statistics::createUndirectedCopy(const Graph<Airport>& directedGraph) {
+Graph<Airport> Statistics::createUndirectedCopy(const Graph<Airport>& directedGraph) const {
     Graph<Airport> undirectedGraph;
 
     for (auto* vertex : directedGraph.getVertexSet()) {
@@ -506,3 +723,308 @@ Graph<Airport> Statistics::createUndirectedCopy(const Graph<Airport>& directedGr
     return undirectedGraph;
 }
 
+
+
+
+
+/**
+ * @brief Gets the sizes of the strongly connected components of the airport graph.
+ * @return The number of airports in each component, largest first.
+ * @note Time complexity: O(V + E + C log C) where C is the number of components.
+ */
+std::vector<int> Statistics::getComponentSizes() const {
+    Condensation condensation(airportGraph);
+    std::vector<int> sizes = condensation.getComponentSizes();
+    std::sort(sizes.begin(), sizes.end(), [](int a, int b) { return a > b; });
+    return sizes;
+}
+
+/**
+ * @brief Gets how many strongly connected components there are of each size.
+ * @return A map where the key is the component size and the value is the number of components with that size.
+ * @note Time complexity: O(V + E + C log C) where C is the number of components.
+ */
+std::map<int, long> Statistics::getComponentSizeDistribution() const {
+    std::map<int, long> distribution;
+    for (int size : getComponentSizes()) {
+        distribution[size]++;
+    }
+    return distribution;
+}
+
+
+
+
+/**
+ * @brief Computes every per-city, per-airline, per-country and per-airport flight count in a single pass.
+ *
+ * The flights are split across threads; each thread fills its own histograms and they are
+ * merged once every thread is done.
+ *
+ * @param threads Number of threads (values below 1 use all hardware threads); at most one per hardware thread
+ *        and per flight are used, since each has histograms of its own.
+ * @return The report with every aggregate.
+ * @note Time complexity: O(F / T + T * (C + A + N + V + G)) where F is the number of flights, T the number of threads,
+ *       C, A, N and V the number of cities, airlines, countries and airports, and G the number of pair groups.
+ */
+Statistics::Report Statistics::computeAll(int threads) const {
+    INSTRUMENT_SCOPE(ComputeAll);
+    INSTRUMENT_COUNT(FlightsInspected, flightTable.size());
+    struct Partial {
+        std::vector<long> city, airline, country, from, to;
+        PairHistogram cityAirline, countryAirline;
+    };
+
+    const FlightTable& t = flightTable;
+    size_t numCities = t.cities.size(), numAirlines = t.airlines.size();
+    size_t numCountries = t.countries.size(), numAirports = t.airports.size();
+    if (threads < 1) threads = Parallel::defaultThreads();
+    threads = (int) std::min<size_t>({(size_t) threads, (size_t) Parallel::defaultThreads(), std::max<size_t>(1, t.size())});
+    size_t rowsPerThread = t.size() / threads + 1;
+
+    std::vector<Partial> partials;
+    for (int i = 0; i < threads; i++) {
+        partials.push_back({std::vector<long>(numCities, 0), std::vector<long>(numAirlines, 0),
+                            std::vector<long>(numCountries, 0), std::vector<long>(numAirports, 0),
+                            std::vector<long>(numAirports, 0),
+                            PairHistogram(numCities, numAirlines, rowsPerThread),
+                            PairHistogram(numCountries, numAirlines, rowsPerThread)});
+    }
+
+    int used = Parallel::forRange(t.size(), threads, [&](size_t begin, size_t end, int thread) {
+        Partial& p = partials[thread];
+        for (size_t i = begin; i < end; i++) {
+            p.city[t.sourceCity[i]]++;
+            p.airline[t.airline[i]]++;
+            p.country[t.sourceCountry[i]]++;
+            p.from[t.source[i]]++;
+            p.to[t.target[i]]++;
+            p.cityAirline.add(t.sourceCity[i], t.airline[i]);
+            p.countryAirline.add(t.sourceCountry[i], t.airline[i]);
+        }
+    });
+
+    Partial& total = partials[0];
+    for (int i = 1; i < used; i++) {
+        const Partial& p = partials[i];
+        for (size_t k = 0; k < numCities; k++) total.city[k] += p.city[k];
+        for (size_t k = 0; k < numAirlines; k++) total.airline[k] += p.airline[k];
+        for (size_t k = 0; k < numCountries; k++) total.country[k] += p.country[k];
+        for (size_t k = 0; k < numAirports; k++) total.from[k] += p.from[k];
+        for (size_t k = 0; k < numAirports; k++) total.to[k] += p.to[k];
+        total.cityAirline.merge(p.cityAirline);
+        total.countryAirline.merge(p.countryAirline);
+    }
+
+    Report report;
+    report.totalFlights = t.size();
+    report.flightsPerCity = std::move(total.city);
+    report.flightsPerAirline = std::move(total.airline);
+    report.flightsPerCountry = std::move(total.country);
+    report.flightsFromAirport = std::move(total.from);
+    report.flightsToAirport = std::move(total.to);
+    report.flightsPerCityAirline = total.cityAirline.groups();
+    report.flightsPerCountryAirline = total.countryAirline.groups();
+    return report;
+}
+
+/**
+ * @brief Times computeAll() against the individual report calls it replaces, for an increasing number of threads.
+ * @param maxThreads Largest number of threads to try, clamped as in computeAll(); thread counts double from 1 up to it.
+ * @return One timing per thread count. Each time is the best of a few runs, in milliseconds.
+ * @note Time complexity: O(R * log(T) * (F + G)) for R runs, where F is the number of flights and G the number of groups.
+ */
+std::vector<Statistics::Timing> Statistics::benchmarkComputeAll(int maxThreads) const {
+    const int runs = 3;
+    auto elapsedMs = [](std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    double individualMs = std::numeric_limits<double>::max();
+    for (int run = 0; run < runs; run++) {
+        auto start = std::chrono::steady_clock::now();
+        getNumberOfFlightsPerCityAirline();
+        getNumberOfFlightsPerCity();
+        getNumberOfFlightsPerAirline();
+        getNumberOfFlightsPerCountryAirline();
+        for (int airport = 0; airport < flightTable.airports.size(); airport++) {
+            getNumberOfFlightsFromAirport(flightTable.airports.get(airport));
+            getNumberOfFlightsToAirport(flightTable.airports.get(airport));
+        }
+        individualMs = std::min(individualMs, elapsedMs(start));
+    }
+
+    // computeAll() uses no more threads than this, so larger counts would only repeat its timing
+    maxThreads = (int) std::min<size_t>({(size_t) std::max(1, maxThreads), (size_t) Parallel::defaultThreads(),
+                                         std::max<size_t>(1, flightTable.size())});
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads = threads > maxThreads / 2 ? maxThreads : threads * 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    std::vector<Timing> timings;
+    for (int threads : threadCounts) {
+        double fusedMs = std::numeric_limits<double>::max();
+        for (int run = 0; run < runs; run++) {
+            auto start = std::chrono::steady_clock::now();
+            computeAll(threads);
+            fusedMs = std::min(fusedMs, elapsedMs(start));
+        }
+        timings.push_back({threads, fusedMs, individualMs});
+    }
+    return timings;
+}
+
+/**
+ * @brief Gets the columnar flight table the reports are computed on, to translate report ids into names.
+ * @return The flight table.
+ * @note Time complexity: O(1)
+ */
+const FlightTable& Statistics::getFlightTable() const {
+    return flightTable;
+}
+
+
+
+
+/**
+ * @brief Estimates, for every airport at once, how many airports, cities and countries it reaches within a number of stops.
+ * @param maxStops The maximum number of layovers/stops.
+ * @return The HyperLogLog sketches, queried per airport (vertex) id.
+ * @note Time complexity: O(k * (V + E) * m / T) for k stops, m registers per sketch and T threads.
+ */
+ReachSketches Statistics::estimateReach(int maxStops) const {
+    INSTRUMENT_SCOPE(ReachSketches);
+    return ReachSketches(engine.getDenseGraph(), flightTable, maxStops);
+}
+
+/**
+ * @brief Compares the HyperLogLog reach estimates with exact searches.
+ * @param maxStops The maximum number of layovers/stops.
+ * @param samples Number of airports, evenly spread over the vertex set, to run the exact searches for.
+ * @return The relative errors on the sample and the time taken by each method. Sampled airports that reach
+ *         nothing of a kind are left out of its errors; nothing is sampled if maxStops is negative.
+ * @note Time complexity: O(S * (V + E)) for the exact searches on S samples, plus estimateReach().
+ */
+Statistics::ReachAccuracy Statistics::compareReachEstimates(int maxStops, int samples) const {
+    ReachAccuracy accuracy = {maxStops, 0, {0, 0, 0}, {0, 0, 0}, 0, 0, 0};
+    if (maxStops < 0) return accuracy;
+    auto elapsedMs = [](std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    ReachSketches sketches = estimateReach(maxStops);
+    accuracy.sketchMs = elapsedMs(start);
+
+    int n = airportGraph.getNumVertex();
+    samples = std::max(0, std::min(samples, n));
+    if (samples == 0) return accuracy;
+
+    std::vector<double> exact[3];
+    std::vector<int> sampled;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < samples; i++) {
+        int airport = (long) i * n / samples;
+        const std::string code = airportGraph.getVertexSet()[airport]->getInfo().getCode();
+        sampled.push_back(airport);
+        exact[ReachSketches::Airports].push_back(getReachableAirports(code, maxStops).size());
+        exact[ReachSketches::Cities].push_back(getReachableCities(code, maxStops).size());
+        exact[ReachSketches::Countries].push_back(getReachableCountries(code, maxStops).size());
+    }
+    accuracy.exactMs = elapsedMs(start);
+    accuracy.exactAllMs = accuracy.exactMs * n / samples;
+    accuracy.samples = samples;
+
+    for (int kind = 0; kind < 3; kind++) {
+        int counted = 0;
+        for (int i = 0; i < samples; i++) {
+            if (exact[kind][i] == 0) continue;  // no relative error to speak of
+            double estimate = sketches.estimate(sampled[i], (ReachSketches::Kind) kind);
+            double error = std::abs(estimate - exact[kind][i]) / exact[kind][i];
+            accuracy.meanError[kind] += error;
+            accuracy.maxError[kind] = std::max(accuracy.maxError[kind], error);
+            counted++;
+        }
+        if (counted > 0) accuracy.meanError[kind] /= counted;
+    }
+    return accuracy;
+}
+
+
+
+
+/**
+ * @brief Finds the top-k airports by betweenness centrality, i.e. the airports most shortest routes go through.
+ * @param k The number of top airports to identify (clamped to the number of airports).
+ * @param pivots Number of sampled source airports for an approximate result; 0 (or at least the number of airports) for the exact one.
+ * @return A vector of pairs (Airport, betweenness), best first.
+ * @note Time complexity: O(V * E / T) exact, O(P * E / T) with P pivots, using T hardware threads.
+ */
+std::vector<std::pair<Airport, double>> Statistics::getTopKAirportsByBetweenness(int k, int pivots) const {
+    INSTRUMENT_SCOPE(Betweenness);
+    std::vector<double> scores = pivots > 0 ? Centrality::approximateBetweenness(engine.getDenseGraph(), pivots)
+                                            : Centrality::betweenness(engine.getDenseGraph());
+    return topKByScore(scores, k);
+}
+
+/**
+ * @brief Finds the top-k airports by flight-weighted PageRank.
+ * @param k The number of top airports to identify (clamped to the number of airports).
+ * @return A vector of pairs (Airport, PageRank), best first.
+ * @note Time complexity: O(I * (V + E) / T) for I iterations and T hardware threads.
+ */
+std::vector<std::pair<Airport, double>> Statistics::getTopKAirportsByPageRank(int k) const {
+    INSTRUMENT_SCOPE(PageRank);
+    return topKByScore(PageRank::compute(engine.getDenseGraph()).scores, k);
+}
+
+/**
+ * @brief Finds the destinations most related to an airport, by PageRank personalised to it.
+ * @param airportCode The airport code.
+ * @param k The number of destinations to identify.
+ * @return A vector of pairs (Airport, score), best first, without the airport itself. Empty if the airport does not exist.
+ * @note Time complexity: O(I * (V + E) / T) for I iterations and T hardware threads.
+ */
+std::vector<std::pair<Airport, double>> Statistics::getRelatedDestinations(const std::string& airportCode, int k) const {
+    INSTRUMENT_SCOPE(PageRank);
+    const auto* airportVertex = airportGraph.findVertex(Airport(airportCode));
+    if (!airportVertex) return {};
+    int source = airportVertex->getId();
+    return topKByScore(PageRank::personalized(engine.getDenseGraph(), source).scores, k, source);
+}
+
+/**
+ * @brief Reports the bytes held by the graph and by every index of the query engine.
+ * @return The report, by component.
+ * @note Time complexity: O(V + F + S) where S is the number of strings held by the indexes.
+ */
+MemoryReport Statistics::getMemoryReport() const {
+    return engine.memoryReport();
+}
+
+/**
+ * @brief Selects the k airports with the highest scores.
+ * @param scores A score per vertex id.
+ * @param k The number of airports (clamped to the number of airports).
+ * @param exclude Vertex id to leave out, or -1.
+ * @return A vector of pairs (Airport, score), best first.
+ * @note Time complexity: O(V log k)
+ */
+std::vector<std::pair<Airport, double>> Statistics::topKByScore(const std::vector<double>& scores, int k, int exclude) const {
+    std::vector<int> ids;
+    for (size_t v = 0; v < scores.size(); v++) {
+        if ((int) v != exclude) ids.push_back(v);
+    }
+    size_t count = std::min<size_t>(std::max(k, 0), ids.size());
+    std::partial_sort(ids.begin(), ids.begin() + count, ids.end(), [&](int a, int b) {
+        return scores[a] > scores[b];
+    });
+
+    std::vector<std::pair<Airport, double>> top;
+    for (size_t i = 0; i < count; i++) {
+        top.emplace_back(engine.getDenseGraph().vertices[ids[i]]->getInfo(), scores[ids[i]]);
+    }
+    return top;
+}
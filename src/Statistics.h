@@ -5,29 +5,82 @@
 #include "Airport.h"
 #include "Airline.h"
 #include "Flight.h"
+#include "Condensation.h"
+#include "FlightTable.h"
+#include "Aggregation.h"
+#include "GeoIndex.h"
+#include "Ranking.h"
+#include "DenseGraph.h"
+#include "QueryEngine.h"
+#include "ReachSketches.h"
+#include "Centrality.h"
+#include "PageRank.h"
 #include <unordered_set>
+#include <unordered_map>
 #include <string>
 #include <map>
+#include <algorithm>
 
 class Statistics {
 
+public:
+    // Every per-city, per-airline, per-country and per-airport flight count, filled by computeAll().
+    // City, airline and country ids are those of getFlightTable(); airport ids are vertex ids.
+    struct Report {
+        long totalFlights = 0;
+        std::vector<long> flightsPerCity;
+        std::vector<long> flightsPerAirline;
+        std::vector<long> flightsPerCountry;
+        std::vector<long> flightsFromAirport;
+        std::vector<long> flightsToAirport;
+        std::vector<Aggregation::PairCount> flightsPerCityAirline;
+        std::vector<Aggregation::PairCount> flightsPerCountryAirline;
+    };
+
+    // Accuracy and cost of the HyperLogLog reach estimates against exact searches on a sample of airports
+    struct ReachAccuracy {
+        int maxStops;
+        int samples;
+        double meanError[3];  // mean relative error per ReachSketches::Kind
+        double maxError[3];   // worst relative error per ReachSketches::Kind
+        double sketchMs;      // building the sketches of every airport
+        double exactMs;       // exact searches for the sampled airports
+        double exactAllMs;    // exact searches extrapolated to every airport
+    };
+
+    // Narrowest distance bucket: about 200000 buckets up to the longest great-circle distance
+    static constexpr double MinBucketKm = 0.1;
+
+    struct Timing {
+        int threads;
+        double fusedMs;       // one computeAll() call
+        double individualMs;  // the equivalent individual report calls
+    };
+
 private:
-    Graph<Airport>& airportGraph;
-    std::unordered_set<Airline>& airlines;
+    const QueryEngine& engine;
+    const Graph<Airport>& airportGraph;
+    const std::unordered_set<Airline>& airlines;
+    const FlightTable& flightTable;
+    const GeoIndex& geoIndex;
+    const Ranking* liveRanking;
 
     //AUX FUNCTIONS
-    void resetVisited(Graph<Airport>& graph);
-    void dfs(Vertex<Airport>* vertex, std::unordered_set<std::string>& visited, std::vector<Airport>& path, std::vector<std::vector<Airport>>& longestPaths, int& maxLength);
+    std::vector<const Vertex<Airport>*> findAirportsReaching(const std::string& airportCode, int maxStops) const;
+    std::vector<std::pair<Airport, double>> topKByScore(const std::vector<double>& scores, int k, int exclude = -1) const;
+    void dfs(const Vertex<Airport>* vertex, std::unordered_set<const Vertex<Airport>*>& visited,
+             std::unordered_set<const Vertex<Airport>*>& onPath, std::vector<Airport>& path,
+             std::vector<std::vector<Airport>>& longestPaths, int& maxLength) const;
     void findArticulationPoints(Vertex<Airport>* v, int& time,
                                 std::unordered_map<Airport, int, AirportHash, AirportEqual>& disc,
                                 std::unordered_map<Airport, int, AirportHash, AirportEqual>& low,
                                 std::unordered_map<Airport, Vertex<Airport>*, AirportHash, AirportEqual>& parent,
-                                std::unordered_set<Airport, AirportHash, AirportEqual>& articulationPoints);
-    Graph<Airport> createUndirectedCopy(const Graph<Airport>& directedGraph);
+                                std::unordered_set<Airport, AirportHash, AirportEqual>& articulationPoints) const;
+    Graph<Airport> createUndirectedCopy(const Graph<Airport>& directedGraph) const;
 
 
 public:
-    Statistics(Graph<Airport>& airportGraph, std::unordered_set<Airline>& airlines);
+    explicit Statistics(const QueryEngine& engine);
 
     // Method declarations
     //I
@@ -36,24 +89,51 @@ public:
     //II
     long getNumberOfFlightsFromAirport(const std::string& airportCode) const;
     long getNumberOfUniqueAirlinesFromAirport(const std::string& airportCode) const;
+    long getNumberOfFlightsToAirport(const std::string& airportCode) const;
+    long getNumberOfUniqueAirlinesToAirport(const std::string& airportCode) const;
+    std::vector<std::string> getAirportsWithFlightsTo(const std::string& airportCode) const;
     //III
     std::map<std::pair<std::string, std::string>, long> getNumberOfFlightsPerCityAirline() const;
     std::map<std::string, long> getNumberOfFlightsPerCity() const;
     std::map<std::string, long> getNumberOfFlightsPerAirline() const;
+    std::map<std::pair<std::string, std::string>, long> getNumberOfFlightsPerCountryAirline() const;
+    std::map<double, long> getNumberOfFlightsPerDistance(double bucketKm) const;
     //IV
     long getNumberOfDiffCountriesByAirport(const std::string& airportCode) const;
+    long getNumberOfDiffCountriesToAirport(const std::string& airportCode) const;
     long getNumberOfDiffCountriesByCity(const std::string& city) const;
+    std::vector<std::string> getCountriesReachableFromCountry(const std::string& country) const;
     //V
     std::unordered_set<std::string> getReachableAirports(const std::string& airportCode, int maxStops) const;
     std::unordered_set<std::string> getReachableCities(const std::string& airportCode, int maxStops) const;
     std::unordered_set<std::string> getReachableCountries(const std::string& airportCode, int maxStops) const;
+    std::unordered_set<std::string> getAirportsReaching(const std::string& airportCode, int maxStops) const;
+    std::unordered_set<std::string> getCitiesReaching(const std::string& airportCode, int maxStops) const;
+    std::unordered_set<std::string> getCountriesReaching(const std::string& airportCode, int maxStops) const;
     //VI
-    std::vector<std::vector<Airport>> findLongestPath();
+    std::vector<std::vector<Airport>> findLongestPath() const;
     //VII
-    std::vector<std::pair<Airport, int>> getTopKAirportsByFlights(int k);
+    std::vector<std::pair<Airport, int>> getTopKAirportsByFlights(int k) const;
+    std::vector<std::pair<Airport, long>> getTopKAirports(RankingMetric metric, int k, int maxStops = 1) const;
     //VIII
-    std::unordered_set<Airport, AirportHash, AirportEqual> findEssentialAirports();
-
+    std::unordered_set<Airport, AirportHash, AirportEqual> findEssentialAirports() const;
+    //IX
+    std::vector<int> getComponentSizes() const;
+    std::map<int, long> getComponentSizeDistribution() const;
+    //X
+    Report computeAll(int threads) const;
+    std::vector<Timing> benchmarkComputeAll(int maxThreads) const;
+    const FlightTable& getFlightTable() const;
+    //XI
+    ReachSketches estimateReach(int maxStops) const;
+    ReachAccuracy compareReachEstimates(int maxStops, int samples) const;
+    //XII
+    std::vector<std::pair<Airport, double>> getTopKAirportsByBetweenness(int k, int pivots = 0) const;
+    //XIII
+    std::vector<std::pair<Airport, double>> getTopKAirportsByPageRank(int k) const;
+    std::vector<std::pair<Airport, double>> getRelatedDestinations(const std::string& airportCode, int k) const;
+    //XIV
+    MemoryReport getMemoryReport() const;
 };
 
 #endif // STATISTICS_H
\ No newline at end of file
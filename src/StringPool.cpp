@@ -0,0 +1,74 @@
+#include "StringPool.h"
+
+/**
+ * @brief Gets the pool shared by every airport of every loaded dataset.
+ * @return The pool.
+ */
+StringPool& StringPool::global() {
+    static StringPool pool;
+    return pool;
+}
+
+StringPool::StringPool() : count(0) {
+    for (auto& block : blocks) block.store(nullptr, std::memory_order_relaxed);
+    intern("");
+}
+
+StringPool::~StringPool() {
+    for (auto& block : blocks) delete[] block.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Gets the id of a string, storing it first if the pool does not have it yet.
+ * @param value The string.
+ * @return Its id; 0 (the empty string) once the pool is full.
+ * @note Time complexity: O(L) on average where L is the length of the string.
+ */
+uint32_t StringPool::intern(const std::string& value) {
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = ids.find(&value);
+    if (it != ids.end()) return it->second;
+
+    uint32_t id = count.load(std::memory_order_relaxed);
+    size_t blockIndex = id >> BlockBits;
+    if (blockIndex >= MaxBlocks) return 0;
+    std::string* block = blocks[blockIndex].load(std::memory_order_relaxed);
+    if (block == nullptr) {
+        block = new std::string[BlockSize];
+        blocks[blockIndex].store(block, std::memory_order_release);
+        bytes += BlockSize * sizeof(std::string);
+    }
+    std::string& slot = block[id & (BlockSize - 1)];
+    slot = value;
+    if (slot.capacity() > 15) bytes += slot.capacity() + 1;  // longer than the inline buffer
+    ids.emplace(&slot, id);
+    count.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+/**
+ * @brief Gets an interned string.
+ * @param id An id returned by intern().
+ * @return The string, valid for the life of the process.
+ * @note Time complexity: O(1)
+ */
+const std::string& StringPool::get(uint32_t id) const {
+    return blocks[id >> BlockBits].load(std::memory_order_acquire)[id & (BlockSize - 1)];
+}
+
+/**
+ * @brief Gets the number of distinct strings interned, the empty string included.
+ * @return The number of strings.
+ */
+size_t StringPool::size() const {
+    return count.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Gets the memory taken by the blocks and the interned strings, not counting the lookup table.
+ * @return The number of bytes.
+ */
+size_t StringPool::getBytes() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return bytes;
+}
@@ -0,0 +1,53 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief Process-wide pool of interned strings, each stored once and named by a dense id.
+ *
+ * Airports keep the ids of their name, city and country instead of the strings, so equal names
+ * share one copy and comparing them is comparing integers. Id 0 is the empty string.
+ *
+ * Strings are stored in fixed-size blocks that never move, so get() returns a reference that
+ * stays valid for the life of the process and takes no lock; intern() takes one. Nothing is
+ * ever removed: reloading a dataset with the same names interns nothing new.
+ */
+class StringPool {
+public:
+    static StringPool& global();
+
+    uint32_t intern(const std::string& value);
+    const std::string& get(uint32_t id) const;
+    size_t size() const;
+    size_t getBytes() const;
+
+private:
+    static const size_t BlockBits = 12;
+    static const size_t BlockSize = size_t(1) << BlockBits;
+    static const size_t MaxBlocks = 4096;  // 16M strings
+
+    struct Hash {
+        size_t operator()(const std::string* value) const { return std::hash<std::string>()(*value); }
+    };
+    struct Equal {
+        bool operator()(const std::string* a, const std::string* b) const { return *a == *b; }
+    };
+
+    StringPool();
+    ~StringPool();
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    std::atomic<std::string*> blocks[MaxBlocks];
+    std::atomic<uint32_t> count;
+    size_t bytes = 0;
+    std::unordered_map<const std::string*, uint32_t, Hash, Equal> ids;  // keys point into the blocks
+    mutable std::mutex lock;                                             // held by intern()
+};
+
+#endif // STRINGPOOL_H
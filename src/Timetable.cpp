@@ -0,0 +1,303 @@
+#include "Timetable.h"
+#include "Instrumentation.h"
+#include "MemoryReport.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <limits>
+
+namespace {
+
+const int Never = std::numeric_limits<int>::max();
+const int MinutesPerDay = 24 * 60;
+
+}
+
+/**
+ * @brief Constructor: an empty timetable over the airports of a graph.
+ * @param graph The graph whose vertex ids identify the airports; it must outlive the timetable.
+ */
+Timetable::Timetable(const Graph<Airport>& graph) : graph(&graph) {
+    for (const auto* vertex : graph.getVertexSet()) vertices.push_back(vertex);
+    minConnection.assign(vertices.size(), -1);
+}
+
+/**
+ * @brief Adds a scheduled departure; build() must be called before the next query.
+ * @param source Code of the departure airport.
+ * @param target Code of the arrival airport.
+ * @param airline Code of the airline.
+ * @param departure Departure time, in minutes from the start of the timetable.
+ * @param arrival Arrival time, after the departure.
+ * @return False if an airport is unknown or the times are not valid.
+ * @note Time complexity: O(1) on average.
+ */
+bool Timetable::addConnection(const std::string& source, const std::string& target, const std::string& airline, int departure, int arrival) {
+    if (graph == nullptr || departure < 0 || arrival <= departure) return false;
+    const auto* from = graph->findVertex(Airport(source));
+    const auto* to = graph->findVertex(Airport(target));
+    if (from == nullptr || to == nullptr || from == to) return false;
+    connections.push_back({departure, arrival, from->getId(), to->getId(), airlines.intern(airline)});
+    return true;
+}
+
+/**
+ * @brief Sets the minimum time between arriving at an airport and boarding another flight there.
+ * @param airport Code of the airport.
+ * @param minutes The minimum connection time.
+ * @return False if the airport is unknown or the time is negative.
+ * @note Time complexity: O(1) on average.
+ */
+bool Timetable::setMinConnectionTime(const std::string& airport, int minutes) {
+    if (graph == nullptr || minutes < 0) return false;
+    const auto* vertex = graph->findVertex(Airport(airport));
+    if (vertex == nullptr) return false;
+    if ((size_t) vertex->getId() >= minConnection.size()) minConnection.resize(vertex->getId() + 1, -1);
+    minConnection[vertex->getId()] = minutes;
+    return true;
+}
+
+/**
+ * @brief Sets the minimum connection time of the airports without one of their own.
+ * @param minutes The minimum connection time; negative values are ignored.
+ */
+void Timetable::setDefaultMinConnectionTime(int minutes) {
+    if (minutes >= 0) defaultMinConnection = minutes;
+}
+
+/**
+ * @brief Sorts the connections by departure time, arrival time breaking ties.
+ * @note Time complexity: O(C log C) where C is the number of connections.
+ */
+void Timetable::build() {
+    std::sort(connections.begin(), connections.end(), [](const Connection& a, const Connection& b) {
+        return a.departure != b.departure ? a.departure < b.departure : a.arrival < b.arrival;
+    });
+}
+
+size_t Timetable::size() const {
+    return connections.size();
+}
+
+bool Timetable::empty() const {
+    return connections.empty();
+}
+
+/**
+ * @brief Gets the minimum connection time of an airport.
+ * @param airport Vertex id of the airport.
+ * @return Its own minimum connection time, or the default one.
+ * @note Time complexity: O(1)
+ */
+int Timetable::getMinConnectionTime(int airport) const {
+    if ((size_t) airport < minConnection.size() && minConnection[airport] >= 0) return minConnection[airport];
+    return defaultMinConnection;
+}
+
+/**
+ * @brief Gets the heap bytes of the connection array, the airline dictionary and the connection times.
+ * @return The number of bytes.
+ */
+size_t Timetable::getBytes() const {
+    return MemoryReport::bytesOf(vertices) + MemoryReport::bytesOf(connections) + airlines.getBytes()
+           + MemoryReport::bytesOf(minConnection);
+}
+
+/**
+ * @brief Finds the journey reaching one of the targets earliest, leaving one of the sources no earlier than a given time.
+ *        Changing planes at an airport takes at least its minimum connection time.
+ * @param sources Vertex ids of the airports the journey may start from.
+ * @param targets Vertex ids of the airports it may end at.
+ * @param departAfter Earliest departure, in minutes from the start of the timetable.
+ * @return The journey, with no legs if no target can be reached (or a source is a target).
+ * @note Time complexity: O(V + log C + S) where S is the number of connections departing between departAfter
+ *       and the arrival found (all of the rest of the timetable if there is none).
+ */
+Timetable::Journey Timetable::earliestArrival(const std::vector<int>& sources, const std::vector<int>& targets, int departAfter) const {
+    INSTRUMENT_SCOPE(EarliestArrival);
+    Journey journey = {departAfter, departAfter, {}};
+    int n = vertices.size();
+    std::vector<int> ready(n, Never);  // earliest time a passenger can board at each airport
+    std::vector<int> via(n, -1);       // connection arriving there at that time
+    std::vector<char> isTarget(n, false), isSource(n, false);
+    for (int target : targets) isTarget[target] = true;
+    for (int source : sources) {
+        if (isTarget[source]) return journey;
+        ready[source] = departAfter;
+        isSource[source] = true;
+    }
+
+    int bestArrival = Never, best = -1;
+    auto first = std::lower_bound(connections.begin(), connections.end(), departAfter, [](const Connection& c, int time) {
+        return c.departure < time;
+    }) - connections.begin();
+    int scanned = 0;
+    for (int i = first; i < (int) connections.size(); i++) {
+        const Connection& c = connections[i];
+        // Arrivals come after departures, so nothing departing later can arrive earlier
+        if (c.departure >= bestArrival) break;
+        scanned++;
+        if (ready[c.from] > c.departure) continue;
+        if (isTarget[c.to] && c.arrival < bestArrival) {
+            bestArrival = c.arrival;
+            best = i;
+        }
+        int boarding = c.arrival + getMinConnectionTime(c.to);
+        if (boarding < ready[c.to]) {
+            ready[c.to] = boarding;
+            via[c.to] = i;
+        }
+    }
+    INSTRUMENT_COUNT(ConnectionsScanned, scanned);
+    if (best < 0) return journey;
+
+    for (int i = best; i >= 0; i = isSource[connections[i].from] ? -1 : via[connections[i].from]) {
+        journey.legs.push_back(toLeg(i));
+    }
+    std::reverse(journey.legs.begin(), journey.legs.end());
+    journey.departure = journey.legs.front().departure;
+    journey.arrival = journey.legs.back().arrival;
+    return journey;
+}
+
+/**
+ * @brief Finds, for a window of departure times, every journey that no other one beats: for each departure
+ *        from one of the sources within the window, the earliest arrival at one of the targets, keeping only
+ *        the journeys that no later departure reaches as early.
+ * @param sources Vertex ids of the airports the journeys may start from.
+ * @param targets Vertex ids of the airports they may end at.
+ * @param from Earliest departure, in minutes from the start of the timetable.
+ * @param until Latest departure.
+ * @return The journeys by increasing departure (and so increasing arrival).
+ * @note Time complexity: O(V + C log C) where C is the number of connections departing from the start of the window on.
+ */
+std::vector<Timetable::Journey> Timetable::profile(const std::vector<int>& sources, const std::vector<int>& targets, int from, int until) const {
+    INSTRUMENT_SCOPE(JourneyProfile);
+    std::vector<Journey> journeys;
+    if (until < from) return journeys;
+    int n = vertices.size();
+    std::vector<char> isTarget(n, false);
+    for (int target : targets) isTarget[target] = true;
+
+    // profiles[a]: by decreasing departure and so decreasing arrival
+    std::vector<std::vector<ProfileEntry>> profiles(n);
+    auto first = std::lower_bound(connections.begin(), connections.end(), from, [](const Connection& c, int time) {
+        return c.departure < time;
+    }) - connections.begin();
+    for (int i = (int) connections.size() - 1; i >= first; i--) {
+        const Connection& c = connections[i];
+        int next;
+        int arrival = arrivalFrom(profiles[c.to], c.arrival + getMinConnectionTime(c.to), next);
+        if (isTarget[c.to]) arrival = std::min(arrival, c.arrival);
+        if (arrival == Never) continue;
+
+        auto& profile = profiles[c.from];
+        if (!profile.empty() && profile.back().arrival <= arrival) continue;
+        if (!profile.empty() && profile.back().departure == c.departure) profile.back() = {c.departure, arrival, i};
+        else profile.push_back({c.departure, arrival, i});
+    }
+    INSTRUMENT_COUNT(ConnectionsScanned, connections.size() - first);
+
+    std::vector<ProfileEntry> front;
+    for (int source : sources) {
+        if (isTarget[source]) continue;
+        for (const auto& entry : profiles[source]) {
+            if (entry.departure <= until) front.push_back(entry);
+        }
+    }
+    std::sort(front.begin(), front.end(), [](const ProfileEntry& a, const ProfileEntry& b) {
+        return a.departure != b.departure ? a.departure > b.departure : a.arrival < b.arrival;
+    });
+
+    int bestArrival = Never;
+    for (const auto& entry : front) {
+        if (entry.arrival >= bestArrival) continue;
+        bestArrival = entry.arrival;
+        Journey journey = {entry.departure, entry.arrival, {}};
+        // Follow the connections that reached the entry's arrival; the profiles they were read from have not changed since
+        for (int i = entry.connection; i >= 0;) {
+            const Connection& c = connections[i];
+            journey.legs.push_back(toLeg(i));
+            if (isTarget[c.to] && c.arrival == entry.arrival) break;
+            arrivalFrom(profiles[c.to], c.arrival + getMinConnectionTime(c.to), i);
+        }
+        journeys.push_back(journey);
+    }
+    std::reverse(journeys.begin(), journeys.end());
+    return journeys;
+}
+
+/**
+ * @brief Parses a time of the timetable: minutes as a number, or "HH:MM" with hours past 24 for later
+ *        days, optionally followed by "+D" to add D days.
+ * @param text The time.
+ * @return The time in minutes from the start of the timetable, or -1 if it is not valid or later than MaxTime.
+ * @note Time complexity: O(L) where L is the length of the text.
+ */
+int Timetable::parseTime(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r");
+    size_t end = text.find_last_not_of(" \t\r");
+    if (begin == std::string::npos) return -1;
+    std::string time = text.substr(begin, end - begin + 1);
+
+    long days = 0;
+    size_t plus = time.find('+');
+    if (plus != std::string::npos) {
+        char* rest;
+        errno = 0;
+        days = std::strtol(time.c_str() + plus + 1, &rest, 10);
+        if (*rest != '\0' || plus + 1 == time.size() || errno == ERANGE || days < 0 || days > MaxTime / MinutesPerDay) return -1;
+        time = time.substr(0, plus);
+    }
+    char* rest;
+    errno = 0;
+    long value = std::strtol(time.c_str(), &rest, 10);
+    if (rest == time.c_str() || errno == ERANGE || value < 0 || value > MaxTime) return -1;
+    if (*rest == ':') {
+        const char* minutesText = rest + 1;
+        long minutes = std::strtol(minutesText, &rest, 10);
+        if (rest != minutesText + 2 || minutes < 0 || minutes >= 60 || value > MaxTime / 60) return -1;
+        value = value * 60 + minutes;
+    }
+    if (*rest != '\0') return -1;
+    value += days * MinutesPerDay;
+    return value > MaxTime ? -1 : (int) value;
+}
+
+/**
+ * @brief Formats a time of the timetable as "HH:MM", followed by "+D" on the D-th day after the first.
+ * @param minutes The time, in minutes from the start of the timetable.
+ * @return The formatted time.
+ */
+std::string Timetable::formatTime(int minutes) {
+    int days = minutes / MinutesPerDay, time = minutes % MinutesPerDay;
+    std::string text = std::string(1, (char) ('0' + time / 600)) + (char) ('0' + time / 60 % 10) + ':'
+                       + (char) ('0' + time % 60 / 10) + (char) ('0' + time % 10);
+    return days > 0 ? text + "+" + std::to_string(days) : text;
+}
+
+Timetable::Leg Timetable::toLeg(int connection) const {
+    const Connection& c = connections[connection];
+    return {vertices[c.from], vertices[c.to], airlines.get(c.airline), c.departure, c.arrival};
+}
+
+/**
+ * @brief Reads an airport's profile: the earliest arrival at the destination when boarding there at a given time or later.
+ * @param profile The airport's profile.
+ * @param time Earliest boarding time.
+ * @param connection Set to the connection to board, or -1.
+ * @return The arrival time, or Never.
+ * @note Time complexity: O(log P) where P is the size of the profile.
+ */
+int Timetable::arrivalFrom(const std::vector<ProfileEntry>& profile, int time, int& connection) {
+    // The entries departing at time or later are a prefix; the last of them arrives earliest
+    auto end = std::partition_point(profile.begin(), profile.end(), [time](const ProfileEntry& entry) {
+        return entry.departure >= time;
+    });
+    if (end == profile.begin()) {
+        connection = -1;
+        return Never;
+    }
+    connection = (end - 1)->connection;
+    return (end - 1)->arrival;
+}
@@ -0,0 +1,91 @@
+#ifndef TIMETABLE_H
+#define TIMETABLE_H
+
+#include "Graph.h"
+#include "Airport.h"
+#include "Dictionary.h"
+#include <limits>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Scheduled departures of the flights, answering earliest-arrival and profile queries with
+ *        the Connection Scan Algorithm.
+ *
+ * Every departure is a connection (from, to, airline, departure, arrival), with times in minutes
+ * from the start of the timetable, and all of them are kept in one array sorted by departure.
+ * An earliest-arrival query scans that array once, forwards from the departure time, keeping the
+ * earliest time a passenger can board at every airport: the arrival there plus the airport's
+ * minimum connection time (none at the origin). A profile query scans it backwards and keeps, for
+ * every airport, the Pareto front of departure and arrival times at the destination, so a single
+ * scan answers every departure of a time window.
+ *
+ * Airports are vertex ids of the graph the timetable was built for.
+ */
+class Timetable {
+public:
+    struct Leg {
+        const Vertex<Airport>* from;
+        const Vertex<Airport>* to;
+        std::string airline;
+        int departure;
+        int arrival;
+    };
+
+    // A trip from an origin to a destination; no legs if there is none
+    struct Journey {
+        int departure;
+        int arrival;
+        std::vector<Leg> legs;
+    };
+
+    static const int DefaultMinConnectionTime = 30;
+    static const int MaxTime = std::numeric_limits<int>::max() / 2;  // latest valid time, so two still add up to an int
+
+    Timetable() = default;
+    explicit Timetable(const Graph<Airport>& graph);
+
+    bool addConnection(const std::string& source, const std::string& target, const std::string& airline, int departure, int arrival);
+    bool setMinConnectionTime(const std::string& airport, int minutes);
+    void setDefaultMinConnectionTime(int minutes);
+    void build();
+
+    size_t size() const;
+    bool empty() const;
+    int getMinConnectionTime(int airport) const;
+    size_t getBytes() const;
+
+    Journey earliestArrival(const std::vector<int>& sources, const std::vector<int>& targets, int departAfter) const;
+    std::vector<Journey> profile(const std::vector<int>& sources, const std::vector<int>& targets, int from, int until) const;
+
+    static int parseTime(const std::string& text);
+    static std::string formatTime(int minutes);
+
+private:
+    struct Connection {
+        int departure;
+        int arrival;
+        int from;
+        int to;
+        int airline;
+    };
+
+    // One entry of an airport's profile: boarding connection at departure reaches the destination at arrival
+    struct ProfileEntry {
+        int departure;
+        int arrival;
+        int connection;
+    };
+
+    const Graph<Airport>* graph = nullptr;
+    std::vector<const Vertex<Airport>*> vertices;  // id -> vertex
+    std::vector<Connection> connections;           // sorted by departure once built
+    Dictionary airlines;
+    std::vector<int> minConnection;                // vertex id -> minutes, or -1 for the default
+    int defaultMinConnection = DefaultMinConnectionTime;
+
+    Leg toLeg(int connection) const;
+    static int arrivalFrom(const std::vector<ProfileEntry>& profile, int time, int& connection);
+};
+
+#endif // TIMETABLE_H
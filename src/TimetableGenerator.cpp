@@ -0,0 +1,119 @@
+#include "TimetableGenerator.h"
+#include "DatasetGenerator.h"
+#include "Haversine.h"
+#include "Timetable.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+const int MinutesPerDay = 24 * 60;
+const int FirstDeparture = 6 * 60;
+const int LastDeparture = 22 * 60;
+
+}
+
+/**
+ * @brief Constructor.
+ * @param days Number of days to schedule; at least one.
+ * @param seed Seed of the generator; the same graph, days and seed always give the same timetable.
+ */
+TimetableGenerator::TimetableGenerator(int days, uint64_t seed) : days(std::max(1, days)), seed(seed) {}
+
+/**
+ * @brief Fills a timetable with the scheduled departures and minimum connection times, and builds it.
+ * @param graph The graph whose flights are scheduled; the timetable must have been built for it.
+ * @param timetable The timetable the departures are added to.
+ * @return The number of departures added.
+ * @note Time complexity: O(D * F + C log C) where D is the number of days, F the number of flights and
+ *       C the number of departures.
+ */
+long TimetableGenerator::generate(const Graph<Airport>& graph, Timetable& timetable) const {
+    long added = schedule(graph, [&](const std::string& source, const std::string& target, const std::string& airline, int departure, int arrival) {
+        timetable.addConnection(source, target, airline, departure, arrival);
+    });
+    for (const auto* vertex : graph.getVertexSet()) {
+        timetable.setMinConnectionTime(vertex->getInfo().getCode(), minConnectionTime(vertex));
+    }
+    timetable.build();
+    return added;
+}
+
+/**
+ * @brief Writes timetable.csv and min_connection.csv in the format Read consumes.
+ * @param graph The graph whose flights are scheduled.
+ * @param directory Existing directory the files are written to.
+ * @return False if a file could not be written.
+ * @note Time complexity: O(D * F) where D is the number of days and F the number of flights.
+ */
+bool TimetableGenerator::write(const Graph<Airport>& graph, const std::string& directory) {
+    std::ofstream timetableFile(directory + "/timetable.csv");
+    std::ofstream minConnectionFile(directory + "/min_connection.csv");
+    if (!timetableFile || !minConnectionFile) return false;
+
+    timetableFile << "Source,Target,Airline,Departure,Arrival\n";
+    numDepartures = schedule(graph, [&](const std::string& source, const std::string& target, const std::string& airline, int departure, int arrival) {
+        timetableFile << source << ',' << target << ',' << airline << ','
+                      << Timetable::formatTime(departure) << ',' << Timetable::formatTime(arrival) << '\n';
+    });
+
+    minConnectionFile << "Airport,Minutes\n";
+    for (const auto* vertex : graph.getVertexSet()) {
+        minConnectionFile << vertex->getInfo().getCode() << ',' << minConnectionTime(vertex) << '\n';
+    }
+    return (bool) timetableFile && (bool) minConnectionFile;
+}
+
+long TimetableGenerator::getNumDepartures() const {
+    return numDepartures;
+}
+
+/**
+ * @brief Draws the departures of every flight and hands each one to a visitor.
+ * @param graph The graph whose flights are scheduled.
+ * @param visit Called with the source, target and airline codes, the departure and the arrival.
+ * @return The number of departures.
+ */
+template <class Visit>
+long TimetableGenerator::schedule(const Graph<Airport>& graph, Visit visit) const {
+    DatasetGenerator::Random random(seed);
+    long count = 0;
+    std::vector<std::string> airlines;
+    for (const auto* vertex : graph.getVertexSet()) {
+        const Airport& from = vertex->getInfo();
+        std::string source = from.getCode();
+        for (const auto& edge : vertex->getAdj()) {
+            const Airport& to = edge.getDest()->getInfo();
+            std::string target = to.getCode();
+            double km = Haversine::haversineDistance(from.getLatitude(), from.getLongitude(), to.getLatitude(), to.getLongitude());
+            int duration = 5 * (int) std::lround((25 + km / 800 * 60) / 5);
+
+            // The flight set is unordered, so airlines are sorted to keep the draws reproducible
+            airlines.clear();
+            for (const auto& flight : edge.getFlights()) airlines.push_back(flight.getAirline());
+            std::sort(airlines.begin(), airlines.end());
+            for (const auto& airline : airlines) {
+                for (int day = 0; day < days; day++) {
+                    int perDay = 1 + (int) random.below(4);
+                    for (int i = 0; i < perDay; i++) {
+                        int departure = day * MinutesPerDay + FirstDeparture
+                                        + 5 * (int) random.below((LastDeparture - FirstDeparture) / 5 + 1);
+                        visit(source, target, airline, departure, departure + duration);
+                        count++;
+                    }
+                }
+            }
+        }
+    }
+    return count;
+}
+
+// Busier airports need longer to change planes
+int TimetableGenerator::minConnectionTime(const Vertex<Airport>* vertex) {
+    long flights = vertex->getOutFlights() + vertex->getInFlights();
+    if (flights >= 200) return 60;
+    if (flights >= 50) return 45;
+    return 30;
+}
@@ -1,11 +1,16 @@
 #include "UserInterface.h"
 
-UserInterface::UserInterface() {
+UserInterface::UserInterface(const std::string& datasetPath) {
     Read reader;
-    std::string datasetPath = "../dataset/";
     reader.readAirports(airportGraph, datasetPath + "airports.csv");
     reader.readAirlines(airlines, datasetPath + "airlines.csv");
     reader.readFlights(airportGraph, datasetPath + "flights.csv");
+    engine.reset(new QueryEngine(airportGraph, airlines));
+    if (reader.readTimetable(engine->getTimetable(), datasetPath + "timetable.csv")) {
+        reader.readMinConnectionTimes(engine->getTimetable(), datasetPath + "min_connection.csv");
+    }
+    engine->loadHierarchy(datasetPath + "hierarchy.ch");
+    engine->buildRouteIndexes();
 }
 
 //UTILITY
@@ -57,6 +62,15 @@ void UserInterface::handleMainMenu(bool& running) {
                     handleStatistics();
                     break;
                 case 4:
+                    handleNameLookup();
+                    break;
+                case 5:
+                    handleTimetableSearch();
+                    break;
+                case 6:
+                    handleShortestRoute();
+                    break;
+                case 7:
                     std::cout << "Exiting...\n";
                     running = false;
                     return;
@@ -96,8 +110,8 @@ void UserInterface::handleFilteredFlightSearch() {
     std::string minimizeInput = getUserInput("Minimize airline changes? (y/n): ");
     minimizeAirlineChanges = (minimizeInput == "y" || minimizeInput == "Y");
 
-    // Create a Search object
-    Search search(airportGraph); // Assuming airportGraph is accessible in UserInterface
+    // Create a Search view over the query engine
+    Search search(*engine);
 
     // Find the best flight with filters
     auto bestFlights = search.findBestFlight(source, destination, preferredAirlines, minimizeAirlineChanges);
@@ -123,8 +137,8 @@ void UserInterface::handleFlightSearch() {
     std::string source = getUserInput("Enter source (airport code, city name, or coordinates('latitude,longitude')): ");
     std::string destination = getUserInput("Enter destination (airport code, city name, or coordinates('latitude,longitude')): ");
 
-    // Create a Search object
-    Search search(airportGraph); // Assuming airportGraph is accessible in UserInterface
+    // Create a Search view over the query engine
+    Search search(*engine);
 
     // Find the best flight
     auto bestFlights = search.findBestFlight(source, destination);
@@ -141,14 +155,86 @@ void UserInterface::handleFlightSearch() {
 
 }
 
+void UserInterface::handleNameLookup() {
+    clear();
+    std::string text = getUserInput("Enter the start of a name or code (typos are tolerated): ");
+
+    Search search(*engine);
+    auto suggestions = search.suggest(text, 10);
+    if (suggestions.empty()) {
+        std::cout << "Nothing is named like " << text << std::endl;
+        return;
+    }
+    for (const auto& suggestion : suggestions) {
+        std::cout << Autocomplete::getName(suggestion.kind) << ": " << suggestion.name;
+        if (!suggestion.code.empty()) std::cout << " (" << suggestion.code << ")";
+        std::cout << ", " << suggestion.weight << " flights" << std::endl;
+    }
+}
+
+void UserInterface::handleShortestRoute() {
+    clear();
+    std::string source = getUserInput("Enter source (airport code, city name, or coordinates('latitude,longitude')): ");
+    std::string destination = getUserInput("Enter destination (airport code, city name, or coordinates('latitude,longitude')): ");
+
+    Search search(*engine);
+    auto route = search.findShortestRoute(source, destination);
+    if (route.path.empty()) {
+        std::cout << "No route found from " << source << " to " << destination << std::endl;
+        return;
+    }
+    std::cout << "Shortest route from " << source << " to " << destination << " (" << std::lround(route.distance) << " km):" << std::endl;
+    for (const auto* vertex : route.path) {
+        std::cout << vertex->getInfo().getName() << " (" << vertex->getInfo().getCode() << ") -> ";
+    }
+    std::cout << "End" << std::endl;
+}
+
+void UserInterface::handleTimetableSearch() {
+    clear();
+    if (engine->getTimetable().empty()) {
+        std::cout << "No timetable loaded (timetable.csv in the dataset directory, see flight_gen --timetable)." << std::endl;
+        return;
+    }
+    std::string source = getUserInput("Enter source (airport code, city name, or coordinates('latitude,longitude')): ");
+    std::string destination = getUserInput("Enter destination (airport code, city name, or coordinates('latitude,longitude')): ");
+    int from = Timetable::parseTime(getUserInput("Depart from (HH:MM, +D for a later day, e.g. 08:00+1): "));
+    std::string untilInput = getUserInput("Depart until (leave empty for the earliest arrival only): ");
+    int until = untilInput.empty() ? from : Timetable::parseTime(untilInput);
+    if (from < 0 || until < from) {
+        std::cout << "Invalid departure times." << std::endl;
+        return;
+    }
+
+    Search search(*engine);
+    std::vector<Timetable::Journey> journeys;
+    if (untilInput.empty()) {
+        Timetable::Journey journey = search.findEarliestArrival(source, destination, from);
+        if (!journey.legs.empty()) journeys.push_back(journey);
+    } else {
+        journeys = search.findJourneys(source, destination, from, until);
+    }
+    if (journeys.empty()) {
+        std::cout << "No journeys found from " << source << " to " << destination << std::endl;
+        return;
+    }
+    for (const auto& journey : journeys) {
+        std::cout << "Depart " << Timetable::formatTime(journey.departure) << ", arrive " << Timetable::formatTime(journey.arrival)
+                  << " (" << journey.arrival - journey.departure << " min):" << std::endl;
+        for (const auto& leg : journey.legs) {
+            std::cout << "  " << Timetable::formatTime(leg.departure) << " " << leg.from->getInfo().getCode() << " -> "
+                      << leg.to->getInfo().getCode() << " " << Timetable::formatTime(leg.arrival) << " (" << leg.airline << ")" << std::endl;
+        }
+    }
+}
+
 void UserInterface::handleStatistics() {
 
     int choice;
     bool done = false;
     std::string input;
     int maxStops, k;
-    Statistics statistics(airportGraph, airlines);
-    auto longestPath = statistics.findLongestPath();
+    Statistics statistics(*engine);
     while (!done) {
         clear();
         displayStatisticsOptions();
@@ -246,7 +332,11 @@ void UserInterface::handleStatistics() {
                 break;
             }
             case 13: {
-                for (const auto& path : longestPath) {
+                if (longestPathsStale) {
+                    longestPaths = statistics.findLongestPath();
+                    longestPathsStale = false;
+                }
+                for (const auto& path : longestPaths) {
                     for (const auto& airport : path) {
                         std::cout << airport.getCode() << " -> ";
                     }
@@ -272,10 +362,260 @@ void UserInterface::handleStatistics() {
                 std::cout << "Number of essential airports: " << essentialAirports.size() << std::endl;
                 break;
             }
-            case 16:
-                done = true;
+            case 16: {
+                auto sizes = statistics.getComponentSizes();
+                std::cout << "Number of strongly connected components: " << sizes.size() << std::endl;
+                if (!sizes.empty()) {
+                    std::cout << "Largest component: " << sizes.front() << " airports" << std::endl;
+                }
+                for (const auto& pair : statistics.getComponentSizeDistribution()) {
+                    std::cout << "Size: " << pair.first << ", Components: " << pair.second << std::endl;
+                }
                 break;
+            }
             case 17:
+                std::cout << "Number of flights per country/airline:" << std::endl;
+                for (const auto& pair : statistics.getNumberOfFlightsPerCountryAirline()) {
+                    std::cout << "Country: " << pair.first.first << ", Airline: " << pair.first.second << ", Flights: " << pair.second << std::endl;
+                }
+                break;
+            case 18: {
+                double bucketKm;
+                std::cout << "Enter the distance bucket width (km): ";
+                std::cin >> bucketKm;
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                if (!(bucketKm >= Statistics::MinBucketKm) || !std::isfinite(bucketKm)) {
+                    std::cout << "The bucket width must be at least " << Statistics::MinBucketKm << " km." << std::endl;
+                    break;
+                }
+                for (const auto& pair : statistics.getNumberOfFlightsPerDistance(bucketKm)) {
+                    std::cout << "From " << pair.first << " km, Flights: " << pair.second << std::endl;
+                }
+                break;
+            }
+            case 19: {
+                int threads = 0;
+                std::cout << "Enter the maximum number of threads (0 for all hardware threads): ";
+                std::cin >> threads;
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                if (threads < 1) threads = Parallel::defaultThreads();
+
+                auto report = statistics.computeAll(threads);
+                const FlightTable& table = statistics.getFlightTable();
+                std::cout << "Total flights: " << report.totalFlights << std::endl;
+                std::cout << "Cities: " << report.flightsPerCity.size() << ", Airlines: " << report.flightsPerAirline.size()
+                          << ", Countries: " << report.flightsPerCountry.size() << ", Airports: " << report.flightsFromAirport.size() << std::endl;
+                std::cout << "City/airline pairs: " << report.flightsPerCityAirline.size()
+                          << ", Country/airline pairs: " << report.flightsPerCountryAirline.size() << std::endl;
+                auto busiest = std::max_element(report.flightsPerCountry.begin(), report.flightsPerCountry.end());
+                if (busiest != report.flightsPerCountry.end()) {
+                    std::cout << "Busiest country: " << table.countries.get(busiest - report.flightsPerCountry.begin())
+                              << ", Flights: " << *busiest << std::endl;
+                }
+
+                std::cout << "Threads | Compute all (ms) | Individual reports (ms) | Speedup" << std::endl;
+                for (const auto& timing : statistics.benchmarkComputeAll(threads)) {
+                    std::cout << timing.threads << " | " << timing.fusedMs << " | " << timing.individualMs
+                              << " | " << timing.individualMs / timing.fusedMs << "x" << std::endl;
+                }
+                break;
+            }
+            case 20: {
+                std::cout << "Enter country name: ";
+                getline(std::cin, input);
+                auto countries = statistics.getCountriesReachableFromCountry(input);
+                for (const auto& country : countries) {
+                    std::cout << country << std::endl;
+                }
+                std::cout << "Number of countries with direct flights from " << input << ": " << countries.size() << std::endl;
+                break;
+            }
+            case 21: {
+                int metric;
+                std::cout << "Rank by: 1. Outgoing flights, 2. Incoming flights, 3. Distinct routes, "
+                             "4. Distinct airlines, 5. Airports reachable within X stops: ";
+                std::cin >> metric;
+                if (metric < 1 || metric > 5) {
+                    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                    std::cout << "Invalid metric." << std::endl;
+                    break;
+                }
+                maxStops = 1;
+                if (metric == 5) {
+                    std::cout << "Enter maximum number of stops: ";
+                    std::cin >> maxStops;
+                }
+                std::cout << "Enter the number K: ";
+                std::cin >> k;
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                auto rankingMetric = (RankingMetric) (metric - 1);
+                for (const auto& pair : statistics.getTopKAirports(rankingMetric, k, maxStops)) {
+                    std::cout << "Airport: " << pair.first.getCode() << ", " << Ranking::getName(rankingMetric)
+                              << ": " << pair.second << std::endl;
+                }
+                break;
+            }
+            case 22: {
+                int samples;
+                std::cout << "Enter maximum number of stops: ";
+                std::cin >> maxStops;
+                std::cout << "Enter the number of airports to check against exact searches: ";
+                std::cin >> samples;
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                if (maxStops < 0) {
+                    std::cout << "The number of stops cannot be negative." << std::endl;
+                    break;
+                }
+                auto accuracy = statistics.compareReachEstimates(maxStops, samples);
+                const char* kinds[] = {"Airports", "Cities", "Countries"};
+                std::cout << "Estimates for every airport: " << accuracy.sketchMs << " ms" << std::endl;
+                std::cout << "Exact searches for " << accuracy.samples << " airports: " << accuracy.exactMs
+                          << " ms (about " << accuracy.exactAllMs << " ms for every airport)" << std::endl;
+                for (int kind = 0; kind < 3; kind++) {
+                    std::cout << kinds[kind] << ": mean error " << accuracy.meanError[kind] * 100
+                              << "%, max error " << accuracy.maxError[kind] * 100 << "%" << std::endl;
+                }
+                break;
+            }
+            case 23: {
+                int pivots;
+                std::cout << "Enter the number K: ";
+                std::cin >> k;
+                std::cout << "Enter the number of sampled airports (0 for the exact result): ";
+                std::cin >> pivots;
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                for (const auto& pair : statistics.getTopKAirportsByBetweenness(k, pivots)) {
+                    std::cout << "Airport: " << pair.first.getCode() << ", Betweenness: " << pair.second << std::endl;
+                }
+                break;
+            }
+            case 24:
+                std::cout << "Enter the number K: ";
+                std::cin >> k;
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                for (const auto& pair : statistics.getTopKAirportsByPageRank(k)) {
+                    std::cout << "Airport: " << pair.first.getCode() << ", PageRank: " << pair.second << std::endl;
+                }
+                break;
+            case 25:
+                std::cout << "Enter airport code: ";
+                getline(std::cin, input);
+                std::cout << "Enter the number K: ";
+                std::cin >> k;
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                for (const auto& pair : statistics.getRelatedDestinations(input, k)) {
+                    std::cout << "Airport: " << pair.first.getName() << " (" << pair.first.getCode() << "), Score: " << pair.second << std::endl;
+                }
+                break;
+            case 26:
+                if (!Instrumentation::isEnabled()) {
+                    std::cout << "Instrumentation is compiled out (configure with -DFLIGHT_INSTRUMENTATION=ON)." << std::endl;
+                    break;
+                }
+                for (const auto& operation : Instrumentation::operations()) {
+                    if (operation.count == 0) continue;
+                    std::cout << operation.name << ": " << operation.count << " calls, total " << operation.totalMs
+                              << " ms, mean " << operation.meanUs << " us, p50 < " << operation.p50Us
+                              << " us, p99 < " << operation.p99Us << " us" << std::endl;
+                }
+                for (int c = 0; c < (int) Instrumentation::Counter::Count; c++) {
+                    auto counter = (Instrumentation::Counter) c;
+                    std::cout << Instrumentation::getName(counter) << ": " << Instrumentation::total(counter) << std::endl;
+                }
+                break;
+            case 27: {
+                std::cout << "Enter delta file path: ";
+                getline(std::cin, input);
+                std::vector<FlightChange> changes;
+                if (!Read().readFlightDelta(changes, input)) {
+                    std::cout << "Cannot open " << input << std::endl;
+                    break;
+                }
+                auto start = std::chrono::steady_clock::now();
+                auto result = FlightDelta::apply(airportGraph, changes, engine.get());
+                double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                std::cout << "Added " << result.added << " and removed " << result.removed << " flights ("
+                          << result.routesAdded << " new routes, " << result.routesRemoved << " routes gone), ignored "
+                          << result.ignored << " changes in " << elapsedMs << " ms" << std::endl;
+                if (result.condensationRebuilt) std::cout << "The connected components were recomputed." << std::endl;
+                longestPathsStale = true;
+                break;
+            }
+            case 28: {
+                std::cout << "Enter airport code: ";
+                getline(std::cin, input);
+                auto origins = statistics.getAirportsWithFlightsTo(input);
+                for (const auto& origin : origins) {
+                    std::cout << origin << std::endl;
+                }
+                std::cout << "Number of airports with flights to " << input << ": " << origins.size() << std::endl;
+                std::cout << "Flights: " << statistics.getNumberOfFlightsToAirport(input)
+                          << ", airlines: " << statistics.getNumberOfUniqueAirlinesToAirport(input)
+                          << ", origin countries: " << statistics.getNumberOfDiffCountriesToAirport(input) << std::endl;
+                break;
+            }
+            case 29: {
+                std::cout << "Enter airport code: ";
+                getline(std::cin, input);
+                std::cout << "Enter maximum number of stops: ";
+                std::cin >> maxStops;
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                auto originAirports = statistics.getAirportsReaching(input, maxStops);
+                for (const auto& airport : originAirports) {
+                    std::cout << airport << std::endl;
+                }
+                std::cout << "Number of airports " << input << " is reachable from: " << originAirports.size() << std::endl;
+                break;
+            }
+            case 30: {
+                std::cout << "Enter airport code: ";
+                getline(std::cin, input);
+                std::cout << "Enter maximum number of stops: ";
+                std::cin >> maxStops;
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                auto originCities = statistics.getCitiesReaching(input, maxStops);
+                for (const auto& city : originCities) {
+                    std::cout << city << std::endl;
+                }
+                std::cout << "Number of cities " << input << " is reachable from: " << originCities.size() << std::endl;
+                break;
+            }
+            case 31: {
+                std::cout << "Enter airport code: ";
+                getline(std::cin, input);
+                std::cout << "Enter maximum number of stops: ";
+                std::cin >> maxStops;
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                auto originCountries = statistics.getCountriesReaching(input, maxStops);
+                for (const auto& country : originCountries) {
+                    std::cout << country << std::endl;
+                }
+                std::cout << "Number of countries " << input << " is reachable from: " << originCountries.size() << std::endl;
+                break;
+            }
+            case 32: {
+                MemoryReport report = statistics.getMemoryReport();
+                size_t cached = longestPaths.capacity() * sizeof(std::vector<Airport>);
+                for (const auto& path : longestPaths) cached += MemoryReport::bytesOf(path);
+                report.add("ui.longest_paths", cached, longestPaths.size());
+                for (const auto& component : report.getComponents()) {
+                    std::cout << component.name << ": " << component.bytes << " bytes, " << component.items << " items"
+                              << (component.counted ? "" : " (estimated)") << std::endl;
+                }
+                std::cout << "Total: " << report.getTotalBytes() / (1024.0 * 1024.0) << " MiB" << std::endl;
+                std::cout << "Write the report as JSON to (empty to skip): ";
+                getline(std::cin, input);
+                if (!input.empty()) {
+                    std::ofstream file(input);
+                    if (file << report.toJson() << std::endl) std::cout << "Written to " << input << std::endl;
+                    else std::cout << "Cannot write " << input << std::endl;
+                }
+                break;
+            }
+            case 33:
+                done = true;
+                break;
+            case 34:
                 exit(0);
                 break;
             default:
@@ -294,7 +634,10 @@ void UserInterface::displayMainMenu() {
     std::cout << "1. Search for Flights" << std::endl;
     std::cout << "2. Search For Flights with Filters" << std::endl;
     std::cout << "3. View Statistics" << std::endl;
-    std::cout << "4. Quit" << std::endl;
+    std::cout << "4. Find Airports, Cities, Countries and Airlines by Name" << std::endl;
+    std::cout << "5. Search Flights by Timetable" << std::endl;
+    std::cout << "6. Search Shortest Route by Distance" << std::endl;
+    std::cout << "7. Quit" << std::endl;
 }
 
 void UserInterface::displayStatisticsOptions() {
@@ -314,8 +657,25 @@ void UserInterface::displayStatisticsOptions() {
     std::cout << "13. Find the longest flight path" << std::endl;
     std::cout << "14. Top K airports with the most flights" << std::endl;
     std::cout << "15. Find essential airports for network circulation" << std::endl;
-    std::cout << "16. Return" << std::endl;
-    std::cout << "17. Quit" << std::endl;
+    std::cout << "16. Strongly connected component sizes" << std::endl;
+    std::cout << "17. Number of flights per country/airline" << std::endl;
+    std::cout << "18. Number of flights per route distance" << std::endl;
+    std::cout << "19. Compute all flight counts at once (parallel)" << std::endl;
+    std::cout << "20. Countries with direct flights from a specific country" << std::endl;
+    std::cout << "21. Top K airports by a ranking metric" << std::endl;
+    std::cout << "22. Estimated reach of every airport within X stops (vs. exact)" << std::endl;
+    std::cout << "23. Top K hub airports by betweenness centrality" << std::endl;
+    std::cout << "24. Top K airports by PageRank" << std::endl;
+    std::cout << "25. Related destinations of a specific airport" << std::endl;
+    std::cout << "26. Instrumentation report (operation latencies and counters)" << std::endl;
+    std::cout << "27. Apply a flight delta file (flights added and removed)" << std::endl;
+    std::cout << "28. Airports with direct flights to a specific airport" << std::endl;
+    std::cout << "29. Airports a specific airport is reachable from within X stops" << std::endl;
+    std::cout << "30. Cities a specific airport is reachable from within X stops" << std::endl;
+    std::cout << "31. Countries a specific airport is reachable from within X stops" << std::endl;
+    std::cout << "32. Memory report (bytes held by the graph and every index)" << std::endl;
+    std::cout << "33. Return" << std::endl;
+    std::cout << "34. Quit" << std::endl;
 }
 
 
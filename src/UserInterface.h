@@ -4,28 +4,42 @@
 #include "Graph.h"
 #include "Search.h"
 #include "Statistics.h"
+#include "QueryEngine.h"
+#include "Parallel.h"
+#include "FlightDelta.h"
+#include "Instrumentation.h"
+#include "MemoryReport.h"
 #include "Airport.h"
 #include "Airline.h"
 #include "Flight.h"
+#include <chrono>
+#include <fstream>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <string>
 #include "Read.h"
 
 class UserInterface {
 public:
-    UserInterface( );
+    explicit UserInterface(const std::string& datasetPath = "../dataset/");
     void run();
 
 private:
     Graph<Airport> airportGraph;
     std::unordered_set<Airline> airlines;
+    std::unique_ptr<QueryEngine> engine;
+    std::vector<std::vector<Airport>> longestPaths;  // computed by the first longest path query
+    bool longestPathsStale = true;
 
     //HANDLE FUNCTIONS
     void handleStatistics();
     void handleMainMenu(bool& running);
     void handleFilteredFlightSearch();
     void handleFlightSearch();
+    void handleNameLookup();
+    void handleTimetableSearch();
+    void handleShortestRoute();
     //DISPLAY FUNCTIONS
     void displayMainMenu();
     void displayStatisticsOptions();
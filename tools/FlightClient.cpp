@@ -0,0 +1,99 @@
+#include "Client.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Sends JSON queries (one per line on stdin, or --query) to a running Project_2_AED --serve/--port
+ * server and prints the answers. With --connections and --repeat it doubles as a load generator and
+ * reports round-trip latency percentiles on stderr.
+ *
+ * Usage: flight_client (--socket PATH | --port N) [--query JSON] [--connections N] [--repeat N] [--quiet]
+ */
+int main(int argc, char* argv[]) {
+    std::string socketPath;
+    int port = 0, connections = 1, repeat = 1;
+    bool quiet = false;
+    std::vector<std::string> queries;
+    for (int i = 1; i < argc; i++) {
+        std::string flag = argv[i];
+        if (flag == "--quiet") {
+            quiet = true;
+        } else if (i + 1 < argc && flag == "--socket") {
+            socketPath = argv[++i];
+        } else if (i + 1 < argc && flag == "--port") {
+            port = std::atoi(argv[++i]);
+        } else if (i + 1 < argc && flag == "--query") {
+            queries.push_back(argv[++i]);
+        } else if (i + 1 < argc && flag == "--connections") {
+            connections = std::max(1, std::atoi(argv[++i]));
+        } else if (i + 1 < argc && flag == "--repeat") {
+            repeat = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Unknown option " << flag << std::endl;
+            return 2;
+        }
+    }
+    if (socketPath.empty() && port == 0) {
+        std::cerr << "Give the server's --socket PATH or --port N" << std::endl;
+        return 2;
+    }
+    if (queries.empty()) {
+        std::string line;
+        while (getline(std::cin, line)) {
+            if (line.find_first_not_of(" \t\r") != std::string::npos) queries.push_back(line);
+        }
+    }
+
+    // Every connection sends every query `repeat` times, in order
+    std::mutex outputLock;
+    std::vector<std::vector<double>> latencies(connections);
+    std::atomic<long> failures(0);
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int c = 0; c < connections; c++) {
+        threads.emplace_back([&, c]() {
+            Client client;
+            if (socketPath.empty() ? !client.connectTcp(port) : !client.connectUnix(socketPath)) {
+                failures += (long) queries.size() * repeat;
+                return;
+            }
+            std::string answer;
+            for (int r = 0; r < repeat; r++) {
+                for (const auto& query : queries) {
+                    auto sent = std::chrono::steady_clock::now();
+                    if (!client.request(query, answer)) {
+                        failures++;
+                        return;
+                    }
+                    latencies[c].push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - sent).count());
+                    if (answer.find("\"ok\":false") != std::string::npos) failures++;
+                    if (!quiet) {
+                        std::lock_guard<std::mutex> lock(outputLock);
+                        std::cout << answer << '\n';
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout.flush();
+
+    std::vector<double> all;
+    for (const auto& connection : latencies) all.insert(all.end(), connection.begin(), connection.end());
+    std::sort(all.begin(), all.end());
+    if (!all.empty()) {
+        std::cerr << all.size() << " requests over " << connections << " connections in " << seconds << " s ("
+                  << all.size() / seconds << " requests/s), round trip p50 " << all[all.size() / 2] << " us, p99 "
+                  << all[std::min(all.size() - 1, (size_t) (all.size() * 0.99))] << " us, " << failures.load()
+                  << " failed" << std::endl;
+    }
+    return failures.load() == 0 ? 0 : 1;
+}
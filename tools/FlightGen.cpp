@@ -0,0 +1,109 @@
+#include "DatasetGenerator.h"
+#include "TimetableGenerator.h"
+#include "ContractionHierarchy.h"
+#include "Read.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+/*
+ * Writes a synthetic dataset in the format Read consumes.
+ *
+ * Usage: flight_gen [--scale FACTOR] [--seed N] [--output DIR] [--timetable DAYS] [--hierarchy FILE] [--from DIR]
+ *   e.g. flight_gen --scale 100 --output dataset_100x && flight_bench --dataset dataset_100x
+ *
+ * --timetable also schedules the flights over DAYS days (timetable.csv and min_connection.csv);
+ * --hierarchy preprocesses the dataset's contraction hierarchy and writes it to FILE, which the
+ * application reads as hierarchy.ch from the dataset directory. With --from, no dataset is
+ * generated: these files are written for the dataset already in that directory.
+ *   e.g. flight_gen --timetable 7 --hierarchy ../dataset/hierarchy.ch --from ../dataset --output ../dataset
+ */
+static void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [--scale FACTOR] [--seed N] [--output DIR] [--timetable DAYS] [--hierarchy FILE] [--from DIR]\n"
+              << "Writes a synthetic dataset, FACTOR times the size of the bundled one (default 10), to DIR (default .).\n"
+              << "  --timetable DAYS   also schedules the flights over DAYS days (timetable.csv and min_connection.csv)\n"
+              << "  --hierarchy FILE   also writes the dataset's contraction hierarchy to FILE (read as hierarchy.ch)\n"
+              << "  --from DIR         generates no dataset: writes those files for the dataset already in DIR\n"
+              << "  --seed N           seed of the generator (default 42)" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    double scale = 10;
+    unsigned long long seed = 42;
+    std::string output = ".";
+    int days = 0;
+    std::string from, hierarchyFile;
+    for (int i = 1; i < argc; i += 2) {
+        std::string flag = argv[i];
+        if (flag == "--help" || flag == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (i + 1 == argc) {
+            std::cerr << "Unknown option " << flag << " without a value (see --help)" << std::endl;
+            return 1;
+        }
+        std::string value = argv[i + 1];
+        if (flag == "--scale") scale = std::atof(value.c_str());
+        else if (flag == "--seed") seed = std::strtoull(value.c_str(), nullptr, 10);
+        else if (flag == "--output") output = value;
+        else if (flag == "--timetable") days = std::atoi(value.c_str());
+        else if (flag == "--from") from = value;
+        else if (flag == "--hierarchy") hierarchyFile = value;
+        else {
+            std::cerr << "Unknown option " << flag << " (see --help)" << std::endl;
+            return 1;
+        }
+    }
+    if (scale <= 0) {
+        std::cerr << "The scale factor must be positive" << std::endl;
+        return 1;
+    }
+
+    if (!from.empty() && days <= 0 && hierarchyFile.empty()) {
+        std::cerr << "--from needs --timetable DAYS or --hierarchy FILE" << std::endl;
+        return 1;
+    }
+
+    if (from.empty()) {
+        DatasetGenerator generator(scale, seed);
+        if (!generator.write(output)) {
+            std::cerr << "Could not write to " << output << " (the directory must exist)" << std::endl;
+            return 1;
+        }
+        std::cout << "Wrote " << generator.getNumAirports() << " airports, " << generator.getNumAirlines()
+                  << " airlines and " << generator.getNumFlights() << " flights to " << output << std::endl;
+        from = output;
+    }
+    if (days <= 0 && hierarchyFile.empty()) return 0;
+
+    Graph<Airport> graph;
+    Read reader;
+    reader.readAirports(graph, from + "/airports.csv");
+    reader.readFlights(graph, from + "/flights.csv");
+    if (graph.getNumVertex() == 0) {
+        std::cerr << "No airports in " << from << std::endl;
+        return 1;
+    }
+    if (days > 0) {
+        TimetableGenerator timetable(days, seed);
+        if (!timetable.write(graph, output)) {
+            std::cerr << "Could not write to " << output << " (the directory must exist)" << std::endl;
+            return 1;
+        }
+        std::cout << "Wrote " << timetable.getNumDepartures() << " departures over " << days << " days to " << output << std::endl;
+    }
+    if (!hierarchyFile.empty()) {
+        auto start = std::chrono::steady_clock::now();
+        ContractionHierarchy hierarchy{DenseGraph(graph)};
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!hierarchy.save(hierarchyFile)) {
+            std::cerr << "Could not write " << hierarchyFile << std::endl;
+            return 1;
+        }
+        std::cout << "Wrote a hierarchy of " << hierarchy.getNumArcs() << " arcs (" << hierarchy.getNumShortcuts()
+                  << " shortcuts), contracted in " << seconds << " s, to " << hierarchyFile << std::endl;
+    }
+    return 0;
+}